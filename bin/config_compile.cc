@@ -0,0 +1,28 @@
+//
+// Compile an ljmet python config into a configuration snapshot, which
+// ljmet reads without starting Python
+//
+// usage: ljmet-config-compile <config.py> <snapshot>
+//
+
+#include <iostream>
+
+#include "FWCore/ParameterSet/interface/ProcessDesc.h"
+#include "FWCore/PythonParameterSet/interface/PythonProcessDesc.h"
+#include "LJMet/Com/interface/LjmetConfigSnapshot.h"
+
+
+
+int main (int argc, char* argv[]) {
+  if (argc != 3) {
+    std::cout << "usage: " << argv[0] << " <config.py> <snapshot>" << std::endl;
+    return 1;
+  }
+
+  PythonProcessDesc builder(argv[1]);
+  std::shared_ptr<edm::ParameterSet> parameters = builder.processDesc()->getProcessPSet();
+  if (!LjmetConfigSnapshot::Write(*parameters, argv[1], argv[2])) return 1;
+
+  std::cout << std::endl << "[" << argv[0] << "]: wrote " << argv[2] << std::endl;
+  return 0;
+}
@@ -0,0 +1,24 @@
+//
+// Convert an HCAL laser event list (gzipped text, one run:LS:event per line)
+// to the binary list that HcalLaserEventFilter2012 memory-maps
+//
+// usage: ljmet-hcal-laser-convert <event list> <binary list>
+//
+
+#include <iostream>
+
+#include "LJMet/Com/interface/HcalLaserEventFilter2012Standalone.h"
+
+
+
+int main (int argc, char* argv[]) {
+  if (argc != 3) {
+    std::cout << "usage: " << argv[0] << " <event list> <binary list>" << std::endl;
+    return 1;
+  }
+
+  if (!HcalLaserEventFilter2012::writeBinaryFile(argv[1], argv[2])) return 1;
+
+  std::cout << std::endl << "[" << argv[0] << "]: wrote " << argv[2] << std::endl;
+  return 0;
+}
@@ -0,0 +1,26 @@
+//
+// Compile JEC text files into the binary cache that LjmetJecCache memory-maps
+//
+// usage: ljmet-jec-compile <cache> <text file>[:section] ...
+//
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "LJMet/Com/interface/LjmetJecCache.h"
+
+
+
+int main (int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cout << "usage: " << argv[0] << " <cache> <text file>[:section] ..." << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> txtFiles(argv + 2, argv + argc);
+  if (!LjmetJecCache::Write(argv[1], txtFiles)) return 1;
+
+  std::cout << std::endl << "[" << argv[0] << "]: wrote " << argv[1] << std::endl;
+  return 0;
+}
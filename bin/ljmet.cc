@@ -4,9 +4,13 @@
 // Gena Kukartsev, March 2012
 //
 
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <new>
+#include <string>
 
 #include "TCanvas.h"
 #include "TFile.h"
@@ -18,13 +22,18 @@
 #include "TTree.h"
 #include "TVector3.h"
 
-#include "DataFormats/FWLite/interface/ChainEvent.h"
 #include "FWCore/FWLite/interface/AutoLibraryLoader.h"
 #include "FWCore/ParameterSet/interface/ProcessDesc.h"
 #include "FWCore/PythonParameterSet/interface/PythonProcessDesc.h"
 #include "LJMet/Com/interface/BaseEventSelector.h"
+#include "LJMet/Com/interface/LjmetArena.h"
+#include "LJMet/Com/interface/LjmetCheckpoint.h"
+#include "LJMet/Com/interface/LjmetConfigSnapshot.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
+#include "LJMet/Com/interface/LjmetEventSource.h"
 #include "LJMet/Com/interface/LjmetFactory.h"
+#include "LJMet/Com/interface/LjmetInputTuner.h"
+#include "LJMet/Com/interface/LjmetSelectionCache.h"
 #include "Math/GenVector/Cartesian2D.h"
 #include "PhysicsTools/FWLite/interface/TFileService.h"
 #include "PhysicsTools/SelectorUtils/interface/strbitset.h"
@@ -39,6 +48,24 @@ bool JsonContainsEvent (const std::vector< edm::LuminosityBlockRange > &jsonVec,
 
 
 
+//===============================================================>
+//
+// heap allocations, counted for the allocations per event report
+//
+
+void * operator new (std::size_t size) {
+    LjmetArena::CountHeapAllocation();
+    void * p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete (void * p) noexcept {
+    std::free(p);
+}
+
+
+
 ///////////////////////////
 // ///////////////////// //
 // // Main Subroutine // //
@@ -46,6 +73,9 @@ bool JsonContainsEvent (const std::vector< edm::LuminosityBlockRange > &jsonVec,
 ///////////////////////////
 
 int main (int argc, char* argv[]) {
+    // start of the job, for the startup time in the log
+    std::chrono::steady_clock::time_point const _startTime = std::chrono::steady_clock::now();
+    
     // legend for self ID in messages
     std::string legend = "[";
     legend.append(argv[0]);
@@ -55,10 +85,18 @@ int main (int argc, char* argv[]) {
     // processing the config file
     std::cout << legend << "getting parameters from config file" << std::endl;
     std::cout << legend << "the following parameter sets found:" << std::endl;
-    // Get the python configuration
-    PythonProcessDesc builder(argv[1]);
-    std::shared_ptr<edm::ProcessDesc> b = builder.processDesc();
-    std::shared_ptr<edm::ParameterSet> parameters = b->getProcessPSet();
+    // Get the python configuration, or its snapshot from ljmet-config-compile
+    // with the per-job overrides, without Python
+    std::shared_ptr<edm::ParameterSet> parameters;
+    if (LjmetConfigSnapshot::IsSnapshot(argv[1])) {
+        parameters = LjmetConfigSnapshot::Read(argv[1]);
+        if (argc > 2) LjmetConfigSnapshot::Override(*parameters, argv[2]);
+    }
+    else {
+        PythonProcessDesc builder(argv[1]);
+        std::shared_ptr<edm::ProcessDesc> b = builder.processDesc();
+        parameters = b->getProcessPSet();
+    }
     parameters->registerIt();
     
     
@@ -74,6 +112,53 @@ int main (int argc, char* argv[]) {
     
     // output file name base
     std::string _outputName = outputs.getParameter<std::string>("outputName");
+    std::string const _treename = outputs.getParameter<std::string>("treeName");
+    std::vector<std::string> const _fileNames = inputs.getParameter<std::vector<std::string> >("fileNames");
+    
+    
+    // selection cache: inputs.selectionCache names the cache of an earlier job on
+    // the same files, only its passing events are visited and the selection is
+    // not rerun; outputs.selectionCache writes the cache of this job
+    std::string const _selectionCacheName = inputs.exists("selectionCache") ? inputs.getUntrackedParameter<std::string>("selectionCache") : "";
+    bool const replay = !_selectionCacheName.empty();
+    LjmetSelectionCache selectionCache;
+    if (replay) {
+        if (!selectionCache.Open(_selectionCacheName)) {
+            std::cout << legend << "cannot use the selection cache, exiting" << std::endl;
+            std::exit(-1);
+        }
+        if (selectionCache.GetFileNames() != _fileNames) {
+            std::cout << legend << "selection cache " << _selectionCacheName << " was made from other input files, exiting" << std::endl;
+            std::exit(-1);
+        }
+        if (selectionCache.GetSkipEvents() != nEventsToSkip || selectionCache.GetNEvents() != maxEvents) {
+            std::cout << legend << "selection cache " << _selectionCacheName << " was made for skipEvents " << selectionCache.GetSkipEvents()
+                      << " and nEvents " << selectionCache.GetNEvents() << ", this job has " << nEventsToSkip << " and " << maxEvents << ", exiting" << std::endl;
+            std::exit(-1);
+        }
+        std::cout << legend << "running on the " << selectionCache.GetEntries() << " selected events of " << _selectionCacheName << std::endl;
+    }
+    
+    
+    // checkpointing: every checkpointEvents events the output file is written
+    // and the position recorded in <outputName>.ckpt, a restarted job resumes there
+    int const checkpointEvents = outputs.exists("checkpointEvents") ? outputs.getUntrackedParameter<int>("checkpointEvents") : 0;
+    LjmetCheckpoint checkpoint(_outputName, _treename, _fileNames, nEventsToSkip, maxEvents);
+    TFile * _resumeFile = 0;
+    if (checkpointEvents > 0 && !replay && checkpoint.Read()) _resumeFile = checkpoint.OpenOutput();
+    bool const resume = (_resumeFile != 0);
+    
+    
+    // the selection cache needs the whole job, it is not written by a resumed one
+    bool writeSelectionCache = !replay && outputs.exists("selectionCache") && outputs.getUntrackedParameter<bool>("selectionCache");
+    if (writeSelectionCache && resume) {
+        std::cout << legend << "resumed job, not writing the selection cache" << std::endl;
+        writeSelectionCache = false;
+    }
+    if (writeSelectionCache && !selectionCache.Create(_outputName+".selection.root")) {
+        std::cout << legend << "cannot write the selection cache, exiting" << std::endl;
+        std::exit(-1);
+    }
     
     
     // log file
@@ -84,7 +169,7 @@ int main (int argc, char* argv[]) {
     
     // usage
     if ( argc < 2 ) {
-        std::cout << legend << "usage : " << argv[0] << " [parameters.py]" << std::endl;
+        std::cout << legend << "usage : " << argv[0] << " [parameters.py | snapshot [overrides]]" << std::endl;
         return 0;
     }
     
@@ -115,15 +200,25 @@ int main (int argc, char* argv[]) {
     //std::cout << std::endl;
     
     
-    // TFileService for saving the output ROOT tree
+    // TFileService for saving the output ROOT tree,
+    // a resumed job keeps writing the output of the interrupted one
     std::cout << legend << "setting up TFileService" << std::endl;
-    fwlite::TFileService fs = fwlite::TFileService( _outputName+".root" );
+    TFile * _outputFile = resume ? _resumeFile : TFile::Open( (_outputName+".root").c_str(), "RECREATE" );
+    fwlite::TFileService fs( _outputFile );
     
     
     // output tree
-    std::cout << legend << "Creating output tree" << std::endl;
-    std::string const _treename = outputs.getParameter<std::string>("treeName");
-    TTree * _tree = fs.make<TTree>(_treename.c_str(), _treename.c_str(), 64000000);
+    TTree * _tree = 0;
+    if (resume) {
+        std::cout << legend << "Continuing output tree" << std::endl;
+        _outputFile->GetObject(_treename.c_str(), _tree);
+    }
+    else {
+        std::cout << legend << "Creating output tree" << std::endl;
+        _tree = fs.make<TTree>(_treename.c_str(), _treename.c_str(), 64000000);
+    }
+    // checkpoints write the tree, an autosave would replace the checkpointed cycle
+    if (checkpointEvents > 0) _tree->SetAutoSave(0);
     
     
     // book histograms
@@ -168,7 +263,7 @@ int main (int argc, char* argv[]) {
     theSelector->BeginJob(mPar);
     
     
-    // set excluded calculators
+    // set requested and excluded calculators
     if (mPar.find("ljmet")!=mPar.end()){
         
         std::vector<std::string> vLjmetParams = mPar["ljmet"].getParameterNames();
@@ -180,9 +275,20 @@ int main (int argc, char* argv[]) {
             factory->SetExcludedCalcs(vExcl);
         }
         
+        if (std::find(vLjmetParams.begin(), vLjmetParams.end(), "calculators")!=vLjmetParams.end()){
+            std::vector<std::string> vCalcs =
+            mPar["ljmet"].getParameter<std::vector<std::string> >("calculators");
+            
+            factory->SetRequestedCalcs(vCalcs);
+        }
+        
     }
     
     
+    // construct only the calculators this job runs
+    factory->BuildCalcs();
+    
+    
     // send config parameters to calculators
     factory->SetAllCalcConfig(mPar);
     
@@ -214,6 +320,31 @@ int main (int argc, char* argv[]) {
     }
     
     
+    // continue the tree, histograms, cut flow and calculator totals of the interrupted job
+    if (resume) {
+        if (!ec.Resume(checkpoint.GetTreeEntries())) {
+            std::cout << legend << "cannot resume the output tree, exiting" << std::endl;
+            std::exit(-1);
+        }
+        // the booked histograms replace the checkpointed cycle at the next write
+        std::string const _cycle = ";" + std::to_string(checkpoint.GetCycle());
+        TH1 * _oldHist = 0;
+        _outputFile->GetObject(("histos/nevents"+_cycle).c_str(), _oldHist);
+        hists["nevents"]->Add(_oldHist);
+        delete _oldHist;
+        for (iMod=mh.begin();iMod!=mh.end();++iMod){
+            for (iHist=iMod->second.begin();iHist!=iMod->second.end();++iHist){
+                _oldHist = 0;
+                _outputFile->GetObject((iMod->first+"/"+iHist->second.GetName()+_cycle).c_str(), _oldHist);
+                if (_oldHist) iHist->second.GetHist()->Add(_oldHist);
+                delete _oldHist;
+            }
+        }
+        theSelector->SetCutFlow(checkpoint.GetCutFlow());
+        factory->SetAllCalcState(checkpoint.GetCalcState());
+    }
+    
+    
     
     
     // data/MC flag
@@ -240,10 +371,17 @@ int main (int argc, char* argv[]) {
     // Superseded by the JSON file machinery
     std::vector<int> const & runs = ljmetParams.getParameter<std::vector<int> >("runs");
     
-    // This object 'event' is used both to get all information from the
-    // event as well as to store histograms, etc.
-    std::cout << legend << "Setting up chain event" << std::endl;
-    fwlite::ChainEvent ev ( inputs.getParameter<std::vector<std::string> > ("fileNames") );
+    // Events of the input files, or generated ones with inputs.source = 'synthetic'
+    std::cout << legend << "Setting up the event source" << std::endl;
+    LjmetEventSource * _source = LjmetEventSource::Create(inputs);
+    if (!_source) {
+        std::cout << legend << "no event source, exiting" << std::endl;
+        std::exit(-1);
+    }
+    LjmetEventSource & ev = *_source;
+    
+    // TTreeCache of the input branches in use, see LjmetInputTuner.h
+    LjmetInputTuner inputTuner(inputs);
     
     
     
@@ -251,106 +389,176 @@ int main (int argc, char* argv[]) {
     //
     // event loop
     //
+    double const _startupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _startTime).count();
+    std::cout << legend << "startup took " << _startupSeconds << " s" << std::endl;
+    _logfile << legend << "startup took " << _startupSeconds << " s" << std::endl;
     std::cout << legend << "Begin loop over events" << std::endl;
     int nev = 0;
+    int const firstEntry = resume ? checkpoint.GetEntry() : nEventsToSkip;
     bool firstEvent = true;
-    for (ev.toBegin();
-         !ev.atEnd() && nev!=maxEvents;
-         ++ev, ++nev, firstEvent=false) {
+    LjmetSelectionCache::Record selectionRecord;
+    if (replay) {
+        for (Long64_t i = 0; i < selectionCache.GetEntries(); ++i, ++nev) {
+            
+            LjmetSelectionCache::Record const & record = selectionCache.GetRecord(i);
+            ev.To(record.entry);
+            edm::EventBase const & event = ev.GetEvent();
+            inputTuner.Process(ev.GetFile());
+            
+            // progress printout
+            if ( nev % 100 == 0 ) std::cout << legend << nev << " selected events processed. Processing run " << event.id().run() << ", event " << event.id().event() << std::endl;
+            
+            factory->RunBeginEvent(event, ec);
+            factory->RunAllProducers(event, theSelector);
+            
+            // selected objects of the cached event instead of the event selection
+            pat::strbitset ret = theSelector->getBitTemplate();
+            theSelector->SetSelection(event, record, ret);
+            
+            factory->RunAllCalculators(event, theSelector, ec);
+            theSelector->AnalyzeEvent(event, ec);
+            factory->RunEndEvent(event, ec);
+            ec.Fill();
+        }
         
-        // skip specified number of events
-        if (firstEvent && nEventsToSkip != 0){
-            if (nEventsToSkip < ev.size()){
-                std::cout << "Skipping " << nEventsToSkip << "events..." << std::endl;
-                ev.to(nEventsToSkip);
-                nev += nEventsToSkip;
+        // event count and cut flow of the job that made the cache
+        hists["nevents"]->SetBinContent(1, selectionCache.GetProcessed());
+        hists["nevents"]->SetEntries(selectionCache.GetProcessed());
+        theSelector->SetCutFlow(selectionCache.GetCutFlow());
+    }
+    else {
+        for (ev.ToBegin();
+             !ev.AtEnd() && nev!=maxEvents;
+             ev.Next(), ++nev, firstEvent=false) {
+            
+            // skip specified number of events, or the events done before the checkpoint
+            if (firstEvent && firstEntry != 0){
+                if (firstEntry < ev.Size()){
+                    std::cout << "Skipping " << firstEntry << "events..." << std::endl;
+                    ev.To(firstEntry);
+                    nev += firstEntry;
+                }
+                else{
+                    std::cout << legend << "Cannot skip " << firstEntry << "events, it is more than I have: " << ev.Size() << std::endl;
+                }
             }
-            else{
-                std::cout << legend << "Cannot skip " << nEventsToSkip << "events, it is more than I have: " << ev.size() << std::endl;
+            
+            
+            // checkpoint before the event, so that a resumed job starts with it
+            if (!firstEvent && checkpointEvents > 0 && nev % checkpointEvents == 0) {
+                checkpoint.Write(fs.file(), nev, (long long)hists["nevents"]->GetEntries(), _tree->GetEntries(),
+                                 theSelector->GetCutFlow(), factory->GetAllCalcState());
             }
-        }
-        
-        
-        // current event
-        edm::EventBase const & event = ev;
-        
-        // count event before any selection
-        hists["nevents"]->Fill(1);
-        
-        // progress printout
-        if ( nev % 100 == 0 ) std::cout << legend << nev << " events processed. Processing run " << event.id().run() << ", event " << event.id().event() << std::endl;
-        
-        
-        if ( (!isMc) ){
             
-            // check if the run needs to be processed
-            if (! JsonContainsEvent (vJson, event) ) continue;
-            else if ( runs.size() > 0 &&
-                     find( runs.begin(),
-                          runs.end(),
-                          event.id().run() ) == runs.end() ) continue;
-        }
-        
-        
-        //
-        //_____ Run private begin-of-event methods ___________________
-        //
-        factory->RunBeginEvent(event, ec);
-        
-        
-        
-        // run producers
-        factory->RunAllProducers(event, theSelector);
-        
-        
-        
-        // event selection
-        pat::strbitset ret = theSelector->getBitTemplate();
-        bool passed = (*theSelector)( event, ret );
-        
-        
-        if ( passed ) {
             
-            //
-            //_____ Run all variable calculators now ___________________
-            //
-            factory->RunAllCalculators(event, theSelector, ec);
+            // current event
+            edm::EventBase const & event = ev.GetEvent();
+            inputTuner.Process(ev.GetFile());
             
+            // count event before any selection
+            hists["nevents"]->Fill(1);
+            
+            // progress printout
+            if ( nev % 100 == 0 ) std::cout << legend << nev << " events processed. Processing run " << event.id().run() << ", event " << event.id().event() << std::endl;
             
-            //
-            //_____ Run selector-specific code if any___________________
-            //
-            theSelector->AnalyzeEvent(event, ec);
             
+            if ( (!isMc) ){
+                
+                // check if the run needs to be processed
+                if (! JsonContainsEvent (vJson, event) ) continue;
+                else if ( runs.size() > 0 &&
+                         find( runs.begin(),
+                              runs.end(),
+                              event.id().run() ) == runs.end() ) continue;
+            }
             
             
             //
-            //_____ Run private end-of-event methods ___________________
+            //_____ Run private begin-of-event methods ___________________
             //
-            factory->RunEndEvent(event, ec);
+            factory->RunBeginEvent(event, ec);
             
             
             
-            //
-            //_____Fill output file ____________________________________
-            //
-            ec.Fill();
+            // run producers
+            factory->RunAllProducers(event, theSelector);
             
-        } // end if statement for final cut requirements
-        
-        
-        
-    } // end loop over events
+            
+            
+            // event selection
+            pat::strbitset ret = theSelector->getBitTemplate();
+            bool passed = (*theSelector)( event, ret );
+            
+            
+            if ( passed ) {
+                
+                //
+                //_____ Run all variable calculators now ___________________
+                //
+                factory->RunAllCalculators(event, theSelector, ec);
+                
+                
+                //
+                //_____ Run selector-specific code if any___________________
+                //
+                theSelector->AnalyzeEvent(event, ec);
+                
+                
+                
+                //
+                //_____ Run private end-of-event methods ___________________
+                //
+                factory->RunEndEvent(event, ec);
+                
+                
+                
+                //
+                //_____Fill output file ____________________________________
+                //
+                ec.Fill();
+                
+                if (writeSelectionCache) {
+                    theSelector->GetSelection(ret, selectionRecord);
+                    selectionRecord.entry = nev;
+                    selectionCache.Fill(selectionRecord);
+                }
+                
+            } // end if statement for final cut requirements
+            
+            
+            
+        } // end loop over events
+    }
     
     
     std::cout << legend << "Selection" << std::endl;
     theSelector->print(std::cout);
     theSelector->print(_logfile);
     
+    inputTuner.Report(std::cout);
+    inputTuner.Report(_logfile);
+    LjmetArena::GetInstance()->Report(std::cout);
+    LjmetArena::GetInstance()->Report(_logfile);
+    ev.Report(std::cout);
+    ev.Report(_logfile);
+    
     
     _logfile.close();
     
     
+    if (writeSelectionCache) {
+        selectionCache.Close(_fileNames, nEventsToSkip, maxEvents, (Long64_t)hists["nevents"]->GetEntries(), theSelector->GetCutFlow());
+    }
+    
+    
+    // the job is complete, a restart begins from scratch
+    if (checkpointEvents > 0) {
+        fs.file().Write();
+        fs.file().Flush();
+        checkpoint.Clear(fs.file());
+    }
+    
+    
     
     // Run EndJob() for calculators
     factory->EndJobAllCalc();
@@ -363,6 +571,7 @@ int main (int argc, char* argv[]) {
     
     
     delete theSelector;
+    delete _source;
     
     return 0;
 }
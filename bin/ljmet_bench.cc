@@ -0,0 +1,1019 @@
+//
+// Validation and microbenchmarks for LJMet kernels
+//
+// Each benchmark checks the optimized kernel against the reference
+// implementation on synthetic inputs, where there is one, and then
+// times both. Every timed kernel is reported in ns/op and in
+// allocations/op (calls of operator new).
+// Exits with non-zero status if any validation fails, or if a kernel
+// is slower or allocates more than in the baseline.
+//
+// usage: ljmet-bench [options] [benchmark name ...]
+//   --baseline=<file>        compare with the results stored in file
+//   --write-baseline=<file>  store the results in file
+//   --tolerance=<fraction>   allowed ns/op increase over the baseline, default 0.25
+//   --input=<file>           miniAOD file for the benchmarks that need events
+//
+// Benchmarks that need external data (LHAPDF sets, events) only run when named.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TMatrixD.h"
+#include "TMatrixDSym.h"
+#include "TMatrixDSymEigen.h"
+#include "TFile.h"
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TTree.h"
+#include "TVectorD.h"
+
+#include "DataFormats/FWLite/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "PhysicsTools/Utilities/interface/LumiReWeighting.h"
+#include "LJMet/Com/interface/BaseEventSelector.h"
+#include "LJMet/Com/interface/BTagWeight.h"
+#include "LJMet/Com/interface/BtagHardcodedConditions.h"
+#include "LJMet/Com/interface/EventShapeUtils.h"
+#include "LJMet/Com/interface/HitFitDriver.h"
+#include "LJMet/Com/interface/LJetsTopoVarsNew.h"
+#include "LJMet/Com/interface/LjmetEventContent.h"
+#include "LJMet/Com/interface/METzCalculator.h"
+#include "LJMet/Com/interface/Njettiness.hh"
+#include "LJMet/Com/interface/NsubjettinessEngine.h"
+#include "LJMet/Com/interface/PdfWeightEngine.h"
+#include "LJMet/Com/interface/PileUpWeightTable.h"
+
+
+
+//
+//_____ allocation counting ______________________________________
+//
+namespace {
+  std::atomic<long> gAllocations(0);
+}
+
+void * operator new( std::size_t size ){
+  ++gAllocations;
+  void * _p = std::malloc(size ? size : 1);
+  if (!_p) throw std::bad_alloc();
+  return _p;
+}
+
+void operator delete( void * p ) noexcept {
+  std::free(p);
+}
+
+
+
+namespace {
+
+  typedef std::chrono::high_resolution_clock Clock;
+
+  /// Time and number of allocations so far
+  struct Mark {
+    Clock::time_point time;
+    long allocations;
+  };
+
+  Mark Now(){
+    Mark _mark = { Clock::now(), gAllocations.load() };
+    return _mark;
+  }
+
+  double NsPerOp( Mark const & start, Mark const & stop, long nOps ){
+    return std::chrono::duration<double, std::nano>(stop.time - start.time).count()/nOps;
+  }
+
+  double AllocsPerOp( Mark const & start, Mark const & stop, long nOps ){
+    return double(stop.allocations - start.allocations)/nOps;
+  }
+
+  /// Per-operation cost of a kernel, summed over one or more timed intervals
+  struct Result {
+    Result(): ns(0.0), allocations(0), nOps(0) { }
+    void Add( Mark const & start, Mark const & stop, long n ){
+      ns += std::chrono::duration<double, std::nano>(stop.time - start.time).count();
+      allocations += stop.allocations - start.allocations;
+      nOps += n;
+    }
+    double NsPerOp() const { return nOps > 0 ? ns/nOps : 0.0; }
+    double AllocsPerOp() const { return nOps > 0 ? double(allocations)/nOps : 0.0; }
+    double ns;
+    long allocations;
+    long nOps;
+  };
+
+  /// Results of this run by kernel name, compared with the baseline at the end
+  std::map<std::string, Result> gResults;
+
+  void Record( std::string const & name, Mark const & start, Mark const & stop, long nOps ){
+    gResults[name].Add(start, stop, nOps);
+  }
+
+  /// Input file for the benchmarks on real events, from --input
+  std::string gInputFile;
+
+  /// Synthetic event: up to maxObj objects with realistic jet momenta
+  struct MomentumSoA {
+    std::vector<double> px, py, pz;
+  };
+
+  std::vector<MomentumSoA> MakeEvents( int nEvents, int maxObj, TRandom3 & rand ){
+    std::vector<MomentumSoA> events(nEvents);
+    for (int i = 0; i < nEvents; ++i){
+      int _n = 1 + rand.Integer(maxObj);
+      for (int k = 0; k < _n; ++k){
+        double _pt = 30.0 + rand.Exp(60.0);
+        double _eta = rand.Uniform(-2.4, 2.4);
+        double _phi = rand.Uniform(-M_PI, M_PI);
+        events[i].px.push_back(_pt*std::cos(_phi));
+        events[i].py.push_back(_pt*std::sin(_phi));
+        events[i].pz.push_back(_pt*std::sinh(_eta));
+      }
+      // a few degenerate topologies: back-to-back and collinear pairs
+      if (i % 17 == 0 && _n > 1){
+        events[i].px[1] = -events[i].px[0];
+        events[i].py[1] = -events[i].py[0];
+        events[i].pz[1] = -events[i].pz[0];
+      }
+    }
+    return events;
+  }
+
+
+
+  //
+  //_____ momentum tensor eigenvalues ______________________________
+  //
+  int BenchEventShape( std::ostream & out ){
+    TRandom3 _rand(4357);
+    std::vector<MomentumSoA> events = MakeEvents(20000, 10, _rand);
+    const double tolerance = 1.e-9;
+
+    // validation against ROOT: TMatrixDSymEigen (LJetsTopoVarsNew)
+    // and TMatrixD::EigenVectors (TopTopologicalVariables)
+    double _maxDiff = 0.0;
+    for (unsigned int i = 0; i < events.size(); ++i){
+      const MomentumSoA & ev = events[i];
+      double _fast[3];
+      EventShapeUtils::MomentumTensorEigenvalues(&ev.px[0], &ev.py[0], &ev.pz[0], ev.px.size(), _fast);
+
+      double _psum = 0.0;
+      TMatrixDSym M(3);
+      TMatrixD MG(3,3);
+      for (unsigned int k = 0; k < ev.px.size(); ++k){
+        double _p[3] = { ev.px[k], ev.py[k], ev.pz[k] };
+        for (int a = 0; a < 3; ++a)
+          for (int b = 0; b < 3; ++b) M(a,b) += _p[a]*_p[b];
+        _psum += _p[0]*_p[0] + _p[1]*_p[1] + _p[2]*_p[2];
+      }
+      M *= 1.0/_psum;
+      MG = M;
+      TMatrixDSymEigen eigenMatrix(M);
+      const TVectorD & _root = eigenMatrix.GetEigenValues();
+      TVectorD _rootG(3);
+      MG.EigenVectors(_rootG);
+      for (int a = 0; a < 3; ++a){
+        _maxDiff = std::max(_maxDiff, std::fabs(_fast[a] - _root[a]));
+        _maxDiff = std::max(_maxDiff, std::fabs(_fast[a] - _rootG[a]));
+      }
+    }
+    bool _ok = _maxDiff < tolerance;
+    out << "EventShape: max |lambda - lambda(ROOT)| = " << _maxDiff
+        << (_ok ? "  OK" : "  FAILED") << std::endl;
+
+    // timing
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (unsigned int i = 0; i < events.size(); ++i){
+      const MomentumSoA & ev = events[i];
+      TMatrixDSym M(3);
+      double _psum = 0.0;
+      for (unsigned int k = 0; k < ev.px.size(); ++k){
+        double _p[3] = { ev.px[k], ev.py[k], ev.pz[k] };
+        for (int a = 0; a < 3; ++a)
+          for (int b = a; b < 3; ++b) M(a,b) += _p[a]*_p[b];
+        _psum += _p[0]*_p[0] + _p[1]*_p[1] + _p[2]*_p[2];
+      }
+      for (int a = 0; a < 3; ++a)
+        for (int b = a+1; b < 3; ++b) M(b,a) = M(a,b);
+      M *= 1.0/_psum;
+      TMatrixDSymEigen eigenMatrix(M);
+      _sink += eigenMatrix.GetEigenValues()[2];
+    }
+    Mark _t1 = Now();
+    for (unsigned int i = 0; i < events.size(); ++i){
+      const MomentumSoA & ev = events[i];
+      double _fast[3];
+      EventShapeUtils::MomentumTensorEigenvalues(&ev.px[0], &ev.py[0], &ev.pz[0], ev.px.size(), _fast);
+      _sink += _fast[2];
+    }
+    Mark _t2 = Now();
+
+    out << "EventShape: TMatrixDSymEigen " << NsPerOp(_t0, _t1, events.size()) << " ns/event, "
+        << "closed-form " << NsPerOp(_t1, _t2, events.size()) << " ns/event"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("EventShape/TMatrixDSymEigen", _t0, _t1, events.size());
+    Record("EventShape/closed-form", _t1, _t2, events.size());
+
+    return _ok ? 0 : 1;
+  }
+
+
+
+  //
+  //_____ N-subjettiness tau1..tau3 ________________________________
+  //
+  int BenchNsubjettiness( std::ostream & out ){
+    TRandom3 _rand(8231);
+    const int nJets = 500;
+    const double tolerance = 1.e-9;
+
+    // synthetic AK8 jets: two or three prongs plus soft radiation
+    std::vector<MomentumSoA> jets(nJets);
+    std::vector<std::vector<double> > energies(nJets);
+    for (int i = 0; i < nJets; ++i){
+      double _eta0 = _rand.Uniform(-2.0, 2.0);
+      double _phi0 = _rand.Uniform(0.0, 2.0*M_PI);
+      int _nProngs = 2 + _rand.Integer(2);
+      int _n = 20 + _rand.Integer(80);
+      for (int k = 0; k < _n; ++k){
+        int _prong = k % (_nProngs + 1);
+        double _eta = _eta0 + (_prong < _nProngs ? 0.3*std::cos(2.0*M_PI*_prong/_nProngs) : 0.0) + _rand.Gaus(0.0, 0.08);
+        double _phi = _phi0 + (_prong < _nProngs ? 0.3*std::sin(2.0*M_PI*_prong/_nProngs) : 0.0) + _rand.Gaus(0.0, 0.08);
+        double _pt = _rand.Exp(_prong < _nProngs ? 15.0 : 2.0) + 0.5;
+        double _px = _pt*std::cos(_phi), _py = _pt*std::sin(_phi), _pz = _pt*std::sinh(_eta);
+        jets[i].px.push_back(_px);
+        jets[i].py.push_back(_py);
+        jets[i].pz.push_back(_pz);
+        energies[i].push_back(std::sqrt(_px*_px + _py*_py + _pz*_pz + 0.0195));
+      }
+    }
+
+    std::vector<std::vector<fastjet::PseudoJet> > particles(nJets);
+    for (int i = 0; i < nJets; ++i)
+      for (unsigned int k = 0; k < jets[i].px.size(); ++k)
+        particles[i].push_back(fastjet::PseudoJet(jets[i].px[k], jets[i].py[k], jets[i].pz[k], energies[i][k]));
+
+    Njettiness _ref(Njettiness::onepass_kt_axes, NsubParameters(1.0, 0.8));
+    NsubjettinessEngine _engine(NsubjettinessEngine::onepass_kt_axes, 1.0, 0.8);
+
+    // validation against Njettiness.hh
+    double _maxRel = 0.0;
+    for (int i = 0; i < nJets; ++i){
+      double _tau[3];
+      _engine.GetTaus(3, &jets[i].px[0], &jets[i].py[0], &jets[i].pz[0], &energies[i][0], jets[i].px.size(), _tau);
+      for (unsigned int n = 1; n <= 3; ++n){
+        double _r = _ref.getTau(n, particles[i]);
+        _maxRel = std::max(_maxRel, std::fabs(_tau[n-1] - _r)/std::max(std::fabs(_r), 1.e-12));
+      }
+    }
+    bool _ok = _maxRel < tolerance;
+    out << "Nsubjettiness: max relative |tau - tau(Njettiness)| = " << _maxRel
+        << (_ok ? "  OK" : "  FAILED") << std::endl;
+
+    // timing
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (int i = 0; i < nJets; ++i)
+      for (unsigned int n = 1; n <= 3; ++n) _sink += _ref.getTau(n, particles[i]);
+    Mark _t1 = Now();
+    for (int i = 0; i < nJets; ++i){
+      double _tau[3];
+      _engine.GetTaus(3, &jets[i].px[0], &jets[i].py[0], &jets[i].pz[0], &energies[i][0], jets[i].px.size(), _tau);
+      _sink += _tau[0] + _tau[1] + _tau[2];
+    }
+    Mark _t2 = Now();
+
+    out << "Nsubjettiness: Njettiness " << NsPerOp(_t0, _t1, nJets) << " ns/jet, "
+        << "engine " << NsPerOp(_t1, _t2, nJets) << " ns/jet"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("Nsubjettiness/Njettiness", _t0, _t1, nJets);
+    Record("Nsubjettiness/engine", _t1, _t2, nJets);
+
+    return _ok ? 0 : 1;
+  }
+
+
+
+  //
+  //_____ b-tag event weights ______________________________________
+  //
+  // two operating points: at least one tight and two loose tags
+  struct BTag1Tight2LooseFilter {
+    static bool filter(const std::vector<int> & t){ return t[1] >= 1 && t[0] >= 2; }
+  };
+
+  template <class Filter> double BTagRelDiff( BTagWeight & btag, const std::vector<std::vector<BTagWeight::JetInfo> > & jets ){
+    double _ref = btag.weightBruteForce<Filter>(jets);
+    return std::fabs(btag.weight<Filter>(jets) - _ref)/std::max(std::fabs(_ref), 1.e-12);
+  }
+
+  int BenchBTagWeight( std::ostream & out ){
+    TRandom3 _rand(2741);
+    const int nEvents = 200;
+    // brute force sums in float
+    const double tolerance = 1.e-4;
+
+    // 1 to 10 jets with one (loose) or two (loose, tight) operating points
+    std::vector<std::vector<std::vector<BTagWeight::JetInfo> > > events(nEvents);
+    for (int i = 0; i < nEvents; ++i){
+      int _n = 1 + i % 10;
+      for (int j = 0; j < _n; ++j){
+        std::vector<BTagWeight::JetInfo> _jet;
+        float _eff = _rand.Uniform(0.05, 0.8);
+        _jet.push_back(BTagWeight::JetInfo(_eff, _rand.Uniform(0.85, 1.1)));
+        _jet.push_back(BTagWeight::JetInfo(_eff*_rand.Uniform(0.2, 0.8), _rand.Uniform(0.85, 1.1)));
+        events[i].push_back(_jet);
+      }
+    }
+
+    // validation against the tag configuration enumeration
+    BTagWeight _btag2(2);
+    double _maxRel = 0.0;
+    for (int i = 0; i < nEvents; ++i){
+      _maxRel = std::max(_maxRel, BTagRelDiff<BTag0MediumFilter>(_btag2, events[i]));
+      _maxRel = std::max(_maxRel, BTagRelDiff<BTag1MediumFilter>(_btag2, events[i]));
+      _maxRel = std::max(_maxRel, BTagRelDiff<BTag2MediumFilter>(_btag2, events[i]));
+      _maxRel = std::max(_maxRel, BTagRelDiff<BTagGE1MediumFilter>(_btag2, events[i]));
+      _maxRel = std::max(_maxRel, BTagRelDiff<BTagGE2MediumFilter>(_btag2, events[i]));
+      _maxRel = std::max(_maxRel, BTagRelDiff<BTag1Tight2LooseFilter>(_btag2, events[i]));
+    }
+    bool _ok = _maxRel < tolerance;
+    out << "BTagWeight: max relative |w - w(enumeration)| = " << _maxRel
+        << (_ok ? "  OK" : "  FAILED") << std::endl;
+
+    // timing, six filters per event
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      _sink += _btag2.weightBruteForce<BTag0MediumFilter>(events[i]);
+      _sink += _btag2.weightBruteForce<BTag1MediumFilter>(events[i]);
+      _sink += _btag2.weightBruteForce<BTag2MediumFilter>(events[i]);
+      _sink += _btag2.weightBruteForce<BTagGE1MediumFilter>(events[i]);
+      _sink += _btag2.weightBruteForce<BTagGE2MediumFilter>(events[i]);
+      _sink += _btag2.weightBruteForce<BTag1Tight2LooseFilter>(events[i]);
+    }
+    Mark _t1 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      _btag2.setJets(events[i]);
+      _sink += _btag2.weight<BTag0MediumFilter>();
+      _sink += _btag2.weight<BTag1MediumFilter>();
+      _sink += _btag2.weight<BTag2MediumFilter>();
+      _sink += _btag2.weight<BTagGE1MediumFilter>();
+      _sink += _btag2.weight<BTagGE2MediumFilter>();
+      _sink += _btag2.weight<BTag1Tight2LooseFilter>();
+    }
+    Mark _t2 = Now();
+
+    out << "BTagWeight: enumeration " << NsPerOp(_t0, _t1, nEvents) << " ns/event, "
+        << "tag counts " << NsPerOp(_t1, _t2, nEvents) << " ns/event"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("BTagWeight/enumeration", _t0, _t1, nEvents);
+    Record("BTagWeight/tag-counts", _t1, _t2, nEvents);
+
+    return _ok ? 0 : 1;
+  }
+
+
+
+  //
+  //_____ pileup weights, all scenarios ____________________________
+  //
+  int BenchPileUp( std::ostream & out ){
+    TRandom3 _rand(6607);
+    const int nBins = 60;
+    const int nScenarios = 15;
+    const int nEvents = 200000;
+    // inputs are float for edm::LumiReWeighting
+    const double tolerance = 1.e-5;
+
+    // Poisson-like distributions with different means
+    std::vector<float> _mcF(nBins);
+    std::vector<double> _mc(nBins);
+    for (int i = 0; i < nBins; ++i){
+      _mcF[i] = TMath::Poisson(i, 22.0) + 1.e-6;
+      _mc[i] = _mcF[i];
+    }
+    std::vector<edm::LumiReWeighting> _ref;
+    PileUpWeightTable _table;
+    _table.SetMCDistribution(_mc);
+    for (int k = 0; k < nScenarios; ++k){
+      std::vector<float> _dataF(nBins);
+      std::vector<double> _data(nBins);
+      double _mean = 18.0 + k;
+      for (int i = 0; i < nBins; ++i){
+        _dataF[i] = 1.e9*TMath::Poisson(i, _mean);
+        _data[i] = _dataF[i];
+      }
+      _ref.push_back(edm::LumiReWeighting(_mcF, _dataF));
+      std::ostringstream _name;
+      _name << "weight_PU_" << k;
+      _table.AddScenario(_name.str(), _data);
+    }
+    _table.Initialize();
+
+    std::vector<float> nTrue(nEvents);
+    for (int i = 0; i < nEvents; ++i) nTrue[i] = _rand.Uniform(-1.0, nBins + 1.0);
+
+    // validation against edm::LumiReWeighting
+    double _maxRel = 0.0;
+    for (int i = 0; i < nEvents; ++i){
+      const double * _w = _table.GetWeights(nTrue[i]);
+      for (int k = 0; k < nScenarios; ++k){
+        double _r = _ref[k].weight(nTrue[i]);
+        _maxRel = std::max(_maxRel, std::fabs(_w[k] - _r)/std::max(std::fabs(_r), 1.e-12));
+      }
+    }
+    bool _ok = _maxRel < tolerance;
+    out << "PileUp: max relative |w - w(LumiReWeighting)| = " << _maxRel
+        << (_ok ? "  OK" : "  FAILED") << std::endl;
+
+    // timing
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (int i = 0; i < nEvents; ++i)
+      for (int k = 0; k < nScenarios; ++k) _sink += _ref[k].weight(nTrue[i]);
+    Mark _t1 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      const double * _w = _table.GetWeights(nTrue[i]);
+      for (int k = 0; k < nScenarios; ++k) _sink += _w[k];
+    }
+    Mark _t2 = Now();
+
+    out << "PileUp: " << nScenarios << " x LumiReWeighting " << NsPerOp(_t0, _t1, nEvents) << " ns/event, "
+        << "table " << NsPerOp(_t1, _t2, nEvents) << " ns/event"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("PileUp/LumiReWeighting", _t0, _t1, nEvents);
+    Record("PileUp/table", _t1, _t2, nEvents);
+
+    return _ok ? 0 : 1;
+  }
+
+
+
+
+  //
+  //_____ HitFit permutation driver ________________________________
+  //
+
+  /// Stand-in for Top_Fit::fit_one_perm: iteratively rescales the jet
+  /// energies until the W and top masses are met, chi2 of the scale factors
+  struct SyntheticHitFit {
+    HitFitDriver const * driver;
+    std::vector<HitFitDriver::Jet> jets;
+
+    double operator()( unsigned int hypothesis, unsigned int /*worker*/ ){
+      HitFitDriver::Hypothesis const & _h = driver->GetHypotheses()[hypothesis];
+      std::vector<double> _scale(jets.size(), 1.0);
+      double _chi2 = 0.0;
+      for (int iter = 0; iter < 400; ++iter){
+        double _w[4] = { 0, 0, 0, 0 }, _t[4] = { 0, 0, 0, 0 };
+        for (unsigned int j = 0; j < jets.size(); ++j){
+          double _p[4] = { _scale[j]*jets[j].px, _scale[j]*jets[j].py, _scale[j]*jets[j].pz, _scale[j]*jets[j].e };
+          for (int c = 0; c < 4; ++c){
+            if (_h.roles[j] == HitFitDriver::roleHadW) _w[c] += _p[c];
+            if (_h.roles[j] == HitFitDriver::roleHadW || _h.roles[j] == HitFitDriver::roleHadB) _t[c] += _p[c];
+          }
+        }
+        double _mW = std::sqrt(std::max(0.0, _w[3]*_w[3] - _w[0]*_w[0] - _w[1]*_w[1] - _w[2]*_w[2]));
+        double _mT = std::sqrt(std::max(0.0, _t[3]*_t[3] - _t[0]*_t[0] - _t[1]*_t[1] - _t[2]*_t[2]));
+        double _dW = _mW > 0 ? 80.4/_mW : 1.0, _dT = _mT > 0 ? 172.5/_mT : 1.0;
+        _chi2 = 0.0;
+        for (unsigned int j = 0; j < jets.size(); ++j){
+          if (_h.roles[j] == HitFitDriver::roleHadW) _scale[j] *= std::pow(_dW, 0.05);
+          else if (_h.roles[j] == HitFitDriver::roleHadB) _scale[j] *= std::pow(_dT, 0.05);
+          _chi2 += std::pow((_scale[j] - 1.0)/0.1, 2);
+        }
+      }
+      return _h.nuz ? _chi2 + 0.5 : _chi2;
+    }
+  };
+
+  int BenchHitFitDriver( std::ostream & out ){
+    TRandom3 _rand(1680);
+    const int nEvents = 100;
+    const unsigned int nJets = 5;
+
+    std::vector<std::vector<HitFitDriver::Jet> > events(nEvents);
+    for (int i = 0; i < nEvents; ++i){
+      unsigned int _nTags = 1 + _rand.Integer(2);
+      for (unsigned int k = 0; k < nJets; ++k){
+        double _pt = 30.0 + _rand.Exp(60.0);
+        double _eta = _rand.Uniform(-2.4, 2.4);
+        double _phi = _rand.Uniform(-M_PI, M_PI);
+        HitFitDriver::Jet _jet = { _pt*std::cos(_phi), _pt*std::sin(_phi), _pt*std::sinh(_eta), _pt*std::cosh(_eta), k < _nTags };
+        events[i].push_back(_jet);
+      }
+    }
+
+    // 0: serial exhaustive reference, 1: all cores, 2: b-tag pruning, 3: b-tag and pre-fit chi2 pruning
+    const int nModes = 4;
+    const char * modeNames[nModes] = { "serial", "parallel", "parallel + b-tag", "parallel + b-tag + pre-fit chi2" };
+    const char * modeKeys[nModes] = { "serial", "parallel", "parallel-btag", "parallel-btag-prefit" };
+    std::vector<std::vector<double> > chi2[nModes];
+    std::vector<int> best[nModes];
+    double time[nModes];
+    long nFits[nModes];
+    unsigned int nWorkers = 1;
+    for (int mode = 0; mode < nModes; ++mode){
+      edm::ParameterSet _pset;
+      _pset.addUntrackedParameter<unsigned int>("hitfitNWorkers", mode == 0 ? 1 : 0);
+      _pset.addUntrackedParameter<int>("hitfitBTagPruning", mode >= 2 ? 2 : 0);
+      _pset.addUntrackedParameter<double>("hitfitMaxPreFitChi2", mode >= 3 ? 25.0 : 0.0);
+      HitFitDriver _driver(_pset);
+      nWorkers = std::max(nWorkers, _driver.GetNWorkers());
+      SyntheticHitFit _fit;
+      _fit.driver = &_driver;
+      nFits[mode] = 0;
+      Mark _t0 = Now();
+      for (int i = 0; i < nEvents; ++i){
+        nFits[mode] += _driver.SetJets(events[i]);
+        _fit.jets = events[i];
+        _driver.Run(_fit);
+        chi2[mode].push_back(std::vector<double>());
+        for (unsigned int h = 0; h < _driver.GetHypotheses().size(); ++h) chi2[mode].back().push_back(_driver.GetHypotheses()[h].chi2);
+        best[mode].push_back(_driver.GetBest());
+      }
+      Mark _t1 = Now();
+      time[mode] = NsPerOp(_t0, _t1, nEvents);
+      Record(std::string("HitFitDriver/") + modeKeys[mode], _t0, _t1, nEvents);
+    }
+
+    // every fitted hypothesis must match the exhaustive serial run exactly
+    bool _ok = true;
+    int _sameBest[nModes] = { 0, 0, 0, 0 };
+    for (int mode = 1; mode < nModes; ++mode){
+      for (int i = 0; i < nEvents; ++i){
+        for (unsigned int h = 0; h < chi2[0][i].size(); ++h)
+          if (chi2[mode][i][h] >= 0 && chi2[mode][i][h] != chi2[0][i][h]) _ok = false;
+        if (mode == 1 && best[mode][i] != best[0][i]) _ok = false;
+        if (best[mode][i] == best[0][i]) ++_sameBest[mode];
+      }
+    }
+    out << "HitFitDriver: fitted hypotheses identical to the serial exhaustive run"
+        << (_ok ? "  OK" : "  FAILED") << std::endl;
+
+    for (int mode = 0; mode < nModes; ++mode){
+      out << "HitFitDriver: " << modeNames[mode] << " (" << (mode == 0 ? 1 : nWorkers) << " workers) "
+          << time[mode]/1.e3 << " us/event, " << double(nFits[mode])/nEvents << " fits/event, speedup "
+          << time[0]/time[mode];
+      if (mode > 0) out << ", same best fit in " << _sameBest[mode] << "/" << nEvents << " events";
+      out << std::endl;
+    }
+
+    return _ok ? 0 : 1;
+  }
+
+
+  //
+  //_____ b-tag efficiency and scale factor lookups ________________
+  //
+  int BenchBtagConditions( std::ostream & out ){
+    TRandom3 _rand(3319);
+    const int nJets = 100000;
+    const std::string tagger = "CSVM";
+
+    std::vector<double> pt(nJets), eta(nJets);
+    for (int i = 0; i < nJets; ++i){
+      pt[i] = 20.0 + _rand.Exp(60.0);
+      eta[i] = _rand.Uniform(-2.4, 2.4);
+    }
+
+    // the lookups isJetTagged makes for every MC jet
+    BtagHardcodedConditions _cond;
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (int i = 0; i < nJets; ++i){
+      _sink += _cond.GetBtagScaleFactor(pt[i], eta[i], tagger);
+      _sink += _cond.GetBtagEfficiency(pt[i], eta[i], tagger);
+      _sink += _cond.GetMistagScaleFactor(pt[i], eta[i], tagger);
+      _sink += _cond.GetMistagRate(pt[i], eta[i], tagger);
+    }
+    Mark _t1 = Now();
+
+    out << "BtagConditions: 4 lookups " << NsPerOp(_t0, _t1, nJets) << " ns/jet, "
+        << AllocsPerOp(_t0, _t1, nJets) << " allocs/jet"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("BtagConditions/lookups", _t0, _t1, nJets);
+
+    return 0;
+  }
+
+
+
+  //
+  //_____ lepton + jets topological variables ______________________
+  //
+  bool JetPtGreater( std::pair<TLorentzVector, bool> const & a, std::pair<TLorentzVector, bool> const & b ){
+    return a.first.Pt() > b.first.Pt();
+  }
+
+  int BenchTopoVars( std::ostream & out ){
+    TRandom3 _rand(7741);
+    const int nEvents = 20000;
+
+    std::vector<std::vector<std::pair<TLorentzVector, bool> > > jets(nEvents);
+    std::vector<TLorentzVector> leptons(nEvents), mets(nEvents);
+    for (int i = 0; i < nEvents; ++i){
+      int _n = 3 + _rand.Integer(5);
+      for (int k = 0; k < _n; ++k){
+        TLorentzVector _jet;
+        _jet.SetPtEtaPhiM(30.0 + _rand.Exp(60.0), _rand.Uniform(-2.4, 2.4), _rand.Uniform(-M_PI, M_PI), _rand.Uniform(5.0, 20.0));
+        jets[i].push_back(std::make_pair(_jet, _rand.Rndm() < 0.3));
+      }
+      std::sort(jets[i].begin(), jets[i].end(), JetPtGreater);
+      leptons[i].SetPtEtaPhiM(30.0 + _rand.Exp(40.0), _rand.Uniform(-2.1, 2.1), _rand.Uniform(-M_PI, M_PI), 0.105658367);
+      mets[i].SetPtEtaPhiM(20.0 + _rand.Exp(50.0), 0.0, _rand.Uniform(-M_PI, M_PI), 0.0);
+    }
+
+    // setEvent, called by the constructor, and the getters LjetsTopoCalcNew stores
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      LJetsTopoVarsNew _t(jets[i], leptons[i], mets[i], true, true);
+      _sink += _t.pznu();
+    }
+    Mark _t1 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      LJetsTopoVarsNew _t(jets[i], leptons[i], mets[i], true, true);
+      _sink += _t.aplanarity() + _t.centrality() + _t.sphericity() + _t.ht() + _t.htpluslepton()
+        + _t.methtpluslepton() + _t.h() + _t.ktMinPrime() + _t.dphiLepMet() + _t.minDijetMass()
+        + _t.maxJetEta() + _t.Et3() + _t.minDijetDeltaR() + _t.LeptonJet_DeltaR() + _t.Jet1Jet2_DeltaR()
+        + _t.Jet1Jet2_DeltaPhi() + _t.Jet1Jet2_M() + _t.Jet1Jet2_Pt() + _t.Jet1Jet2W_M() + _t.Jet1Jet2W_Pt()
+        + _t.Hz() + _t.HT2() + _t.HT2prime() + _t.W_MT() + _t.W_M() + _t.W_Pt() + _t.DphiJMET() + _t.Muon_DeltaR()
+        + _t.getHt() + _t.getHtp() + _t.getHtpp() + _t.getHt2() + _t.getHt2p() + _t.getHt2pp() + _t.getHt3()
+        + _t.getHt3p() + _t.getHt3pp() + _t.getCen() + _t.getNJW() + _t.getJetEtaMax() + _t.getMdijetMin()
+        + _t.getMtjets() + _t.getSqrtsT() + _t.getMtAurelio() + _t.getPzOverHT() + _t.getMevent()
+        + _t.getM123inv() + _t.getEta2Sum() + _t.getMwRec() + _t.getH() + _t.getSph() + _t.getApl() + _t.getAplMu();
+    }
+    Mark _t2 = Now();
+
+    out << "TopoVars: setEvent " << NsPerOp(_t0, _t1, nEvents) << " ns/event, "
+        << AllocsPerOp(_t0, _t1, nEvents) << " allocs/event; "
+        << "setEvent + getters " << NsPerOp(_t1, _t2, nEvents) << " ns/event, "
+        << AllocsPerOp(_t1, _t2, nEvents) << " allocs/event"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("TopoVars/setEvent", _t0, _t1, nEvents);
+    Record("TopoVars/setEvent+getters", _t1, _t2, nEvents);
+
+    return 0;
+  }
+
+
+
+  //
+  //_____ neutrino pz from the W mass constraint ___________________
+  //
+  int BenchMETz( std::ostream & out ){
+    TRandom3 _rand(2203);
+    const int nEvents = 200000;
+
+    std::vector<TLorentzVector> leptons(nEvents), mets(nEvents);
+    for (int i = 0; i < nEvents; ++i){
+      leptons[i].SetPtEtaPhiM(30.0 + _rand.Exp(40.0), _rand.Uniform(-2.1, 2.1), _rand.Uniform(-M_PI, M_PI), 0.105658367);
+      mets[i].SetPtEtaPhiM(20.0 + _rand.Exp(50.0), 0.0, _rand.Uniform(-M_PI, M_PI), 0.0);
+    }
+
+    // all four root choices, as the calculators call it
+    METzCalculator _metz;
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      _metz.SetMET(mets[i]);
+      _metz.SetLepton(leptons[i]);
+      for (int type = 0; type < 4; ++type) _sink += _metz.Calculate(type);
+    }
+    Mark _t1 = Now();
+
+    out << "METz: Calculate " << NsPerOp(_t0, _t1, 4*nEvents) << " ns/call, "
+        << AllocsPerOp(_t0, _t1, 4*nEvents) << " allocs/call"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("METz/Calculate", _t0, _t1, 4*nEvents);
+
+    return 0;
+  }
+
+
+
+  //
+  //_____ event content and output tree ____________________________
+  //
+  int BenchEventContent( std::ostream & out ){
+    TRandom3 _rand(9157);
+    const int nEvents = 20000;
+    const int nScalars = 200;
+    const int nVectors = 40;
+
+    // branch names as the calculators make them
+    std::vector<std::string> scalarNames, vectorNames;
+    for (int k = 0; k < nScalars; ++k){
+      std::ostringstream _name;
+      _name << "variable" << k << "_singleLepCalc";
+      scalarNames.push_back(_name.str());
+    }
+    for (int k = 0; k < nVectors; ++k){
+      std::ostringstream _name;
+      _name << "theJetVariable" << k << "_JetSubCalc";
+      vectorNames.push_back(_name.str());
+    }
+    std::vector<std::vector<double> > values(nEvents);
+    for (int i = 0; i < nEvents; ++i){
+      values[i].resize(1 + _rand.Integer(10));
+      for (unsigned int j = 0; j < values[i].size(); ++j) values[i][j] = _rand.Exp(50.0);
+    }
+
+    // in-memory tree, no file I/O
+    std::map<std::string, edm::ParameterSet const> _par;
+    LjmetEventContent _ec(_par);
+    TTree _tree("ljmet", "ljmet");
+    _tree.SetDirectory(0);
+    _ec.SetTree(&_tree);
+
+    Result _set, _fill;
+    for (int i = 0; i < nEvents; ++i){
+      Mark _t0 = Now();
+      for (int k = 0; k < nScalars; ++k){
+        if (k % 4 == 0) _ec.SetValue(scalarNames[k], (int)k);
+        else _ec.SetValue(scalarNames[k], values[i][0] + k);
+      }
+      for (int k = 0; k < nVectors; ++k) _ec.SetValue(vectorNames[k], values[i]);
+      Mark _t1 = Now();
+      _ec.Fill();
+      Mark _t2 = Now();
+      _set.Add(_t0, _t1, nScalars + nVectors);
+      _fill.Add(_t1, _t2, 1);
+      // keep the tree in memory small
+      if (_tree.GetEntries() >= 1000) _tree.Reset();
+    }
+
+    out << "EventContent: SetValue " << _set.NsPerOp() << " ns/call, " << _set.AllocsPerOp() << " allocs/call; "
+        << "Fill " << _fill.NsPerOp() << " ns/event, " << _fill.AllocsPerOp() << " allocs/event" << std::endl;
+    gResults["EventContent/SetValue"] = _set;
+    gResults["EventContent/Fill"] = _fill;
+
+    return 0;
+  }
+
+
+
+  //
+  //_____ PDF weights, all members of all sets _____________________
+  //
+  int BenchPdfWeights( std::ostream & out ){
+    TRandom3 _rand(5113);
+    const int nEvents = 2000;
+    // grid interpolation reproduces LHAPDF to ~1e-4, far below PDF uncertainties
+    const double tolerance = 1.e-3;
+
+    std::vector<std::string> _sets;
+    _sets.push_back("cteq66.LHgrid");
+    _sets.push_back("MRST2006nnlo.LHgrid");
+    _sets.push_back("NNPDF10_100.LHgrid");
+    edm::ParameterSet _pset;
+    _pset.addUntrackedParameter<std::vector<std::string> >("PdfSetNames", _sets);
+    PdfWeightEngine _engine(_pset);
+    _engine.beginJob();
+
+    // hard-process partons: light quarks, b quarks and gluons
+    std::vector<double> x1(nEvents), x2(nEvents), Q(nEvents);
+    std::vector<int> id1(nEvents), id2(nEvents);
+    const int ids[] = { 21, 21, 21, 1, 2, -1, -2, 3, -3, 4, -4, 5, -5 };
+    for (int i = 0; i < nEvents; ++i){
+      x1[i] = std::exp(_rand.Uniform(std::log(1.e-3), std::log(0.8)));
+      x2[i] = std::exp(_rand.Uniform(std::log(1.e-3), std::log(0.8)));
+      Q[i] = std::exp(_rand.Uniform(std::log(20.0), std::log(2000.0)));
+      id1[i] = ids[_rand.Integer(13)];
+      id2[i] = ids[_rand.Integer(13)];
+    }
+
+    // validation against member-by-member LHAPDF calls (LjmetPdfWeightProducer)
+    std::vector<float> _fast(_engine.GetNWeights()), _ref(_engine.GetNWeights());
+    double _maxRel = 0.0;
+    int _nOffGrid = 0;
+    for (int i = 0; i < nEvents; ++i){
+      if (!_engine.GetWeights(x1[i], id1[i], x2[i], id2[i], Q[i], &_fast[0])) ++_nOffGrid;
+      _engine.GetWeightsDirect(x1[i], id1[i], x2[i], id2[i], Q[i], &_ref[0]);
+      for (unsigned int m = 0; m < _fast.size(); ++m)
+        _maxRel = std::max(_maxRel, (double)std::fabs(_fast[m] - _ref[m])/std::max((double)std::fabs(_ref[m]), 1.e-12));
+    }
+    bool _ok = _maxRel < tolerance;
+    out << "PdfWeights: " << _engine.GetNWeights() << " weights, max relative |w - w(LHAPDF)| = " << _maxRel
+        << ", " << _nOffGrid << " events off grid"
+        << (_ok ? "  OK" : "  FAILED") << std::endl;
+
+    // timing
+    double _sink = 0.0;
+    Mark _t0 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      _engine.GetWeightsDirect(x1[i], id1[i], x2[i], id2[i], Q[i], &_ref[0]);
+      _sink += _ref[1];
+    }
+    Mark _t1 = Now();
+    for (int i = 0; i < nEvents; ++i){
+      _engine.GetWeights(x1[i], id1[i], x2[i], id2[i], Q[i], &_fast[0]);
+      _sink += _fast[1];
+    }
+    Mark _t2 = Now();
+
+    out << "PdfWeights: LHAPDF " << NsPerOp(_t0, _t1, nEvents) << " ns/event, "
+        << "grid " << NsPerOp(_t1, _t2, nEvents) << " ns/event"
+        << "  (checksum " << _sink << ")" << std::endl;
+    Record("PdfWeights/LHAPDF", _t0, _t1, nEvents);
+    Record("PdfWeights/grid", _t1, _t2, nEvents);
+
+    return _ok ? 0 : 1;
+  }
+
+
+  //
+  //_____ jet energy corrections and b tagging _____________________
+  //
+  /// Selector with only the common BaseEventSelector setup
+  class BenchSelector : public BaseEventSelector {
+  public:
+    virtual bool operator()( edm::EventBase const & /*event*/, pat::strbitset & /*ret*/ ){ return true; }
+  };
+
+  int BenchCorrectJet( std::ostream & out ){
+    const int maxEvents = 2000;
+
+    if (gInputFile.empty()){
+      out << "CorrectJet: needs a miniAOD file, --input=<file>  FAILED" << std::endl;
+      return 1;
+    }
+    TFile * _file = TFile::Open(gInputFile.c_str());
+    if (!_file || _file->IsZombie()){
+      out << "CorrectJet: cannot open " << gInputFile << "  FAILED" << std::endl;
+      return 1;
+    }
+
+    // MC with the jet corrections in the package data directory
+    char const * _base = std::getenv("CMSSW_BASE");
+    std::string _data = std::string(_base ? _base : ".") + "/src/LJMet/Com/data/";
+    edm::ParameterSet _pset;
+    _pset.addParameter<bool>("isMc", true);
+    _pset.addParameter<bool>("doNewJEC", true);
+    _pset.addParameter<std::string>("JEC_txtfile", "");
+    _pset.addParameter<std::string>("MCL1JetPar", _data + "PHYS14_25_V2_L1FastJet_AK4PFchs.txt");
+    _pset.addParameter<std::string>("MCL2JetPar", _data + "PHYS14_25_V2_L2Relative_AK4PFchs.txt");
+    _pset.addParameter<std::string>("MCL3JetPar", _data + "PHYS14_25_V2_L3Absolute_AK4PFchs.txt");
+    _pset.addParameter<std::string>("MCL1JetParAK8", _data + "PHYS14_25_V2_L1FastJet_AK8PFchs.txt");
+    _pset.addParameter<std::string>("MCL2JetParAK8", _data + "PHYS14_25_V2_L2Relative_AK8PFchs.txt");
+    _pset.addParameter<std::string>("MCL3JetParAK8", _data + "PHYS14_25_V2_L3Absolute_AK8PFchs.txt");
+    std::map<std::string, edm::ParameterSet const> _par;
+    _par.insert(std::pair<std::string, edm::ParameterSet const>("event_selector", _pset));
+    BenchSelector _selector;
+    _selector.BeginJob(_par);
+
+    // only the kernels are timed, not reading the events
+    Result _correct, _tag;
+    double _sink = 0.0;
+    int _nEvents = 0;
+    {
+      fwlite::Event _ev(_file);
+      edm::Handle<std::vector<pat::Jet> > _jets;
+      for (_ev.toBegin(); !_ev.atEnd() && _nEvents < maxEvents; ++_ev, ++_nEvents){
+        _ev.getByLabel(edm::InputTag("slimmedJets"), _jets);
+        Mark _t0 = Now();
+        for (unsigned int j = 0; j < _jets->size(); ++j) _sink += _selector.correctJet((*_jets)[j], _ev).Pt();
+        Mark _t1 = Now();
+        for (unsigned int j = 0; j < _jets->size(); ++j) _sink += _selector.isJetTagged((*_jets)[j], _ev);
+        Mark _t2 = Now();
+        _correct.Add(_t0, _t1, _jets->size());
+        _tag.Add(_t1, _t2, _jets->size());
+      }
+    }
+    delete _file;
+
+    out << "CorrectJet: " << _nEvents << " events, correctJet " << _correct.NsPerOp() << " ns/jet, "
+        << _correct.AllocsPerOp() << " allocs/jet; isJetTagged " << _tag.NsPerOp() << " ns/jet, "
+        << _tag.AllocsPerOp() << " allocs/jet"
+        << "  (checksum " << _sink << ")" << std::endl;
+    gResults["CorrectJet/correctJet"] = _correct;
+    gResults["CorrectJet/isJetTagged"] = _tag;
+
+    return 0;
+  }
+
+
+
+  //
+  //_____ baseline _________________________________________________
+  //
+  /// One line per kernel: name, ns/op, allocations/op
+  void WriteBaseline( std::string const & fileName ){
+    std::ofstream _file(fileName.c_str());
+    std::map<std::string, Result>::const_iterator iResult;
+    for (iResult = gResults.begin(); iResult != gResults.end(); ++iResult)
+      _file << iResult->first << " " << iResult->second.NsPerOp() << " " << iResult->second.AllocsPerOp() << "\n";
+    std::cout << "[ljmet-bench]: baseline written to " << fileName << std::endl;
+  }
+
+  /// Table of the results, compared with the baseline if there is one; returns the number of regressions
+  int CompareBaseline( std::string const & fileName, double tolerance, std::ostream & out ){
+    std::map<std::string, std::pair<double, double> > _baseline;
+    if (!fileName.empty()){
+      std::ifstream _file(fileName.c_str());
+      if (!_file){
+        out << "[ljmet-bench]: cannot read baseline " << fileName << std::endl;
+        return 1;
+      }
+      std::string _name;
+      double _ns, _allocs;
+      while (_file >> _name >> _ns >> _allocs) _baseline[_name] = std::make_pair(_ns, _allocs);
+    }
+
+    int _nRegressions = 0;
+    out << std::endl << std::left << std::setw(36) << "kernel" << std::right
+        << std::setw(14) << "ns/op" << std::setw(14) << "allocs/op";
+    if (!_baseline.empty()) out << std::setw(14) << "baseline" << std::setw(10) << "ratio";
+    out << std::endl;
+    std::map<std::string, Result>::const_iterator iResult;
+    for (iResult = gResults.begin(); iResult != gResults.end(); ++iResult){
+      double _ns = iResult->second.NsPerOp();
+      double _allocs = iResult->second.AllocsPerOp();
+      out << std::left << std::setw(36) << iResult->first << std::right
+          << std::setw(14) << _ns << std::setw(14) << _allocs;
+      std::map<std::string, std::pair<double, double> >::const_iterator iBase = _baseline.find(iResult->first);
+      if (iBase != _baseline.end()){
+        out << std::setw(14) << iBase->second.first << std::setw(10) << _ns/iBase->second.first;
+        // time is noisy, allocation counts are exact
+        bool _slower = _ns > (1.0 + tolerance)*iBase->second.first;
+        bool _moreAllocs = _allocs > iBase->second.second + 1.e-6;
+        if (_slower || _moreAllocs){
+          out << "  REGRESSION" << (_slower ? " time" : "") << (_moreAllocs ? " allocations" : "");
+          ++_nRegressions;
+        }
+      }
+      else if (!_baseline.empty()) out << std::setw(14) << "-";
+      out << std::endl;
+    }
+    return _nRegressions;
+  }
+
+}
+
+
+
+int main (int argc, char* argv[]) {
+  std::map<std::string, int (*)(std::ostream &)> benchmarks;
+  benchmarks["BTagWeight"] = &BenchBTagWeight;
+  benchmarks["BtagConditions"] = &BenchBtagConditions;
+  benchmarks["EventContent"] = &BenchEventContent;
+  benchmarks["EventShape"] = &BenchEventShape;
+  benchmarks["HitFitDriver"] = &BenchHitFitDriver;
+  benchmarks["METz"] = &BenchMETz;
+  benchmarks["Nsubjettiness"] = &BenchNsubjettiness;
+  benchmarks["PileUp"] = &BenchPileUp;
+  benchmarks["TopoVars"] = &BenchTopoVars;
+
+  std::string baseline, newBaseline;
+  double tolerance = 0.25;
+  std::vector<std::string> toRun;
+  for (int i = 1; i < argc; ++i){
+    std::string _arg = argv[i];
+    if (_arg.find("--baseline=") == 0) baseline = _arg.substr(11);
+    else if (_arg.find("--write-baseline=") == 0) newBaseline = _arg.substr(17);
+    else if (_arg.find("--tolerance=") == 0) tolerance = std::atof(_arg.substr(12).c_str());
+    else if (_arg.find("--input=") == 0) gInputFile = _arg.substr(8);
+    else toRun.push_back(_arg);
+  }
+  if (toRun.empty()){
+    std::map<std::string, int (*)(std::ostream &)>::const_iterator iBench;
+    for (iBench = benchmarks.begin(); iBench != benchmarks.end(); ++iBench) toRun.push_back(iBench->first);
+  }
+
+  // need LHAPDF grid files or events, run on request only
+  benchmarks["PdfWeights"] = &BenchPdfWeights;
+  benchmarks["CorrectJet"] = &BenchCorrectJet;
+
+  int nFailed = 0;
+  for (unsigned int i = 0; i < toRun.size(); ++i){
+    if (benchmarks.find(toRun[i]) == benchmarks.end()){
+      std::cout << "[ljmet-bench]: unknown benchmark " << toRun[i] << std::endl;
+      ++nFailed;
+      continue;
+    }
+    nFailed += benchmarks[toRun[i]](std::cout);
+  }
+
+  nFailed += CompareBaseline(baseline, tolerance, std::cout);
+  if (!newBaseline.empty()) WriteBaseline(newBaseline);
+
+  return nFailed == 0 ? 0 : 1;
+}
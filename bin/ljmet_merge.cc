@@ -0,0 +1,405 @@
+//
+// Merge ljmet output files
+//
+// Merges the output tree, the histogram directories (histos and the
+// module directories) and the cut flow in the .log file next to each
+// input. Tree baskets are copied without recompression whenever the
+// inputs are compatible (TTree fast cloning).
+//
+// Reader threads open the inputs ahead of the copy, check their
+// branches and read their histograms and cut flows. The trees are
+// fast-copied straight into the output in the order of the input list,
+// each entry is written once. All inputs must have the same branches.
+//
+// usage: ljmet-merge [-j threads] [-t treeName] output.root input.root ... | @fileList
+//
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TClass.h"
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TKey.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+
+
+namespace {
+
+  std::string legend = "[ljmet-merge]: ";
+
+  /// Histograms by path, in the order they are first seen
+  struct HistSum {
+    std::vector<std::string> paths;
+    std::map<std::string, TH1 *> hists;
+
+    void Add( std::string const & path, TH1 const * h ){
+      std::map<std::string, TH1 *>::iterator _it = hists.find(path);
+      if (_it == hists.end()){
+        TH1 * _h = (TH1 *)h->Clone();
+        _h->SetDirectory(0);
+        hists[path] = _h;
+        paths.push_back(path);
+      }
+      else _it->second->Add(h);
+    }
+
+    void Add( HistSum const & other ){
+      for (unsigned int i = 0; i < other.paths.size(); ++i) Add(other.paths[i], other.hists.find(other.paths[i])->second);
+    }
+
+    ~HistSum(){
+      for (std::map<std::string, TH1 *>::iterator _it = hists.begin(); _it != hists.end(); ++_it) delete _it->second;
+    }
+  };
+
+  /// Cut flow as printed by Selector::print, "off" cuts have count -1
+  struct CutFlow {
+    std::vector<std::string> names;
+    std::vector<long> counts;
+    int nLogs;
+    int nMissing;
+    bool consistent;
+
+    CutFlow() : nLogs(0), nMissing(0), consistent(true) {}
+
+    void Add( std::vector<std::string> const & _names, std::vector<long> const & _counts ){
+      if (nLogs == 0){
+        names = _names;
+        counts.assign(names.size(), 0);
+      }
+      ++nLogs;
+      if (_names != names){
+        consistent = false;
+        return;
+      }
+      for (unsigned int i = 0; i < names.size(); ++i){
+        if (_counts[i] < 0 || counts[i] < 0) counts[i] = -1;
+        else counts[i] += _counts[i];
+      }
+    }
+
+    void Add( CutFlow const & other ){
+      if (other.nLogs == 0){
+        nMissing += other.nMissing;
+        return;
+      }
+      int _nLogs = nLogs;
+      Add(other.names, other.counts);
+      nLogs = _nLogs + other.nLogs;
+      nMissing += other.nMissing;
+      consistent = consistent && other.consistent;
+    }
+
+    void Print( std::ostream & out ) const {
+      for (unsigned int i = 0; i < names.size(); ++i){
+        char buff[1000];
+        if (counts[i] >= 0) sprintf(buff, "%6u : %20s %10ld", i, names[i].c_str(), counts[i]);
+        else sprintf(buff, "%6u : %20s %10s", i, names[i].c_str(), "off");
+        out << buff << std::endl;
+      }
+    }
+  };
+
+  bool ReadCutFlow( std::string const & logName, CutFlow & cutFlow ){
+    std::ifstream _log(logName.c_str());
+    if (!_log) return false;
+    std::vector<std::string> _names;
+    std::vector<long> _counts;
+    std::string _line;
+    while (std::getline(_log, _line)){
+      // "     0 :         No selection      12345"
+      size_t _colon = _line.find(" : ");
+      if (_colon == std::string::npos) continue;
+      std::string _index = _line.substr(0, _colon);
+      if (_index.find_first_not_of(" 0123456789") != std::string::npos) continue;
+      std::string _rest = _line.substr(_colon + 3);
+      size_t _last = _rest.find_last_not_of(" ");
+      if (_last == std::string::npos) continue;
+      size_t _sep = _rest.find_last_of(" ", _last);
+      if (_sep == std::string::npos) continue;
+      std::string _count = _rest.substr(_sep + 1, _last - _sep);
+      std::string _name = _rest.substr(0, _sep);
+      _name = _name.substr(std::min(_name.size(), _name.find_first_not_of(" ")));
+      _name = _name.substr(0, _name.find_last_not_of(" ") + 1);
+      _names.push_back(_name);
+      _counts.push_back(_count == "off" ? -1 : std::atol(_count.c_str()));
+    }
+    if (_names.empty()) return false;
+    cutFlow.Add(_names, _counts);
+    return true;
+  }
+
+  std::string LogName( std::string const & rootName ){
+    std::string _base = rootName;
+    if (_base.size() > 5 && _base.substr(_base.size() - 5) == ".root") _base.erase(_base.size() - 5);
+    return _base + ".log";
+  }
+
+  /// Branch names and leaf types, to check that inputs agree
+  std::vector<std::string> Schema( TTree * tree ){
+    std::vector<std::string> _schema;
+    TObjArray * _leaves = tree->GetListOfLeaves();
+    for (int i = 0; i < _leaves->GetEntriesFast(); ++i){
+      TLeaf * _leaf = (TLeaf *)_leaves->At(i);
+      _schema.push_back(std::string(_leaf->GetBranch()->GetName()) + " " + _leaf->GetName() + " " + _leaf->GetTypeName());
+    }
+    std::sort(_schema.begin(), _schema.end());
+    return _schema;
+  }
+
+  void CollectHists( TDirectory * dir, std::string const & path, std::string const & treeName, HistSum & sum ){
+    TIter _next(dir->GetListOfKeys());
+    TKey * _key;
+    std::string _last;
+    while ((_key = (TKey *)_next())){
+      // only the highest cycle of each object
+      if (_last == _key->GetName()) continue;
+      _last = _key->GetName();
+      std::string _path = path.empty() ? _last : path + "/" + _last;
+      TClass * _class = TClass::GetClass(_key->GetClassName());
+      if (!_class) continue;
+      if (_class->InheritsFrom(TDirectory::Class())){
+        CollectHists((TDirectory *)_key->ReadObj(), _path, treeName, sum);
+      }
+      else if (_class->InheritsFrom(TH1::Class())){
+        TH1 * _h = (TH1 *)_key->ReadObj();
+        sum.Add(_path, _h);
+        delete _h;
+      }
+      else if (!(path.empty() && _last == treeName)){
+        std::cout << legend << "skipping " << _path << " (" << _key->GetClassName() << ")" << std::endl;
+      }
+    }
+  }
+
+  /// One input, opened and read ahead by a reader thread
+  struct Input {
+    std::string name;
+    TFile * file;
+    TTree * tree;
+    std::vector<std::string> schema;
+    HistSum hists;
+    CutFlow cutFlow;
+    std::string error;
+    bool ready;
+
+    Input() : file(0), tree(0), ready(false) {}
+  };
+
+  /// Open the inputs in order, at most maxAhead beyond the one being copied
+  struct Reader {
+    std::vector<Input> * inputs;
+    std::string treeName;
+    unsigned int maxAhead;
+    std::atomic<unsigned int> next;
+    unsigned int copied;
+    bool abort;
+    std::mutex mutex;
+    std::condition_variable readyCond;
+    std::condition_variable copiedCond;
+
+    void Run(){
+      for (unsigned int i = next++; i < inputs->size(); i = next++){
+        {
+          std::unique_lock<std::mutex> _lock(mutex);
+          while (!abort && i >= copied + maxAhead) copiedCond.wait(_lock);
+          if (abort) return;
+        }
+        Open((*inputs)[i]);
+        {
+          std::lock_guard<std::mutex> _lock(mutex);
+          (*inputs)[i].ready = true;
+        }
+        readyCond.notify_all();
+      }
+    }
+
+    void Open( Input & input ){
+      input.file = TFile::Open(input.name.c_str(), "READ");
+      if (!input.file || input.file->IsZombie()){
+        input.error = "cannot open " + input.name;
+        return;
+      }
+      input.tree = (TTree *)input.file->Get(treeName.c_str());
+      if (!input.tree){
+        input.error = "no tree " + treeName + " in " + input.name;
+        return;
+      }
+      input.schema = Schema(input.tree);
+      CollectHists(input.file, "", treeName, input.hists);
+      if (!ReadCutFlow(LogName(input.name), input.cutFlow)) ++input.cutFlow.nMissing;
+    }
+
+    /// Wait until input i is open
+    Input & Wait( unsigned int i ){
+      std::unique_lock<std::mutex> _lock(mutex);
+      while (!(*inputs)[i].ready) readyCond.wait(_lock);
+      return (*inputs)[i];
+    }
+
+    void Done( unsigned int i, bool ok ){
+      {
+        std::lock_guard<std::mutex> _lock(mutex);
+        copied = i + 1;
+        if (!ok) abort = true;
+      }
+      copiedCond.notify_all();
+    }
+
+    void Abort(){
+      {
+        std::lock_guard<std::mutex> _lock(mutex);
+        abort = true;
+      }
+      copiedCond.notify_all();
+    }
+  };
+
+  void Close( Input & input ){
+    if (input.file) input.file->Close();
+    delete input.file;
+    input.file = 0;
+    input.tree = 0;
+  }
+
+  void WriteHists( TFile * file, HistSum const & sum ){
+    for (unsigned int i = 0; i < sum.paths.size(); ++i){
+      std::string const & _path = sum.paths[i];
+      TDirectory * _dir = file;
+      size_t _start = 0, _slash;
+      while ((_slash = _path.find('/', _start)) != std::string::npos){
+        std::string _sub = _path.substr(_start, _slash - _start);
+        TDirectory * _next = _dir->GetDirectory(_sub.c_str());
+        _dir = _next ? _next : _dir->mkdir(_sub.c_str());
+        _start = _slash + 1;
+      }
+      _dir->cd();
+      sum.hists.find(_path)->second->Write(_path.substr(_start).c_str());
+    }
+  }
+
+}
+
+
+
+int main (int argc, char* argv[]) {
+  unsigned int nThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::string treeName = "ljmet";
+  std::string output;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; ++i){
+    std::string _arg = argv[i];
+    if (_arg == "-j" && i + 1 < argc) nThreads = std::max(1, std::atoi(argv[++i]));
+    else if (_arg == "-t" && i + 1 < argc) treeName = argv[++i];
+    else if (output.empty()) output = _arg;
+    else if (_arg[0] == '@'){
+      std::ifstream _list(_arg.substr(1).c_str());
+      std::string _line;
+      while (_list >> _line) inputs.push_back(_line);
+    }
+    else inputs.push_back(_arg);
+  }
+  if (output.empty() || inputs.empty()){
+    std::cout << "usage: " << argv[0] << " [-j threads] [-t treeName] output.root input.root ... | @fileList" << std::endl;
+    return 1;
+  }
+
+  ROOT::EnableThreadSafety();
+  TH1::AddDirectory(false);
+
+  std::vector<Input> _inputs(inputs.size());
+  for (unsigned int i = 0; i < inputs.size(); ++i) _inputs[i].name = inputs[i];
+
+  // readers open the inputs ahead, the trees are fast-copied here in input order
+  unsigned int _nReaders = std::min<size_t>(nThreads, inputs.size());
+  Reader _reader;
+  _reader.inputs = &_inputs;
+  _reader.treeName = treeName;
+  _reader.maxAhead = 2*_nReaders;
+  _reader.next = 0;
+  _reader.copied = 0;
+  _reader.abort = false;
+  std::cout << legend << "merging " << inputs.size() << " files, " << _nReaders << " reader threads" << std::endl;
+  std::vector<std::thread> _threads;
+  for (unsigned int r = 0; r < _nReaders; ++r) _threads.push_back(std::thread(&Reader::Run, &_reader));
+
+  TFile * _outFile = TFile::Open(output.c_str(), "RECREATE");
+  bool _ok = _outFile && !_outFile->IsZombie();
+  if (!_ok) std::cout << legend << "cannot create " << output << std::endl;
+  TTree * _outTree = 0;
+  HistSum _hists;
+  CutFlow _cutFlow;
+  Long64_t _nEntries = 0;
+  for (unsigned int i = 0; _ok && i < _inputs.size(); ++i){
+    Input & _in = _reader.Wait(i);
+    if (!_in.error.empty()){
+      std::cout << legend << _in.error << std::endl;
+      _ok = false;
+    }
+    else if (_in.schema != _inputs[0].schema){
+      std::cout << legend << "branches of " << _in.name << " differ from " << _inputs[0].name << std::endl;
+      _ok = false;
+    }
+    else {
+      _outFile->cd();
+      if (!_outTree) _outTree = _in.tree->CloneTree(0);
+      _outTree->CopyEntries(_in.tree, -1, "fast");
+      _outTree->ResetBranchAddresses();
+      _nEntries += _in.tree->GetEntries();
+      _hists.Add(_in.hists);
+      _cutFlow.Add(_in.cutFlow);
+    }
+    Close(_in);
+    _reader.Done(i, _ok);
+  }
+  if (!_ok) _reader.Abort();
+  for (unsigned int r = 0; r < _threads.size(); ++r) _threads[r].join();
+  for (unsigned int i = 0; i < _inputs.size(); ++i) Close(_inputs[i]);
+
+  if (_outTree){
+    _outFile->cd();
+    _outTree->Write();
+  }
+  if (_outFile) _outFile->Close();
+  delete _outFile;
+  if (!_ok){
+    std::remove(output.c_str());
+    return 1;
+  }
+
+  _outFile = TFile::Open(output.c_str(), "UPDATE");
+  WriteHists(_outFile, _hists);
+  _outFile->Close();
+  delete _outFile;
+
+  std::cout << legend << _nEntries << " entries, " << _hists.paths.size() << " histograms" << std::endl;
+
+  // merged cut flow, in the format of the ljmet log
+  if (_cutFlow.nMissing > 0) std::cout << legend << "no cut flow in the log of " << _cutFlow.nMissing << " inputs" << std::endl;
+  if (!_cutFlow.consistent) std::cout << legend << "inputs have different cuts, cut flow not merged" << std::endl;
+  else if (_cutFlow.nLogs > 0){
+    std::ofstream _log(LogName(output).c_str());
+    _cutFlow.Print(_log);
+    std::cout << legend << "Selection, " << _cutFlow.nLogs << " jobs" << std::endl;
+    _cutFlow.Print(std::cout);
+  }
+
+  return 0;
+}
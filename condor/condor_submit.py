@@ -7,6 +7,7 @@ import fileinput
 import getopt
 import subprocess
 import socket
+import job_split
 files_per_job = 5
 
 #Absolute path that precedes '/store...'
@@ -40,7 +41,8 @@ else:
 #Configuration options parsed from arguments
 #Switching to getopt for compatibility with older python
 try:
-    opts, args = getopt.getopt(sys.argv[1:], "", ["useMC=", "sample=","dataType=","fileList=", "outDir=","submit=","json=","jec="])
+    opts, args = getopt.getopt(sys.argv[1:], "", ["useMC=", "sample=","dataType=","fileList=", "outDir=","submit=","json=","jec=",
+                                                  "filesPerJob=","njobs=","jobHours=","eventCost=","calibrate=","readRate="])
 except getopt.GetoptError as err:
     print str(err)
     sys.exit(1)
@@ -54,6 +56,13 @@ json     = str('None')
 submit   = bool(False)
 jec      = str('Total')
 changeJEC= bool(False)
+# job splitting: fixed number of files per job, or jobs of equal predicted runtime
+byFiles  = bool(False)
+njobs    = 0
+jobHours = 0.0
+eventCost= 0.0
+calibrationEvents = 0
+readRate = 20.e6
 
 for o, a in opts:
     print o, a
@@ -76,6 +85,14 @@ for o, a in opts:
 	prefix = jec
     elif o == "--submit":
         if a == 'True':     submit = True
+    elif o == "--filesPerJob":
+        files_per_job = int(a)
+        byFiles = True
+    elif o == "--njobs":     njobs = int(a)
+    elif o == "--jobHours":  jobHours = float(a)
+    elif o == "--eventCost": eventCost = float(a)
+    elif o == "--calibrate": calibrationEvents = int(a)
+    elif o == "--readRate":  readRate = float(a)*1.e6
 
 if dataType == 'MuEl': dataType = 'ElMu'
 checkDataType = dataType in ['ElEl', 'ElMu', 'MuMu']
@@ -107,65 +124,92 @@ if os.path.exists(dir):
     sys.exit(1)
 else: os.makedirs(dir)
 
-def get_input(num, list):
+def file_url(name):
+    url = sePath[1:]
+    if (name[:6]=='/store'):
+        url = url + storePath
+    return url + name
+
+def get_input(names):
     result = ''
-    file_list = open(files)
-    file_count = 0
-    for line in file_list:
-        if line.find('root')>0:
-            file_count=file_count+1
-            if file_count>(num-1) and file_count<(num+files_per_job):
-                result=result+ sePath
-		if (line.strip()[:6]=='/store'):
-		    result=result+ storePath
-                result=result+line.strip()+'\',\n'
-    file_list.close()
+    for name in names:
+        result = result + '\'' + file_url(name) + '\',\n'
     return result
 
-j = 1
-nfiles = 1
-
-py_file = open(dir+"/"+prefix+"_"+str(j)+".py","w")
-
-print 'CONDOR work dir: '+dir
-
-count = 0
-file_list = open(files)
-for line in file_list:
-    if line.find('.root')>0:
-        count = count + 1
-
-file_list.close()
-        
-int_file = open(dir+'/'+'interactive.csh','w')
-
-while ( nfiles <= count ):    
-
+def make_config(config_name, names, skipEvents, nEvents, outFile):
     # ADD YOUR CONFIG FILE HERE!!
     py_templ_file = open(relBase+'/src/LJMet/Com/condor/ljmet_cfg.py')
-    
-    py_file = open(dir+'/'+prefix+'_'+str(j)+'.py','w')
-
+    py_file = open(config_name,'w')
     #Avoid calling the get_input function once per line in template
-    singleFileList = get_input(nfiles, files)
-    
+    singleFileList = get_input(names)
     for line in py_templ_file:
         line=line.replace('CONDOR_ISMC',     useMC)
         line=line.replace('CONDOR_DATATYPE', dataType)
         line=line.replace('CONDOR_RELBASE',  relBase)
         line=line.replace('CONDOR_JSON',     json)
         line=line.replace('CONDOR_FILELIST', singleFileList)
-        line=line.replace('CONDOR_OUTFILE',  prefix+'_'+str(j))
+        line=line.replace('CONDOR_SKIPEVENTS', str(skipEvents))
+        line=line.replace('CONDOR_NEVENTS',  str(nEvents))
+        line=line.replace('CONDOR_OUTFILE',  outFile)
         if (changeJEC): line=line.replace('Total',  jec)
         py_file.write(line)
     py_file.close()
+    py_templ_file.close()
+
+print 'CONDOR work dir: '+dir
+
+inputFiles = []
+file_list = open(files)
+for line in file_list:
+    if line.find('.root')>0:
+        inputFiles.append(line.strip())
+file_list.close()
+
+# list of jobs, each (input files, skipEvents, nEvents)
+jobs = []
+if byFiles:
+    for first in range(0, len(inputFiles), files_per_job):
+        jobs.append((inputFiles[first:first+files_per_job], 0, -1))
+else:
+    index = job_split.build_index(inputFiles, files+'.index', file_url)
+    if calibrationEvents > 0:
+        calibrationFile = [f for f in inputFiles if index[f][0] > 0][0]
+        eventCost = job_split.calibrate(lambda name, n: make_config(name, [calibrationFile], 0, n, os.path.basename(name)[:-3]),
+                                        min(calibrationEvents, index[calibrationFile][0]), dir)
+    if eventCost <= 0:
+        eventCost = 0.05
+        print 'No --eventCost or --calibrate given, assuming', eventCost, 's/event'
+    if njobs <= 0 and jobHours > 0:
+        total = sum([job_split.file_cost(index[f][0], index[f][1], eventCost, readRate, 2.0) for f in inputFiles])
+        njobs = int(total/(3600.*jobHours)) + 1
+    if njobs <= 0:
+        njobs = (len(inputFiles) + files_per_job - 1)/files_per_job
+    summary = open(dir+'/jobs.txt','w')
+    summary.write('# job  predicted_s  skipEvents  nEvents  files\n')
+    j = 1
+    for job in job_split.split(inputFiles, index, njobs, eventCost, readRate):
+        skipEvents, nEvents = job_split.job_range(job, index)
+        jobs.append(([name for name, first, n in job], skipEvents, nEvents))
+        summary.write('%d %.0f %d %d %s\n' % (j, job_split.predicted_cost(job, index, eventCost, readRate),
+                                               skipEvents, nEvents, ' '.join(jobs[-1][0])))
+        j = j + 1
+    summary.close()
+    print 'Split', len(inputFiles), 'files into', len(jobs), 'jobs of equal predicted runtime, see', dir+'/jobs.txt'
+    if len([job for job in jobs if job[2] != -1]) > 0 and open(relBase+'/src/LJMet/Com/condor/ljmet_cfg.py').read().find('CONDOR_SKIPEVENTS') < 0:
+        print 'Jobs read parts of files, but the config template has no CONDOR_SKIPEVENTS/CONDOR_NEVENTS. Use --filesPerJob'
+        sys.exit(1)
+
+int_file = open(dir+'/'+'interactive.csh','w')
+
+j = 1
+for names, skipEvents, nEvents in jobs:
+
+    make_config(dir+'/'+prefix+'_'+str(j)+'.py', names, skipEvents, nEvents, prefix+'_'+str(j))
 
     if (j == 1): int_file.write('date >  xtimelog.txt; ljmet '+prefix+'_'+str(j)+'.py >& out'+str(j)+'.txt\n')
     else:        int_file.write('date >> xtimelog.txt; ljmet '+prefix+'_'+str(j)+'.py >& out'+str(j)+'.txt\n')
         
     j = j + 1
-    nfiles = nfiles + files_per_job
-    py_templ_file.close()
 
 int_file.write('date')
 int_file.close()
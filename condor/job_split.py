@@ -0,0 +1,173 @@
+#!/usr/bin/env python
+#########################################################################
+#
+# job_split.py
+#
+# Cost-balanced splitting of an input file list into condor jobs
+# - index of entries and bytes per input file, built once and kept next
+#   to the file list (<fileList>.index)
+# - per-event cost from a short local calibration run of ljmet
+# - contiguous packing of files and entry ranges into jobs of equal
+#   predicted runtime
+#
+# Predicted runtime of a file:
+#   openCost + bytes/readRate + entries*eventCost
+# shared among the jobs that read it in proportion to their entries
+#
+# A job is a list of (file, first entry, number of entries); only its
+# first file can start and only its last file can end inside the file,
+# so every job maps onto ljmet's skipEvents/nEvents.
+#
+#########################################################################
+
+
+
+import os
+import subprocess
+import sys
+import time
+
+
+
+legend = '[job_split]:'
+
+
+
+def read_index(index_name):
+    index = {}
+    for line in open(index_name):
+        fields = line.split()
+        if len(fields) != 3: continue
+        index[fields[0]] = (int(fields[1]), int(fields[2]))
+    return index
+
+
+
+def build_index(file_names, index_name, file_url = lambda name: name, tree_name = 'Events'):
+    """
+    Number of entries and bytes of every input file. Entries already in
+    index_name are reused, new files are opened with ROOT and appended.
+    """
+    index = {}
+    if os.path.isfile(index_name): index = read_index(index_name)
+
+    missing = [f for f in file_names if f not in index]
+    if len(missing) > 0:
+        import ROOT
+        print legend, 'indexing', len(missing), 'input files'
+        index_file = open(index_name, 'a')
+        for name in missing:
+            root_file = ROOT.TFile.Open(file_url(name))
+            if not root_file or root_file.IsZombie():
+                print legend, 'cannot open', file_url(name)
+                sys.exit(1)
+            tree = root_file.Get(tree_name)
+            entries = 0
+            if tree: entries = int(tree.GetEntries())
+            index[name] = (entries, int(root_file.GetSize()))
+            root_file.Close()
+            # one line per file, so an interrupted indexing run is resumed
+            index_file.write('%s %d %d\n' % (name, index[name][0], index[name][1]))
+            index_file.flush()
+        index_file.close()
+
+    return index
+
+
+
+def calibrate(make_config, n_events, work_dir):
+    """
+    Seconds per event of the configured selector and calculators.
+    Runs ljmet locally on n_events/10 and n_events events of the first
+    input file; the difference removes the job startup time.
+    """
+    times = []
+    for n in [max(1, n_events/10), n_events]:
+        config = os.path.join(work_dir, 'calibration_%d.py' % n)
+        make_config(config, n)
+        log = open(os.path.join(work_dir, 'calibration_%d.txt' % n), 'w')
+        start = time.time()
+        status = subprocess.call(['ljmet', os.path.basename(config)], stdout = log, stderr = subprocess.STDOUT, cwd = work_dir)
+        times.append(time.time() - start)
+        log.close()
+        if status != 0:
+            print legend, 'calibration run failed, see', log.name
+            sys.exit(1)
+    cost = max(times[1] - times[0], 0.0)/(n_events - max(1, n_events/10))
+    print legend, 'calibration: %.3g s/event, %.3g s startup' % (cost, times[0])
+    return cost
+
+
+
+def file_cost(entries, size, event_cost, read_rate, open_cost):
+    return open_cost + size/read_rate + entries*event_cost
+
+
+
+def split(file_names, index, n_jobs, event_cost, read_rate = 20.e6, open_cost = 2.0):
+    """
+    Split the files into n_jobs contiguous jobs of equal predicted runtime.
+    Returns a list of jobs, each a list of (file, first entry, n entries).
+    """
+    # cost per entry of each file, including its share of reading the file
+    pieces = []
+    total = 0.0
+    for name in file_names:
+        entries, size = index[name]
+        cost = file_cost(entries, size, event_cost, read_rate, open_cost)
+        pieces.append((name, entries, cost))
+        total += cost
+
+    target = total/max(n_jobs, 1)
+    jobs = [[]]
+    job_cost = 0.0
+    for name, entries, cost in pieces:
+        if entries == 0:
+            jobs[-1].append((name, 0, 0))
+            job_cost += cost
+            continue
+        per_entry = cost/entries
+        first = 0
+        while first < entries:
+            last_job = len(jobs) >= n_jobs
+            room = target - job_cost
+            take = entries - first
+            # the rest of the file does not fit: split it at the event that fills the job
+            if not last_job and take*per_entry > room + 0.5*per_entry:
+                take = int(room/per_entry + 0.5)
+            if take > 0:
+                jobs[-1].append((name, first, take))
+                job_cost += take*per_entry
+                first += take
+            if not last_job and job_cost >= target - 0.5*per_entry:
+                jobs.append([])
+                job_cost = 0.0
+
+    if len(jobs[-1]) == 0: jobs.pop()
+    return jobs
+
+
+
+def job_range(job, index):
+    """
+    skipEvents and nEvents of a job for ljmet, which counts the skipped
+    events towards nEvents. (0, -1) if the job takes whole files.
+    """
+    skip = job[0][1]
+    count = sum([n for name, first, n in job])
+    last_name, last_first, last_n = job[-1]
+    if skip == 0 and last_first + last_n == index[last_name][0]:
+        return 0, -1
+    return skip, skip + count
+
+
+
+def predicted_cost(job, index, event_cost, read_rate = 20.e6, open_cost = 2.0):
+    cost = 0.0
+    for name, first, n in job:
+        entries, size = index[name]
+        if entries == 0:
+            cost += file_cost(0, size, event_cost, read_rate, open_cost)
+        else:
+            cost += file_cost(entries, size, event_cost, read_rate, open_cost)*n/float(entries)
+    return cost
@@ -138,6 +138,8 @@ process.event_selector = cms.PSet(
     JERdown                  = cms.bool(False),
     JEC_txtfile = cms.string(relBase+'/src/LJMet/singleLepton/JEC/Summer13_V5_DATA_UncertaintySources_AK5PF.txt'),
     doNewJEC                 = cms.bool(False),
+    # binary cache of the JEC text files made by ljmet-jec-compile, empty to parse the text files
+    JEC_cache                = cms.string(''),
     doLepJetCleaning         = cms.bool(True),
     
     MCL1JetPar               = cms.string(relBase+'/src/LJMet/Com/data/PHYS14_25_V2_L1FastJet_AK4PFchs.txt'),
@@ -161,10 +163,19 @@ process.event_selector = cms.PSet(
 #
 
 process.inputs = cms.PSet (
-    nEvents    = cms.int32(-1),
-    skipEvents = cms.int32(0),
+    nEvents    = cms.int32(CONDOR_NEVENTS),
+    skipEvents = cms.int32(CONDOR_SKIPEVENTS),
     lumisToProcess = CfgTypes.untracked(CfgTypes.VLuminosityBlockRange()),
-    fileNames  = cms.vstring(CONDOR_FILELIST)
+    fileNames  = cms.vstring(CONDOR_FILELIST),
+    # rerun only the calculators on the events selected by an earlier job on these files
+    #selectionCache = cms.untracked.string('CONDOR_OUTFILE.selection.root'),
+    # cache only the input branches read in the first events, or those listed in branches
+    learnBranches = cms.untracked.int32(100),
+    #branches = cms.untracked.vstring('recoVertexs_offlineSlimmedPrimaryVertices_*', 'patJets_slimmedJets_*'),
+    #cacheSize = cms.untracked.int32(20*1024*1024),
+    # open the next input files in the background, their caches share prefetchMemory MB
+    prefetchFiles = cms.untracked.int32(2),
+    prefetchMemory = cms.untracked.int32(512),
     )
 
 
@@ -182,6 +193,10 @@ if (not process.ljmet.isMc==cms.bool(True)):
 process.outputs = cms.PSet (
     outputName = cms.string('CONDOR_OUTFILE'),
     treeName   = cms.string('ljmet'),
+    # write the output and a resume point every this many events, 0 for never
+    checkpointEvents = cms.untracked.int32(20000),
+    # write CONDOR_OUTFILE.selection.root for calculator-only reruns
+    selectionCache = cms.untracked.bool(False),
     )
 
 
@@ -0,0 +1,145 @@
+#ifndef BTAGTAGCOUNTS_H
+#define BTAGTAGCOUNTS_H
+
+/*
+  Probability distribution of the number of tagged jets per operating point
+
+  Same per-jet probabilities as the tag configuration enumeration in
+  BTagWeight: operating points are ordered loose to tight, and each jet
+  is tagged by the s loosest of them, s = 0..nTaggers. Instead of
+  enumerating all (nTaggers+1)^njets configurations, the joint
+  distribution of the tag counts is built up jet by jet. This costs
+  O(njets x nStates x nTaggers) with nStates = (njets+1)^nTaggers.
+
+  Any filter on the tag counts (the BTagWeight Filter classes) can then
+  be evaluated on the same distribution without touching the jets again.
+*/
+
+#include <algorithm>
+#include <vector>
+
+
+
+class BTagTagCounts
+{
+ public:
+
+  BTagTagCounts(unsigned int nTaggers) : taggers(nTaggers), njets(0) {}
+
+  /// Build the distribution, jets[j][k] has eff and sf of operating point k
+  template <class JetInfo> void Fill(const std::vector<std::vector<JetInfo> > & jets);
+
+  /// data/MC weight for the tag configurations accepted by Filter::filter
+  template <class Filter> float weight() const { return weight(&Filter::filter); }
+
+  /// data/MC weight for the tag configurations accepted by filter(tags)
+  template <class Predicate> float weight(Predicate filter) const;
+
+ private:
+
+  unsigned int taggers;
+  unsigned int njets;
+  unsigned int nStates;
+  // states are tag counts t[k], index = sum_k t[k]*(njets+1)^k
+  std::vector<unsigned int> stride;
+  std::vector<double> pMC;
+  std::vector<double> pData;
+  std::vector<double> nextMC;
+  std::vector<double> nextData;
+  mutable std::vector<int> tags;
+};
+
+
+
+template <class JetInfo> void BTagTagCounts::Fill(const std::vector<std::vector<JetInfo> > & jets)
+{
+  njets = jets.size();
+
+  // index offset of a jet in state s: t[0..s-1] go up by one
+  stride.assign(taggers+1, 0);
+  unsigned int _pow = 1;
+  for(size_t k=0;k<taggers;k++)
+    {
+      stride[k+1] = stride[k] + _pow;
+      _pow *= njets+1;
+    }
+  nStates = _pow;
+
+  pMC.assign(nStates, 0.);
+  pData.assign(nStates, 0.);
+  nextMC.resize(nStates);
+  nextData.resize(nStates);
+  pMC[0] = 1.;
+  pData[0] = 1.;
+
+  std::vector<float> stateMc(taggers+1), stateData(taggers+1);
+  unsigned int reach = 1; // states above this are not populated yet
+  for(size_t j=0;j<njets;j++)
+    {
+      // per-jet probabilities of each state, as in BTagWeight::weight
+      stateMc[0] = 1.-jets[j][0].eff;
+      stateData[0] = 1.-jets[j][0].eff*jets[j][0].sf;
+      for(size_t s=1;s<=taggers;s++)
+	{
+	  int k=s-1;
+	  float tagMc=jets[j][k].eff;
+	  float tagData=jets[j][k].eff*jets[j][k].sf;
+	  if(s<taggers)
+	    {
+	      int k1=s;
+	      tagMc*=1-jets[j][k1].eff/jets[j][k].eff;
+	      tagData*=1-jets[j][k1].eff/jets[j][k].eff*jets[j][k1].sf/jets[j][k].sf;
+	    }
+	  stateMc[s]=tagMc;
+	  stateData[s]=tagData;
+	}
+
+      unsigned int newReach = reach + stride[taggers];
+      std::fill(nextMC.begin(), nextMC.begin()+newReach, 0.);
+      std::fill(nextData.begin(), nextData.begin()+newReach, 0.);
+      for(size_t s=0;s<=taggers;s++)
+	{
+	  double * _mc = &nextMC[stride[s]];
+	  double * _data = &nextData[stride[s]];
+	  double _pMc = stateMc[s], _pData = stateData[s];
+	  for(unsigned int i=0;i<reach;i++)
+	    {
+	      _mc[i] += pMC[i]*_pMc;
+	      _data[i] += pData[i]*_pData;
+	    }
+	}
+      reach = newReach;
+      pMC.swap(nextMC);
+      pData.swap(nextData);
+    }
+}
+
+
+
+template <class Predicate> float BTagTagCounts::weight(Predicate filter) const
+{
+  if(njets==0) return 0.;
+
+  double _pMC=0, _pData=0;
+  tags.assign(taggers, 0);
+  for(unsigned int i=0;i<nStates;i++)
+    {
+      if(pMC[i]==0 && pData[i]==0) continue;
+      unsigned int _rest=i;
+      for(size_t k=0;k<taggers;k++)
+	{
+	  tags[k] = _rest % (njets+1);
+	  _rest /= njets+1;
+	}
+      if(filter(tags))
+	{
+	  _pMC+=pMC[i];
+	  _pData+=pData[i];
+	}
+    }
+  if(_pMC==0) return 0;
+  return _pData/_pMC;
+}
+
+
+#endif
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <math.h>
 #include <vector>
+#include "LJMet/Com/interface/BTagTagCounts.h"
 using namespace std; 
 
 
@@ -17,12 +18,22 @@ class BTagWeight
     int tag;
   };
 
- BTagWeight(unsigned int nTaggers) : taggers(nTaggers) {}
+ BTagWeight(unsigned int nTaggers) : taggers(nTaggers), counts(nTaggers) {}
    
   // virtual bool filter(vector<int> tags);
-  template <class Filter> float weight(vector<vector<JetInfo> > jets);
+  /// Event weight for the tag configurations accepted by Filter
+  template <class Filter> float weight(const vector<vector<JetInfo> > & jets);
+
+  /// Compute the tag count distribution once, then evaluate
+  /// any number of filters on it with weight<Filter>()
+  void setJets(const vector<vector<JetInfo> > & jets) { counts.Fill(jets); }
+  template <class Filter> float weight() const { return counts.weight<Filter>(); }
+
+  /// Reference: enumerate all (nTaggers+1)^njets tag configurations
+  template <class Filter> float weightBruteForce(const vector<vector<JetInfo> > & jets);
  private:
   unsigned int taggers;
+  BTagTagCounts counts;
 
 };
 
@@ -33,7 +44,7 @@ class BTagWeight
 class BTag1MediumFilter
 {
  public:
-  static bool filter(std::vector<int> t)
+  static bool filter(const std::vector<int> & t)
   {
     return t[0] == 1;
   }
@@ -44,7 +55,7 @@ class BTag1MediumFilter
 class BTag0MediumFilter
 {
  public:
-  static bool filter(std::vector<int> t)
+  static bool filter(const std::vector<int> & t)
   {
     return t[0] == 0;
   }
@@ -55,7 +66,7 @@ class BTag0MediumFilter
 class BTag2MediumFilter
 {
  public:
-  static bool filter(std::vector<int> t)
+  static bool filter(const std::vector<int> & t)
   {
     return t[0] == 2;
   }
@@ -66,7 +77,7 @@ class BTag2MediumFilter
 class BTagGE1MediumFilter
 {
  public:
-  static bool filter(std::vector<int> t)
+  static bool filter(const std::vector<int> & t)
   {
     return t[0] >= 1;
   }
@@ -77,7 +88,7 @@ class BTagGE1MediumFilter
 class BTagGE2MediumFilter
 {
  public:
-  static bool filter(std::vector<int> t)
+  static bool filter(const std::vector<int> & t)
   {
     return t[0] >= 2;
   }
@@ -166,7 +177,15 @@ class BTagAntiMax0CustomFilter
 
 
 
-template <class Filter> float BTagWeight::weight(vector<vector<JetInfo> >jets)
+template <class Filter> float BTagWeight::weight(const vector<vector<JetInfo> > & jets)
+{
+  counts.Fill(jets);
+  return counts.weight<Filter>();
+}
+
+
+
+template <class Filter> float BTagWeight::weightBruteForce(const vector<vector<JetInfo> > & jets)
 {
   unsigned int njets=jets.size();
   std::vector<unsigned int> comb(jets.size());
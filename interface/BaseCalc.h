@@ -12,6 +12,8 @@
 
 #include "FWCore/ParameterSet/interface/ProcessDesc.h"
 #include "FWCore/PythonParameterSet/interface/PythonProcessDesc.h"
+#include "LJMet/Com/interface/LjmetArena.h"
+#include "LJMet/Com/interface/LjmetEventProducts.h"
 
 class BaseEventSelector;
 class LjmetEventContent;
@@ -36,6 +38,9 @@ public:
     virtual int ProduceEvent(edm::EventBase const & event, BaseEventSelector * selector) { return 0; }
     virtual int AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * selector) { return 0; }
     virtual int EndJob() { return 0; }
+    /// Running totals kept for EndJob(), saved at a checkpoint and restored in a resumed job
+    virtual std::vector<double> GetState() const { return std::vector<double>(); }
+    virtual void SetState(std::vector<double> const & state) { }
     
     std::string mName;
     std::string mLegend;
@@ -47,11 +52,29 @@ public:
     void SetValue(std::string name, bool value);
     void SetValue(std::string name, int value);
     void SetValue(std::string name, double value);
-    void SetValue(std::string name, std::vector<bool> value);
-    void SetValue(std::string name, std::vector<int> value);
-    void SetValue(std::string name, std::vector<double> value);
+    void SetValue(std::string name, std::vector<bool> const & value);
+    void SetValue(std::string name, std::vector<int> const & value);
+    void SetValue(std::string name, std::vector<double> const & value);
+    void SetValue(std::string name, std::vector<float> const & value);
+    void SetValue(std::string name, std::vector<short> const & value);
+    /// Arena-backed temporaries, see LjmetArena
+    void SetValue(std::string name, LjmetArenaVector<bool> const & value);
+    void SetValue(std::string name, LjmetArenaVector<int> const & value);
+    void SetValue(std::string name, LjmetArenaVector<double> const & value);
+    void SetValue(std::string name, LjmetArenaVector<float> const & value);
+    void SetValue(std::string name, LjmetArenaVector<short> const & value);
     
 protected:
+    // Products shared with the other calculators, see LjmetEventProducts
+    /// Declare a product of ProduceEvent(), in BeginJob()
+    void Produces(std::string const & name) { LjmetEventProducts::GetInstance()->Declare(name, this); }
+    /// Put a product of this event, in ProduceEvent()
+    template <class T> void PutProduct(std::string const & name, T const & value) { LjmetEventProducts::GetInstance()->Put(name, value); }
+    /// Product of this event, its producer runs first if it has not yet
+    template <class T> T const & GetProduct(std::string const & name) { return LjmetEventProducts::GetInstance()->Get<T>(name); }
+    /// True if a calculator of this job produces the product, after BeginJob()
+    bool HasProduct(std::string const & name) const { return LjmetEventProducts::GetInstance()->IsDeclared(name); }
+    
     edm::ParameterSet mPset;
     
 private:
@@ -17,6 +17,7 @@
 
 #include "FWCore/Framework/interface/Event.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
+#include "LJMet/Com/interface/LjmetSelectionCache.h"
 
 #include "DataFormats/Math/interface/deltaR.h"
 #include "DataFormats/RecoCandidate/interface/RecoCandidate.h"
@@ -69,17 +70,22 @@ public:
     TLorentzVector const & GetCorrectedMet() const { return correctedMET_p4; }
     std::vector<unsigned int> const & GetSelectedTriggers() const { return mvSelTriggers; }
     std::vector<edm::Ptr<reco::Vertex>> const & GetSelectedPVs() const { return mvSelPVs; }
-    double const & GetTestValue() const { return mTestValue; }
     void SetMc(bool isMc) { mbIsMc = isMc; }
     bool IsMc() { return mbIsMc; }
     
     // LJMET event content setters
     void Init( void );
+    /// Cut flow counters in the order of the cuts, for checkpointing
+    std::vector<size_t> GetCutFlow() const;
+    void SetCutFlow(std::vector<size_t> const & counts);
+    /// Selection result of the current event, for the selection cache
+    void GetSelection(pat::strbitset const & ret, LjmetSelectionCache::Record & record) const;
+    /// Restore the selected objects of a cached event instead of running the selection
+    void SetSelection(edm::EventBase const & event, LjmetSelectionCache::Record const & record, pat::strbitset & ret);
     void SetEventContent(LjmetEventContent * pEc) { mpEc = pEc; }
     /// Declare a new histogram to be created for the module
     void SetHistogram(std::string name, int nbins, double low, double high) { mpEc->SetHistogram(mName, name, nbins, low, high); }
     void SetHistValue(std::string name, double value) { mpEc->SetHistValue(mName, name, value); }
-    void SetTestValue(double & test) { mTestValue = test; }
     
     void SetCorrectedMet(TLorentzVector & met) { correctedMET_p4 = met; }
     void SetCorrJetsWithBTags(std::vector<std::pair<TLorentzVector, bool>> & jets) { mvCorrJetsWithBTags = jets; }
@@ -89,6 +95,24 @@ public:
     TLorentzVector correctMet(const pat::MET & met, edm::EventBase const & event);
     
 protected:
+    /// A cut resolved to its bit, cut flow counter and value, so that the
+    /// event loop does not look cuts up by name. Resolve after set().
+    struct CutIndex {
+        CutIndex(): position(0), intCut(0), doubleCut(0.0) { }
+        pat::strbitset::index_type bit;
+        size_t position;
+        int intCut;
+        double doubleCut;
+    };
+    CutIndex GetCutIndex(std::string const & name) const;
+    
+    using EventSelector::passCut;
+    using EventSelector::considerCut;
+    using EventSelector::ignoreCut;
+    void passCut(pat::strbitset & ret, CutIndex const & index) { ret[index.bit] = true; ++cutFlow_[index.position].second; }
+    bool considerCut(CutIndex const & index) const { return bits_[index.bit]; }
+    bool ignoreCut(CutIndex const & index) const { return !bits_[index.bit]; }
+    
     std::vector<edm::Ptr<pat::Jet>> mvAllJets;
     std::vector<edm::Ptr<pat::Jet>> mvSelJets;
     std::vector<edm::Ptr<pat::Jet>> mvLooseJets;
@@ -105,7 +129,6 @@ protected:
     TLorentzVector correctedMET_p4;
     std::vector<unsigned int> mvSelTriggers;
     std::vector<edm::Ptr<reco::Vertex>> mvSelPVs;
-    double mTestValue;
     
     // containers for config parameter values
     std::map<std::string, bool> mbPar;
@@ -129,6 +152,8 @@ private:
     FactorizedJetCorrector *JetCorrector;
     FactorizedJetCorrector *JetCorrectorAK8;
     LjmetEventContent * mpEc;
+    /// Bits of the cuts in cut flow order, for restoring cached selections
+    std::vector<pat::strbitset::index_type> mvCutBits;
     
     /// Private init method to be called by LjmetFactory when registering the selector
     void init() { mLegend = "[" + mName + "]: "; std::cout << mLegend << "registering " << mName << std::endl; }
@@ -0,0 +1,39 @@
+#ifndef LJMet_Com_interface_ConstituentPacking_h
+#define LJMet_Com_interface_ConstituentPacking_h
+
+/*
+  16-bit encoding of jet constituent kinematics for compact ntuples
+
+  pt and energy are stored as round(2000*log(x)), i.e. with a relative
+  precision of 2.5e-4 between 1e-7 and 1e7 GeV; eta in steps of 0.001
+  (|eta| < 32.7) and phi in steps of 1e-4.
+  Analysis code decodes the branches with the Unpack functions.
+*/
+
+#include <cmath>
+
+namespace ConstituentPacking {
+
+    const double logScale = 2000.0;
+    const double etaScale = 1000.0;
+    const double phiScale = 10000.0;
+    const double maxPacked = 32767.0;
+
+    inline short Clamp(double v) {
+        if (v > maxPacked) return (short)maxPacked;
+        if (v < -maxPacked) return (short)(-maxPacked);
+        return (short)std::floor(v + 0.5);
+    }
+
+    /// pt or energy
+    inline short PackLog(double x) { return x > 0.0 ? Clamp(logScale*std::log(x)) : (short)(-maxPacked); }
+    inline double UnpackLog(short q) { return std::exp(q/logScale); }
+
+    inline short PackEta(double eta) { return Clamp(etaScale*eta); }
+    inline double UnpackEta(short q) { return q/etaScale; }
+
+    inline short PackPhi(double phi) { return Clamp(phiScale*phi); }
+    inline double UnpackPhi(short q) { return q/phiScale; }
+}
+
+#endif
@@ -0,0 +1,110 @@
+// -*- C++ -*-
+//
+// Momentum tensor and closed-form 3x3 symmetric eigenvalue solver
+// for event shape variables (sphericity, aplanarity, C, D)
+//
+// Everything here works on plain arrays on the stack, so no ROOT
+// matrix objects get allocated per event.
+//
+// The tensor is stored as the upper triangle of the symmetric matrix:
+//   { Mxx, Mxy, Mxz, Myy, Myz, Mzz }
+//
+
+#ifndef LJMet_Com_interface_EventShapeUtils_h
+#define LJMet_Com_interface_EventShapeUtils_h
+
+
+
+#include <algorithm>
+#include <cstddef>
+
+
+
+namespace EventShapeUtils{
+
+  enum TensorIndex { kXX=0, kXY, kXZ, kYY, kYZ, kZZ, kNTensor };
+
+  /// Zero the tensor and the p^2 sum
+  inline void ResetMomentumTensor( double * tensor, double & p2sum );
+
+  /// Add one object to the (unnormalized) momentum tensor
+  inline void AddToMomentumTensor( double px, double py, double pz,
+                                   double * tensor, double & p2sum );
+
+  /// Add n objects given as SoA arrays to the (unnormalized) momentum tensor
+  void AccumulateMomentumTensor( const double * px, const double * py, const double * pz,
+                                 std::size_t n,
+                                 double * tensor, double & p2sum );
+
+  /// Add a collection of objects with Px(), Py(), Pz() through the SoA
+  /// accumulator, the momenta are gathered on the stack in blocks
+  template <class Objects>
+  void AccumulateMomentumTensor( Objects const & objects,
+                                 double * tensor, double & p2sum );
+
+  /// Divide the tensor by the p^2 sum (no-op if the sum is zero)
+  inline void NormalizeMomentumTensor( double * tensor, double p2sum );
+
+  /// Eigenvalues of a symmetric 3x3 matrix in descending order
+  void SymmetricEigenvalues3x3( const double * tensor, double * eigenvalues );
+
+  /// Convenience: normalized tensor eigenvalues for SoA inputs, descending order
+  void MomentumTensorEigenvalues( const double * px, const double * py, const double * pz,
+                                  std::size_t n,
+                                  double * eigenvalues );
+
+}
+
+
+
+inline
+void EventShapeUtils::ResetMomentumTensor( double * tensor, double & p2sum ){
+  for (int i = 0; i < kNTensor; ++i) tensor[i] = 0.0;
+  p2sum = 0.0;
+}
+
+
+
+inline
+void EventShapeUtils::AddToMomentumTensor( double px, double py, double pz,
+                                           double * tensor, double & p2sum ){
+  tensor[kXX] += px*px;
+  tensor[kXY] += px*py;
+  tensor[kXZ] += px*pz;
+  tensor[kYY] += py*py;
+  tensor[kYZ] += py*pz;
+  tensor[kZZ] += pz*pz;
+  p2sum += px*px + py*py + pz*pz;
+}
+
+
+
+template <class Objects>
+void EventShapeUtils::AccumulateMomentumTensor( Objects const & objects,
+                                                double * tensor, double & p2sum ){
+  std::size_t const kBlock = 32;
+  double _px[kBlock], _py[kBlock], _pz[kBlock];
+  std::size_t const _n = objects.size();
+  for (std::size_t first = 0; first < _n; first += kBlock){
+    std::size_t const _m = std::min(kBlock, _n - first);
+    for (std::size_t k = 0; k < _m; ++k){
+      _px[k] = objects[first+k].Px();
+      _py[k] = objects[first+k].Py();
+      _pz[k] = objects[first+k].Pz();
+    }
+    AccumulateMomentumTensor(_px, _py, _pz, _m, tensor, p2sum);
+  }
+}
+
+
+
+inline
+void EventShapeUtils::NormalizeMomentumTensor( double * tensor, double p2sum ){
+  if ( p2sum == 0.0 ) return;
+  double _inv = 1.0/p2sum;
+  for (int i = 0; i < kNTensor; ++i) tensor[i] *= _inv;
+}
+
+
+
+#endif // LJMet_Com_interface_EventShapeUtils_h
@@ -4,30 +4,67 @@
 #include <sstream>
 #include "zlib.h"
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 
+//
+// The event list is either the (gzipped) text list with one "run:LS:event"
+// per line, or a binary list made from it by ljmet-hcal-laser-convert,
+// which is memory-mapped instead of parsed. The binary list holds the
+// sorted event keys (run << 46 | LS << 32 | event) and a table of the
+// key range of each run.
+//
+
 class HcalLaserEventFilter2012  {
 public:
     HcalLaserEventFilter2012(const std::string & eventFileName);
-    ~HcalLaserEventFilter2012() {}
-    
-private:
+    ~HcalLaserEventFilter2012();
+
+    // false if the event is in the bad laser event list
     bool filter(int run, int lumiSection, int event);
-    
+
+    // Convert a text event list to the binary format, returns false on failure
+    static bool writeBinaryFile(const std::string & eventFileName, const std::string & binaryFileName);
+
+    struct RunRange {
+        uint32_t run;
+        uint32_t count;  // number of keys in this run
+        uint64_t first;  // index of the first key of this run
+    };
+
+    static uint64_t eventKey(int run, int lumiSection, int event) {
+        return ((uint64_t)run << 46) | ((uint64_t)lumiSection << 32) | (uint32_t)event;
+    }
+    static const int maxRun = (1 << 18) - 1;
+    static const int maxLumiSection = (1 << 14) - 1;
+
+private:
+    HcalLaserEventFilter2012(const HcalLaserEventFilter2012 &);
+    HcalLaserEventFilter2012 & operator=(const HcalLaserEventFilter2012 &);
+
     void readEventListFile(const std::string & eventFileName);
     void addEventString(const std::string & eventString);
-    
+    bool mapBinaryFile(const std::string & eventFileName);
+    void buildRunRanges();
+
     // ----------member data ---------------------------
-    typedef std::vector< std::string > strVec;
-    typedef std::vector< std::string >::iterator strVecI;
-    
-    std::vector< std::string > EventList_;  // vector of strings representing bad events, with each string in "run:LS:event" format
+    std::vector< uint64_t > EventList_;  // sorted keys of bad events, when read from a text list
+    std::vector< RunRange > RunList_;
+
+    // keys and run ranges in use, pointing into EventList_/RunList_ or into the mapped binary file
+    const uint64_t * keys_;
+    uint64_t nKeys_;
+    const RunRange * runs_;
+    uint32_t nRuns_;
+    void * map_;
+    size_t mapSize_;
+
     bool verbose_;  // if set to true, then the run:LS:event for any event failing the cut will be printed out
-    
+
     // Set run range of events in the BAD LASER LIST.
     // The purpose of these values is to shorten the length of the EventList_ vector when running on only a subset of data
     int minrun_;
     int maxrun_;  // if specified (i.e., values > -1), then only events in the given range will be filtered
     int minRunInFile, maxRunInFile;
-    
+
 };
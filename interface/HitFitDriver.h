@@ -0,0 +1,146 @@
+#ifndef LJMet_Com_interface_HitFitDriver_h
+#define LJMet_Com_interface_HitFitDriver_h
+
+/*
+  Jet permutation driver for HitFit kinematic fits
+
+  Enumerates the same jet-parton hypotheses as hitfit::RunHitFit
+  (next_permutation over the sorted jet labels, two neutrino solutions
+  per permutation), drops hypotheses before fitting and runs the
+  remaining fits on a pool of worker threads. The threads are started
+  with the driver and wait for the fits of the next event.
+
+  Pruning, both off by default:
+  - hitfitBTagPruning = 1: with up to two tags, b-tagged jets are only
+    assigned to b quarks, events with more tags are not pruned;
+    = 2: in addition, with more than two tags both b quarks must take
+    tagged jets.
+  - hitfitMaxPreFitChi2 > 0: drop hypotheses whose unfitted hadronic W
+    (and top, if the top mass is fixed) mass is too far from the
+    constraint, with a jet energy resolution of hitfitPreFitJetResolution.
+    The unfitted mass chi2 is an estimate, not a lower bound on the
+    fitted chi2: the fit also moves the jet angles, the lepton and the
+    MET, with the resolutions of the translators. This cut therefore
+    changes the physics result, an event can lose the hypothesis that
+    the exhaustive run selects and get another best fit, or none.
+    With hitfitCheckPreFitChi2 the hypotheses it drops are fitted too,
+    without taking part in GetBest(), and GetBestPruned() tells whether
+    the best of all fits was one of them. Use it to tune the cut on a
+    sample, not in production: it fits as much as the unpruned run.
+
+  Fit results are stored by hypothesis index, so for every hypothesis
+  that is fitted the result does not depend on the number of workers or
+  on pruning. Pruned hypotheses are reported as not fitted, unless they
+  are fitted for hitfitCheckPreFitChi2 (fit false, chi2 >= 0).
+
+  The fit itself is passed to Run() as a callable
+    double fit(unsigned int hypothesis, unsigned int worker)
+  returning the chi2; it is called concurrently with different worker
+  numbers, so it must keep one fitter (hitfit::Top_Fit) per worker.
+  See HitFitPermutationFit.h for the hitfit binding.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+
+
+class HitFitDriver {
+
+ public:
+
+  /// Jet assignment, ordered as the hitfit jet labels
+  enum JetRole { roleLepB = 0, roleHadB = 1, roleHadW = 2, roleUnknown = 3 };
+
+  struct Jet {
+    double px, py, pz, e;
+    bool btag;
+  };
+
+  struct Hypothesis {
+    std::vector<int> roles;   // role of each jet
+    bool nuz;                 // neutrino solution
+    double preFitChi2;
+    bool fit;                 // false if pruned
+    double chi2;              // fit result, -1 if not fitted
+  };
+
+  HitFitDriver(edm::ParameterSet const & par);
+  ~HitFitDriver();
+
+  /// Enumerate and prune the hypotheses for one event, returns the number to fit
+  unsigned int SetJets(std::vector<Jet> const & jets);
+
+  /// Run fit on every hypothesis that survived pruning, and on those checked for the pre-fit chi2
+  template <class Fit> void Run(Fit & fit);
+
+  unsigned int GetNWorkers() const { return nWorkers; }
+  std::vector<Hypothesis> const & GetHypotheses() const { return hypotheses; }
+
+  /// Index of the smallest chi2 among the converged fits that survived pruning, -1 if none
+  int GetBest() const;
+
+  /// With hitfitCheckPreFitChi2: index of the smallest chi2 among all converged fits
+  /// if the pre-fit chi2 cut dropped it, -1 otherwise
+  int GetBestPruned() const;
+
+  bool GetCheckPreFitChi2() const { return checkPreFitChi2; }
+
+  unsigned int GetNPrunedBTag() const { return nPrunedBTag; }
+  unsigned int GetNPrunedChi2() const { return nPrunedChi2; }
+
+ private:
+
+  bool passBTag(std::vector<int> const & roles, unsigned int nTags) const;
+  double preFitChi2(std::vector<int> const & roles) const;
+
+  /// Run task on the hypotheses to fit, with the pool if there is more than one
+  void runTask();
+  void work(unsigned int worker);
+  void workerLoop(unsigned int worker);
+
+  unsigned int nWorkers;
+  int bTagPruning;
+  double maxPreFitChi2;
+  bool checkPreFitChi2;
+  double jetResolution;
+  double hadWMass;
+  double topMass;
+
+  std::vector<Jet> jets;
+  std::vector<Hypothesis> hypotheses;
+  std::vector<unsigned int> toFit;
+  std::atomic<unsigned int> next;
+  unsigned int nPrunedBTag;
+  unsigned int nPrunedChi2;
+
+  // worker pool, workers 1..nWorkers-1, the caller of Run is worker 0
+  std::function<double(unsigned int, unsigned int)> task;
+  std::vector<std::thread> pool;
+  std::mutex poolMutex;
+  std::condition_variable wakeUp;
+  std::condition_variable done;
+  unsigned long generation;   // number of runs handed to the pool
+  unsigned int nRunWorkers;   // workers taking part in the current run
+  unsigned int nBusy;         // pool workers of the current run not done yet
+  bool stop;
+};
+
+
+
+template <class Fit> void HitFitDriver::Run(Fit & fit)
+{
+  task = std::ref(fit);
+  runTask();
+  task = nullptr;
+}
+
+
+
+#endif
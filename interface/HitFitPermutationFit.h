@@ -0,0 +1,135 @@
+#ifndef LJMet_Com_interface_HitFitPermutationFit_h
+#define LJMet_Com_interface_HitFitPermutationFit_h
+
+/*
+  hitfit binding for HitFitDriver
+
+  Fits one HitFitDriver hypothesis the way hitfit::RunHitFit fits a
+  permutation: the jets are translated with the parton-level correction
+  and resolution of their assigned label and added to the unfitted
+  lepton + MET event, then Top_Fit::fit_one_perm is called. Every worker
+  has its own copy of the Top_Fit, which is not thread safe.
+
+  The translator is not thread safe either. SetEvent translates every
+  jet once for each label, in the calling thread, and the workers only
+  read these translated jets.
+
+  Usage, per event:
+    driver.SetJets(driverJets);
+    fitter.SetEvent(unfittedEvent, jets);
+    driver.Run(fitter);
+  then GetResult(i) is the fit of driver.GetHypotheses()[i], 0 if not fitted.
+
+  HitFitCalc uses it for the pat objects of the selected event.
+*/
+
+#include <vector>
+
+#include "TopQuarkAnalysis/TopHitFit/interface/Fit_Result.h"
+#include "TopQuarkAnalysis/TopHitFit/interface/JetTranslatorBase.h"
+#include "TopQuarkAnalysis/TopHitFit/interface/Lepjets_Event.h"
+#include "TopQuarkAnalysis/TopHitFit/interface/Top_Fit.h"
+#include "LJMet/Com/interface/HitFitDriver.h"
+
+
+
+template <class AJet>
+class HitFitPermutationFit {
+
+ public:
+
+  HitFitPermutationFit(hitfit::Top_Fit const & topFit,
+                       hitfit::JetTranslatorBase<AJet> & jetTranslator,
+                       HitFitDriver const & driver,
+                       bool jetObjRes = false):
+    topFits(driver.GetNWorkers(), topFit),
+    translator(&jetTranslator),
+    driver_(driver),
+    useObjRes(jetObjRes),
+    event(0, 0),
+    nJets(0)
+  {
+  }
+
+  ~HitFitPermutationFit() { clear(); }
+
+  /// Unfitted event with lepton, MET and kt resolution but no jets,
+  /// call after HitFitDriver::SetJets
+  void SetEvent(hitfit::Lepjets_Event const & unfitted, std::vector<AJet> const & jets) {
+    clear();
+    event = unfitted;
+    nJets = jets.size();
+    translated.clear();
+    for (unsigned int j = 0; j < nJets; ++j) {
+      for (int role = 0; role != nRoles; ++role) {
+        translated.push_back((*translator)(jets[j], label(role), useObjRes));
+      }
+    }
+    results.assign(driver_.GetHypotheses().size(), 0);
+  }
+
+  /// Called by HitFitDriver::Run
+  double operator()(unsigned int hypothesis, unsigned int worker);
+
+  /// Fit of hypothesis i, 0 if it was not fitted
+  hitfit::Fit_Result const * GetResult(unsigned int i) const {
+    return i < results.size() ? results[i] : 0;
+  }
+
+ private:
+
+  void clear() {
+    for (unsigned int i = 0; i < results.size(); ++i) delete results[i];
+    results.clear();
+  }
+
+  static const int nRoles = HitFitDriver::roleUnknown + 1;
+
+  static int label(int role) {
+    switch (role) {
+    case HitFitDriver::roleLepB: return hitfit::lepb_label;
+    case HitFitDriver::roleHadB: return hitfit::hadb_label;
+    case HitFitDriver::roleHadW: return hitfit::hadw1_label;
+    default:                     return hitfit::unknown_label;
+    }
+  }
+
+  std::vector<hitfit::Top_Fit> topFits;
+  hitfit::JetTranslatorBase<AJet> * translator;
+  HitFitDriver const & driver_;
+  bool useObjRes;
+  hitfit::Lepjets_Event event;
+  unsigned int nJets;
+  // translated[jet*nRoles + role]
+  std::vector<hitfit::Lepjets_Event_Jet> translated;
+  std::vector<hitfit::Fit_Result *> results;
+};
+
+
+
+template <class AJet>
+double HitFitPermutationFit<AJet>::operator()(unsigned int hypothesis, unsigned int worker)
+{
+  HitFitDriver::Hypothesis const & _h = driver_.GetHypotheses()[hypothesis];
+
+  hitfit::Lepjets_Event _fev = event;
+  for (unsigned int j = 0; j < nJets; ++j) {
+    _fev.add_jet(translated[j*nRoles + _h.roles[j]]);
+  }
+
+  bool _nuz = _h.nuz;
+  double _umwhad = 0;
+  double _utmass = 0;
+  double _mt = 0;
+  double _sigmt = 0;
+  hitfit::Column_Vector _pullx(1);
+  hitfit::Column_Vector _pully(1);
+  double _chisq = topFits[worker].fit_one_perm(_fev, _nuz, _umwhad, _utmass, _mt, _sigmt, _pullx, _pully);
+
+  results[hypothesis] = new hitfit::Fit_Result(_chisq, _fev, _pullx, _pully, _umwhad, _utmass, _mt, _sigmt);
+  return _chisq;
+}
+
+
+
+#endif
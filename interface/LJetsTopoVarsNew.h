@@ -9,7 +9,7 @@
 #include "LJMet/Com/interface/TMBLorentzVector.h"
 #include "TVectorD.h"
 #include "TLorentzVector.h"
-#include "LJMet/Com/interface/METzCalculator.h"
+#include "LJMet/Com/interface/NeutrinoSolver.h"
 
 #include "DataFormats/PatCandidates/interface/Jet.h"
 #include "DataFormats/PatCandidates/interface/MET.h"
@@ -305,7 +305,8 @@ private:
     std::vector<double> _mt;
     bool _mtOK;
     
-    METzCalculator fzCalculator;
+    /// lepton and MET for the W mass constraint
+    NeutrinoSolver::Input neutrinoInput() const;
     
     
     //ClassDef(LJetsTopoVarsNew,1) // L+jets topological and kinematic variables
@@ -0,0 +1,127 @@
+#ifndef LJMet_Com_interface_LjmetArena_h
+#define LJMet_Com_interface_LjmetArena_h
+
+/*
+ Per-event arena for calculator temporaries
+
+ The calculators fill dozens of local vectors per event, each growing
+ through a few heap allocations. LjmetArenaVector and LjmetArenaString
+ take their memory from a monotonic arena instead: an allocation moves a
+ pointer in the current block and freeing is a no-op. The arena is
+ rewound at the end of every event, keeping its blocks, so after the
+ first events an event does not touch the heap for these temporaries.
+
+ Memory from the arena is valid until the end of the event. Arena
+ containers are for locals of BeginEvent, ProduceEvent and AnalyzeEvent,
+ never for members, static or products kept across events. SetValue
+ accepts them and copies into the output branches.
+
+ Report() gives the heap allocations per event, counted by the ljmet
+ executable, and the allocations the arena took instead.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class LjmetArena {
+public:
+    static LjmetArena * GetInstance();
+    ~LjmetArena();
+
+    /// Memory for one event, aligned to align (a power of two)
+    void * Allocate(std::size_t bytes, std::size_t align);
+    /// Rewind, all arena memory of the event is released
+    void Reset();
+    /// New event: closes the statistics of the previous one and rewinds
+    void BeginEvent();
+
+    /// Call from the global operator new of the executable
+    static void CountHeapAllocation();
+
+    void Report(std::ostream & out);
+
+private:
+    struct Block {
+        char * begin;
+        std::size_t size;
+    };
+
+    LjmetArena();
+    LjmetArena(LjmetArena const &); // stop default
+
+    void * allocateSlow(std::size_t bytes, std::size_t align);
+    void closeEvent();
+
+    std::string mLegend;
+    std::vector<Block> mvBlocks;
+    /// current block and position in it
+    std::size_t mBlock;
+    char * mpCur;
+    char * mpEnd;
+    /// bytes in the blocks before the current one, for the statistics
+    std::size_t mUsedBefore;
+
+    // statistics
+    bool mInEvent;
+    unsigned long long mEvents;
+    unsigned long long mAllocations;
+    unsigned long long mHeapAtBegin;
+    unsigned long long mHeapAllocations;
+    std::size_t mMaxBytes;
+};
+
+
+
+inline void * LjmetArena::Allocate(std::size_t bytes, std::size_t align)
+{
+    ++mAllocations;
+    std::uintptr_t _p = (reinterpret_cast<std::uintptr_t>(mpCur) + align - 1) & ~std::uintptr_t(align - 1);
+    if (_p + bytes > reinterpret_cast<std::uintptr_t>(mpEnd)) return allocateSlow(bytes, align);
+    mpCur = reinterpret_cast<char *>(_p + bytes);
+    return reinterpret_cast<void *>(_p);
+}
+
+
+
+/// C++ allocator over the event arena
+template <class T>
+class LjmetArenaAllocator {
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef T const * const_pointer;
+    typedef T & reference;
+    typedef T const & const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    template <class U> struct rebind { typedef LjmetArenaAllocator<U> other; };
+
+    LjmetArenaAllocator() { }
+    template <class U> LjmetArenaAllocator(LjmetArenaAllocator<U> const &) { }
+
+    pointer allocate(size_type n, void const * = 0)
+    {
+        return static_cast<pointer>(LjmetArena::GetInstance()->Allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(pointer, size_type) { }
+
+    size_type max_size() const { return std::size_t(-1) / sizeof(T); }
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+    template <class U, class... Args> void construct(U * p, Args &&... args) { ::new((void *)p) U(std::forward<Args>(args)...); }
+    template <class U> void destroy(U * p) { p->~U(); }
+};
+
+template <class T, class U>
+bool operator==(LjmetArenaAllocator<T> const &, LjmetArenaAllocator<U> const &) { return true; }
+template <class T, class U>
+bool operator!=(LjmetArenaAllocator<T> const &, LjmetArenaAllocator<U> const &) { return false; }
+
+template <class T> using LjmetArenaVector = std::vector<T, LjmetArenaAllocator<T> >;
+typedef std::basic_string<char, std::char_traits<char>, LjmetArenaAllocator<char> > LjmetArenaString;
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef LJMet_Com_interface_LjmetCheckpoint_h
+#define LJMet_Com_interface_LjmetCheckpoint_h
+
+/*
+ Checkpoint sidecar file of an ljmet job
+ 
+ <outputName>.ckpt records the next global entry of the input chain,
+ the number of events processed and of output tree entries, the
+ selector cut flow and the running totals of the calculators at the
+ last checkpoint, with the key cycle of the output file written then.
+ A checkpoint writes the tree and histograms as a new cycle and drops
+ the older cycles once the sidecar names the new one, so the output
+ always holds the checkpointed cycle. A restarted job with the same
+ inputs opens the output in UPDATE mode, deletes every other cycle,
+ which truncates the tree to the checkpointed entries, and keeps
+ filling the same tree from that entry.
+ 
+ Calculators that keep totals for EndJob() save and restore them with
+ BaseCalc::GetState() and SetState(). The timing reports at the end of
+ the job, of the input tuner, the arena and the JEC cache, cover only
+ the events of the resumed job.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+
+class LjmetCheckpoint {
+public:
+    /// inputs identify the job: same files, skipEvents and nEvents
+    LjmetCheckpoint(std::string const & outputName, std::string const & treeName,
+                    std::vector<std::string> const & fileNames, int skipEvents, int nEvents);
+    
+    /// Read the sidecar file, false if there is none or it belongs to other inputs
+    bool Read();
+    
+    /// Output file in UPDATE mode, reduced to the checkpointed cycle, 0 if it does not match the sidecar
+    TFile * OpenOutput();
+    
+    /// Write the output file as a new cycle, record the checkpoint and drop the older cycles
+    bool Write(TFile & file, long long entry, long long processed, long long treeEntries,
+               std::vector<size_t> const & cutFlow, std::map<std::string, std::vector<double> > const & calcState);
+    
+    /// Remove the sidecar file at the end of the job, the output keeps its newest cycle
+    void Clear(TFile & file);
+    
+    long long GetEntry() const { return mEntry; }
+    long long GetProcessed() const { return mProcessed; }
+    long long GetTreeEntries() const { return mTreeEntries; }
+    short GetCycle() const { return mCycle; }
+    std::vector<size_t> const & GetCutFlow() const { return mvCutFlow; }
+    std::map<std::string, std::vector<double> > const & GetCalcState() const { return mCalcState; }
+    
+private:
+    std::string mLegend;
+    std::string mOutputName;
+    std::string mTreeName;
+    std::string mFileName;
+    unsigned long long mInputHash;
+    long long mEntry;
+    long long mProcessed;
+    long long mTreeEntries;
+    short mCycle;
+    std::vector<size_t> mvCutFlow;
+    std::map<std::string, std::vector<double> > mCalcState;
+};
+
+#endif
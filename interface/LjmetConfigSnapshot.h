@@ -0,0 +1,48 @@
+#ifndef LJMet_Com_interface_LjmetConfigSnapshot_h
+#define LJMet_Com_interface_LjmetConfigSnapshot_h
+
+/*
+ Configuration snapshot, the process parameter set without Python
+
+ Reading a _cfg.py starts the Python interpreter and runs the whole
+ import chain of _cfi.py files, identical for all jobs of a submission.
+ ljmet-config-compile runs the config once and writes its parameter set
+ to a snapshot file: every parameter in its encoded form, the nested
+ parameter sets and vectors of them, with a format version and a
+ checksum. ljmet recognizes a snapshot as its first argument and reads
+ it instead of running Python.
+
+ What differs from job to job is given in an override file, the second
+ argument, one parameter of a top-level parameter set per line:
+
+   inputs.fileNames  = file:a.root, file:b.root
+   inputs.skipEvents = 0
+   outputs.outputName = ttbar_12
+   # comment
+
+ The parameter must exist in the snapshot and keeps its type and
+ trackedness. Vectors are separated by commas or blanks, quotes around
+ values are dropped.
+
+ usage: ljmet-config-compile <config.py> <snapshot>
+        ljmet <snapshot> [overrides]
+ */
+
+#include <memory>
+#include <string>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+class LjmetConfigSnapshot {
+public:
+    /// Write the parameter set of config to fileName, false on failure
+    static bool Write(edm::ParameterSet const & pset, std::string const & config, std::string const & fileName);
+    /// True if fileName starts like a snapshot
+    static bool IsSnapshot(std::string const & fileName);
+    /// Parameter set of a snapshot, exits if it cannot be read
+    static std::shared_ptr<edm::ParameterSet> Read(std::string const & fileName);
+    /// Apply an override file to the top-level parameter sets, exits on errors
+    static void Override(edm::ParameterSet & pset, std::string const & fileName);
+};
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef LJMet_Com_interface_LjmetCutFlowSelector_h
+#define LJMet_Com_interface_LjmetCutFlowSelector_h
+
+/*
+ Cut-flow engine for the single lepton event selectors
+
+ An event is selected in two steps:
+   object pass  one loop over each collection (muons, electrons, taus,
+                jets) in which every object is classified against all
+                its working points at once, then the MET. It fills the
+                object lists of BaseEventSelector and the counts of
+                Summary.
+   cut chain    the cuts in cut flow order. Event filters (trigger,
+                primary vertex, ...) read event products, all other
+                cuts are tests on Summary.
+ The object pass runs when the chain reaches the first cut that needs
+ objects, so events failing the event filters never loop over the
+ collections, and it runs once whatever the number of cuts.
+
+ A selector is a configuration of the engine: Configure() reads its
+ parameters, declares the cuts with AddCut in cut flow order and sets
+ the options of the object pass; the object definitions that differ
+ between analyses are the virtual ID methods. "No selection" and
+ "All cuts" are added by the engine. A selector whose lepton IDs are
+ plain selector working points hands them to mLeptonId instead, which
+ evaluates them over the whole collection at once.
+
+ A cut is
+   if (!considerCut(name)) skip      only for cutIfConsidered
+   if (ignoreCut(name) || test(event, cut)) passCut(ret, name)
+   else stop the chain               not for cutNoBreak
+ An inactive cut, e.g. the jet cuts with jet_cuts = False, is skipped.
+ The cuts are resolved to their CutIndex at the end of BeginJob, the
+ tests read the cut value from it, so no cut is looked up by name in
+ the event loop.
+ */
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/PatCandidates/interface/Jet.h"
+#include "DataFormats/PatCandidates/interface/MET.h"
+#include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/PatCandidates/interface/Tau.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "LJMet/Com/interface/BaseEventSelector.h"
+#include "LJMet/Com/interface/LjmetLeptonId.h"
+#include "PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h"
+#include "PhysicsTools/SelectorUtils/interface/PVSelector.h"
+
+class LjmetCutFlowSelector : public BaseEventSelector {
+public:
+    LjmetCutFlowSelector();
+    virtual ~LjmetCutFlowSelector() { }
+
+    virtual void BeginJob(std::map<std::string, edm::ParameterSet const > par);
+    virtual bool operator()(edm::EventBase const & event, pat::strbitset & ret);
+
+protected:
+    /// Counts of the object pass and results of the event filters
+    struct Summary {
+        Summary() { clear(); }
+        void clear();
+
+        bool passTrigElMC;
+        bool passTrigMuMC;
+        bool passTrigElData;
+        bool passTrigMuData;
+
+        int nTightMuons;
+        int nLooseMuons;
+        int nTightElectrons;
+        int nLooseElectrons;
+        int nTaus;
+        int nJets;
+        int nBtagJets;
+        double leadingJetPt;
+
+        bool hasMet;
+        double met;
+    };
+
+    enum CutFlag { cutObjects = 1, cutIfConsidered = 2, cutNoBreak = 4 };
+    /// Test of a cut, with its index and value
+    typedef std::function<bool (edm::EventBase const &, CutIndex const &)> CutTest;
+
+    /// Read the parameters, declare the cuts and set the object pass options
+    virtual void Configure(std::map<std::string, edm::ParameterSet const > & par) = 0;
+
+    /// Append a cut to the cut flow and the chain, set its value with set() afterwards
+    void AddCut(std::string const & name, CutTest const & test, int flags = cutObjects, bool active = true);
+
+    // object definitions
+    virtual bool isTightMuon(pat::Muon const & muon, edm::EventBase const & event) { return false; }
+    virtual bool isLooseMuon(pat::Muon const & muon, edm::EventBase const & event) { return false; }
+    virtual bool isTightElectron(pat::Electron const & electron, edm::EventBase const & event) { return false; }
+    virtual bool isLooseElectron(pat::Electron const & electron, edm::EventBase const & event) { return false; }
+    virtual bool isTau(pat::Tau const & tau) { return false; }
+
+    // event filters shared by the selectors
+    /// Electron and muon data paths, or the MC path for isMc
+    bool passTrigger(edm::EventBase const & event);
+    /// PV selector; the vertices of pv_collection become the selected PVs
+    bool passPv(edm::EventBase const & event);
+    void loadLaserCalEvents(std::string const & fileName);
+    bool passLaserCal(edm::EventBase const & event) const;
+
+    /// Relative PF isolation with delta beta correction
+    static double pfRelIso(pat::Muon const & muon);
+
+    /// Name of the selection, for the log
+    std::string mSelection;
+    Summary mSummary;
+    bool mFirstEntry;
+
+    // object pass options
+    bool mSelectMuons;
+    bool mSelectElectrons;
+    bool mSelectTaus;
+    /// jets before leptons, for lepton-jet isolation in the lepton IDs
+    bool mJetsFirst;
+    /// subtract the leading selected lepton from the jet it belongs to
+    bool mCleanJets;
+    /// all jets go to mvAllJets, not only those passing the jet ID
+    bool mKeepAllJets;
+    /// correct and b-tag only the jets passing the jet ID
+    bool mCorrectIdJets;
+    /// keep the loose leptons in mvLooseMuons and mvLooseElectrons
+    bool mKeepLooseLeptons;
+    /// mvSelElectrons holds the electrons failing the tight ID, those an electron veto keeps
+    bool mKeepNonTightElectrons;
+    /// MET cut on correctedMET_p4 rather than the MET of met_collection
+    bool mCorrectMet;
+    /// read type1corrmet_collection for the calculators
+    bool mType1CorrMet;
+
+    /// Lepton ID over the whole collections; a working point set below
+    /// replaces the ID method of that lepton in the object pass, -1 keeps it
+    LjmetLeptonId mLeptonId;
+    int mTightMuonId;
+    int mLooseMuonId;
+    int mTightElectronId;
+    int mLooseElectronId;
+
+    boost::shared_ptr<PFJetIDSelectionFunctor> jetSel_;
+    boost::shared_ptr<PVSelector>              pvSel_;
+
+    edm::Handle<edm::TriggerResults>           mhEdmTriggerResults;
+    edm::Handle<std::vector<pat::Jet> >        mhJets;
+    edm::Handle<std::vector<pat::Muon> >       mhMuons;
+    edm::Handle<std::vector<pat::Electron> >   mhElectrons;
+    edm::Handle<std::vector<pat::Tau> >        mhTaus;
+    edm::Handle<std::vector<pat::MET> >        mhMet;
+    edm::Handle<std::vector<reco::PFMET> >     mhType1CorrMet;
+    edm::Handle<std::vector<reco::Vertex> >    h_primVtx;
+
+private:
+    struct Cut {
+        std::string name;
+        CutTest test;
+        int flags;
+        bool active;
+        CutIndex index;
+    };
+
+    void selectObjects(edm::EventBase const & event);
+    void selectMuons(edm::EventBase const & event);
+    void selectElectrons(edm::EventBase const & event);
+    void selectTaus(edm::EventBase const & event);
+    void selectJets(edm::EventBase const & event);
+    void selectMet(edm::EventBase const & event);
+    /// Jet momentum without the lepton if the lepton is one of its constituents
+    bool cleanJet(pat::Jet const & jet, reco::Candidate const & lepton, reco::CandidatePtr const & leptonSource, edm::EventBase const & event, TLorentzVector & jetP4);
+
+    std::vector<Cut> mvCuts;
+    CutIndex mNoSelection;
+    CutIndex mAllCuts;
+    pat::strbitset mJetBits;
+    std::map<int, std::map<int, std::vector<int> > > mmvBadLaserCalEvents;
+};
+
+#endif
@@ -8,12 +8,14 @@
  */
 
 #include <iostream>
+#include <list>
 #include <vector>
 #include <map>
 #include <limits>
 #include "TH1.h"
 #include "TTree.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "LJMet/Com/interface/LjmetArena.h"
 
 class LjmetEventContent {
 public:
@@ -61,9 +63,16 @@ public:
     void SetValue(std::string key, bool value);
     void SetValue(std::string key, int value);
     void SetValue(std::string key, double value);
-    void SetValue(std::string key, std::vector<bool> value);
-    void SetValue(std::string key, std::vector<int> value);
-    void SetValue(std::string key, std::vector<double> value);
+    void SetValue(std::string key, std::vector<bool> const & value);
+    void SetValue(std::string key, std::vector<int> const & value);
+    void SetValue(std::string key, std::vector<double> const & value);
+    void SetValue(std::string key, std::vector<float> const & value);
+    void SetValue(std::string key, std::vector<short> const & value);
+    void SetValue(std::string key, LjmetArenaVector<bool> const & value);
+    void SetValue(std::string key, LjmetArenaVector<int> const & value);
+    void SetValue(std::string key, LjmetArenaVector<double> const & value);
+    void SetValue(std::string key, LjmetArenaVector<float> const & value);
+    void SetValue(std::string key, LjmetArenaVector<short> const & value);
     
     // histograms: mDoubleHist[module][histname]
     // actual histograms get created by TFileService in the main application
@@ -74,9 +83,15 @@ public:
     void SetHistValue(std::string modname, std::string histname, double value);
     void Fill();
     
+    /// Resume from a checkpoint: continue the tree of SetTree(), read from the
+    /// output with its nEntries entries, before any new event is filled
+    bool Resume(Long64_t nEntries);
+    
 private:
     /// Create branches in the tree according to maps
     int createBranches();
+    template <class T> void resumeScalar(std::map<std::string, T> & branches);
+    template <class T> void resumeVector(std::map<std::string, std::vector<T> > & branches, std::list<std::vector<T> *> & pointers);
     std::string mName;
     std::string mLegend;
     TTree * mpTree;
@@ -86,6 +101,14 @@ private:
     std::map<std::string, std::vector<bool> > mVectorBoolBranch;
     std::map<std::string, std::vector<int> > mVectorIntBranch;
     std::map<std::string, std::vector<double> > mVectorDoubleBranch;
+    std::map<std::string, std::vector<float> > mVectorFloatBranch;
+    std::map<std::string, std::vector<short> > mVectorShortBranch;
+    // addresses of the vector branches of a resumed tree, which must live while filling
+    std::list<std::vector<bool> *> mlResumedVectorBool;
+    std::list<std::vector<int> *> mlResumedVectorInt;
+    std::list<std::vector<double> *> mlResumedVectorDouble;
+    std::list<std::vector<float> *> mlResumedVectorFloat;
+    std::list<std::vector<short> *> mlResumedVectorShort;
     
     // mDoubleHist[module][histname]=value
     std::map<std::string,std::map<std::string,HistMetadata> > mDoubleHist;
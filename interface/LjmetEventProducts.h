@@ -0,0 +1,115 @@
+#ifndef LJMet_Com_interface_LjmetEventProducts_h
+#define LJMet_Com_interface_LjmetEventProducts_h
+
+/*
+ Typed per-event products shared between calculators
+
+ A calculator declares the products of its ProduceEvent() in BeginJob()
+ with Produces(name), puts them with PutProduct(name, value) and other
+ calculators read them in AnalyzeEvent() with GetProduct<T>(name).
+
+ Producers run on demand: the first GetProduct of a product in an event
+ runs ProduceEvent() of its producer, which may itself read products of
+ other producers. So the order of the producers follows from what they
+ read, each runs at most once per event and a product nobody reads is
+ not computed. A producer read after the event selection sees the
+ selected objects. ProduceEvent() of a calculator that declares no
+ product runs before the selection as before.
+
+ A product is valid until the next event. Reading a product that no
+ calculator declares, with another type than it was put with, or in a
+ cycle of producers is a configuration error and ends the job. A
+ producer that is excluded or not requested is not built, a reader
+ that can do without it checks IsDeclared() first.
+ */
+
+#include <iostream>
+#include <map>
+#include <string>
+
+class BaseCalc;
+class BaseEventSelector;
+
+namespace edm {
+    class EventBase;
+}
+
+class LjmetEventProducts {
+public:
+    static LjmetEventProducts * GetInstance();
+    ~LjmetEventProducts();
+
+    /// Declare the producer of a product; exits if another calculator produces it
+    void Declare(std::string const & name, BaseCalc * producer);
+    /// True if the calculator declared products, it then runs on demand
+    bool IsProducer(BaseCalc const * calc) const;
+    /// True if a calculator of this job produces the product
+    bool IsDeclared(std::string const & name) const;
+
+    /// New event, the products of the previous one are gone
+    void BeginEvent(edm::EventBase const & event, BaseEventSelector * selector);
+
+    template <class T> void Put(std::string const & name, T const & value);
+    /// Product of the current event, produced first if it is not yet
+    template <class T> T const & Get(std::string const & name);
+
+private:
+    struct Holder {
+        virtual ~Holder() { }
+    };
+    template <class T> struct TypedHolder : public Holder {
+        T value;
+    };
+    struct Slot {
+        Slot(): producer(0), holder(0), event(0) { }
+        BaseCalc * producer;
+        Holder * holder;
+        /// event in which the product was put
+        unsigned long event;
+    };
+    struct ProducerState {
+        ProducerState(): event(0), running(false) { }
+        /// event in which the producer ran
+        unsigned long event;
+        bool running;
+    };
+
+    LjmetEventProducts();
+    LjmetEventProducts(LjmetEventProducts const &); // stop default
+
+    /// Slot of a product read in this event, running its producer if needed
+    Slot & produce(std::string const & name);
+    void runProducer(BaseCalc * producer, std::string const & name);
+    void wrongType(std::string const & name) const;
+
+    std::string mLegend;
+    std::map<std::string, Slot> mSlots;
+    std::map<BaseCalc const *, ProducerState> mProducers;
+    unsigned long mEvent;
+    edm::EventBase const * mpEvent;
+    BaseEventSelector * mpSelector;
+};
+
+
+
+template <class T>
+void LjmetEventProducts::Put(std::string const & name, T const & value)
+{
+    Slot & _slot = mSlots[name];
+    if (!_slot.holder) _slot.holder = new TypedHolder<T>();
+    TypedHolder<T> * _holder = dynamic_cast<TypedHolder<T> *>(_slot.holder);
+    if (!_holder) wrongType(name);
+    // assigned, the holder and its buffers are reused from event to event
+    _holder->value = value;
+    _slot.event = mEvent;
+}
+
+template <class T>
+T const & LjmetEventProducts::Get(std::string const & name)
+{
+    TypedHolder<T> * _holder = dynamic_cast<TypedHolder<T> *>(produce(name).holder);
+    if (!_holder) wrongType(name);
+    return _holder->value;
+}
+
+#endif
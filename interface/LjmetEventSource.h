@@ -0,0 +1,65 @@
+#ifndef LJMet_Com_interface_LjmetEventSource_h
+#define LJMet_Com_interface_LjmetEventSource_h
+
+/*
+ Events for the ljmet event loop
+ 
+ inputs.source selects the implementation:
+   "chain"      fwlite::ChainEvent over inputs.fileNames (default), or
+                with inputs.prefetchFiles > 0 the files are read ahead,
+                see LjmetFilePrefetcher.h
+   "synthetic"  generated miniAOD-like events, configured by the
+                untracked PSet inputs.synthetic, see LjmetSyntheticEvent.h
+ 
+ Entries are counted over the whole input, as in fwlite::ChainEvent.
+ */
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+#include "DataFormats/FWLite/interface/ChainEvent.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+class LjmetEventSource {
+public:
+    virtual ~LjmetEventSource() { }
+
+    /// source configured in the inputs parameter set, 0 if unknown
+    static LjmetEventSource * Create(edm::ParameterSet const & inputs);
+
+    virtual Long64_t Size() = 0;
+    virtual void ToBegin() = 0;
+    virtual bool AtEnd() const = 0;
+    virtual void Next() = 0;
+    /// go to an entry, false if there is no such entry
+    virtual bool To(Long64_t entry) = 0;
+    /// the current entry
+    virtual edm::EventBase const & GetEvent() = 0;
+    /// file of the current entry, 0 if it is not read from a file
+    virtual TFile * GetFile() { return 0; }
+    /// input statistics for the end of the job
+    virtual void Report(std::ostream & out) const { }
+};
+
+
+
+class LjmetChainEventSource : public LjmetEventSource {
+public:
+    LjmetChainEventSource(std::vector<std::string> const & fileNames);
+    virtual ~LjmetChainEventSource() { }
+
+    virtual Long64_t Size() { return mEvent.size(); }
+    virtual void ToBegin() { mEvent.toBegin(); }
+    virtual bool AtEnd() const { return mEvent.atEnd(); }
+    virtual void Next() { ++mEvent; }
+    virtual bool To(Long64_t entry) { return mEvent.to(entry); }
+    virtual edm::EventBase const & GetEvent() { return mEvent; }
+    virtual TFile * GetFile() { return mEvent.getTFile(); }
+
+private:
+    fwlite::ChainEvent mEvent;
+};
+
+#endif
@@ -4,11 +4,19 @@
 /*
  Singleton manager class for all calculators
  
+ Calculators and event selectors register a factory function, MakeCalc<T>
+ or MakeSelector<T>, from a static initializer. Only the event selector
+ the job asks for is built, and only the calculators that are requested
+ (ljmet.calculators, all if empty) and not excluded
+ (ljmet.excluded_calculators), when BuildCalcs() is called. A calculator
+ registered on request runs only if ljmet.calculators names it.
+ 
  Author: Gena Kukartsev, 2012
  */
 
 #include <iostream>
 #include <map>
+#include <set>
 #include "LJMet/Com/interface/BaseCalc.h"
 #include "LJMet/Com/interface/BaseEventSelector.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
@@ -20,6 +28,16 @@ public:
         if (!instance) instance = new LjmetFactory();
         return instance;
     }
+    typedef BaseCalc * (*CalcMaker)();
+    typedef BaseEventSelector * (*SelectorMaker)();
+    template <class T> static BaseCalc * MakeCalc() { return new T(); }
+    template <class T> static BaseEventSelector * MakeSelector() { return new T(); }
+    
+    /// Register a factory function, the object is built only if the job uses it,
+    /// on request only if the job names it in the requested calculators
+    int Register(CalcMaker maker, std::string name, bool onRequest = false);
+    int Register(SelectorMaker maker, std::string name);
+    /// Register an object built already
     int Register(BaseCalc * calc, std::string name);
     int Register(BaseEventSelector * calc, std::string name);
     
@@ -29,29 +47,50 @@ public:
     /// Loop over all registered calculators and compute implemented variables
     void RunAllCalculators(edm::EventBase const & event, BaseEventSelector * selector, LjmetEventContent & ec);
     
-    /// Loop over all registered calculators and run all producer methods (comes before selection)
+    /// Loop over all registered calculators and run all producer methods (comes before selection),
+    /// except those with declared products that run when the products are read
     void RunAllProducers(edm::EventBase const & event, BaseEventSelector * selector);
     
     /// Set each calc's parameter set, if present
     void SetAllCalcConfig(std::map<std::string, edm::ParameterSet const> mPar);
     void SetExcludedCalcs(std::vector<std::string> vExcl);
+    /// Run only these calculators, all if empty. Exit if one is not registered
+    void SetRequestedCalcs(std::vector<std::string> vCalcs);
+    
+    /// Build the requested and not excluded calculators, before the other calculator methods
+    void BuildCalcs();
     
     /// Run all BeginJob()'s
     void BeginJobAllCalc();
     
     /// Run all EndJob()'s
     void EndJobAllCalc();
+    
+    /// Running totals of the calculators that keep them, by name, for a checkpoint
+    std::map<std::string, std::vector<double> > GetAllCalcState() const;
+    /// Restore them in a resumed job, after BeginJob()
+    void SetAllCalcState(std::map<std::string, std::vector<double> > const & state);
+    
     void RunBeginEvent(edm::EventBase const & event, LjmetEventContent & ec);
     void RunEndEvent(edm::EventBase const & event, LjmetEventContent & ec);
     
 private:
     LjmetFactory();
     LjmetFactory(const LjmetFactory &); // stop default
+    /// Name given, or a generated one
+    std::string makeName(std::string const & name, std::string const & prefix, unsigned long number) const;
+    bool isCalcWanted(std::string const & name) const;
+    
     std::string mLegend;
+    std::map<std::string, CalcMaker> mCalcMakers;
+    std::map<std::string, SelectorMaker> mSelectorMakers;
     std::map<std::string, BaseCalc * > mpCalculators;
     std::map<std::string, BaseEventSelector * > mpSelectors;
     BaseEventSelector * theSelector;
     std::vector<std::string> mvExcludedCalcs;
+    std::vector<std::string> mvRequestedCalcs;
+    std::set<std::string> mOnRequestCalcs;
+    bool mCalcsBuilt;
     static LjmetFactory * instance;
 };
 
@@ -0,0 +1,114 @@
+#ifndef LJMet_Com_interface_LjmetFilePrefetcher_h
+#define LJMet_Com_interface_LjmetFilePrefetcher_h
+
+/*
+ Read-ahead of the ljmet input files
+
+ With inputs.prefetchFiles = N > 0 the input files are read by
+ LjmetPrefetchEventSource instead of fwlite::ChainEvent. While a file is
+ processed, a background thread opens the next N files, reads their
+ metadata (streamer info, Events tree, branch and basket lists) and
+ fills a TTreeCache with their first cluster, so that crossing a file
+ boundary does not wait for a remote open.
+
+ The caches of the files read ahead share inputs.prefetchMemory MB
+ (default 512), each file gets an equal part. The time the event loop
+ waits for a file, whether it was read ahead or not, is reported as
+ stall time at the end of the job.
+
+ Entries are counted over the whole input as in fwlite::ChainEvent, but
+ the size of a file is only looked up when it is needed, so the files
+ are not all opened at the start of the job.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TFile.h"
+#include "DataFormats/FWLite/interface/Event.h"
+#include "LJMet/Com/interface/LjmetEventSource.h"
+
+class LjmetFilePrefetcher {
+public:
+    LjmetFilePrefetcher(std::vector<std::string> const & fileNames, int nFiles, long long memoryBudget);
+    ~LjmetFilePrefetcher();
+
+    /// Opened input file, read ahead or opened now; the caller owns it.
+    /// The files following it are read ahead.
+    TFile * Get(unsigned int index);
+
+    /// Entries of a file, opened for them if it has not been opened before
+    Long64_t GetEntries(unsigned int index);
+
+    void Report(std::ostream & out) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Slot {
+        Slot(): file(0), ready(false) { }
+        TFile * file;
+        bool ready;
+    };
+
+    void run();
+    TFile * open(unsigned int index, bool warm);
+    void release(unsigned int first);
+
+    std::string mLegend;
+    std::vector<std::string> mvFileNames;
+    unsigned int mFiles;
+    long long mCacheSize;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::map<unsigned int, Slot> mSlots;
+    std::vector<Long64_t> mvEntries;
+    unsigned int mNext;
+    bool mStop;
+    std::thread mThread;
+
+    int mGets;
+    int mHits;
+    double mStallSeconds;
+    double mMaxStallSeconds;
+    long long mBytesAhead;
+};
+
+
+
+class LjmetPrefetchEventSource : public LjmetEventSource {
+public:
+    LjmetPrefetchEventSource(std::vector<std::string> const & fileNames, int nFiles, long long memoryBudget);
+    virtual ~LjmetPrefetchEventSource();
+
+    virtual Long64_t Size();
+    virtual void ToBegin();
+    virtual bool AtEnd() const { return mEvent == 0; }
+    virtual void Next();
+    virtual bool To(Long64_t entry);
+    virtual edm::EventBase const & GetEvent() { return *mEvent; }
+    virtual TFile * GetFile() { return mFile; }
+    virtual void Report(std::ostream & out) const { mPrefetcher.Report(out); }
+
+private:
+    /// Open a file, false if it has no entries
+    bool toFile(unsigned int index);
+    /// Open the first file with entries from index on, none if there is none
+    void toNonEmptyFile(unsigned int index);
+    void closeFile();
+
+    std::vector<std::string> mvFileNames;
+    LjmetFilePrefetcher mPrefetcher;
+    unsigned int mIndex;
+    TFile * mFile;
+    fwlite::Event * mEvent;
+};
+
+#endif
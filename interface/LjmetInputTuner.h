@@ -0,0 +1,78 @@
+#ifndef LJMet_Com_interface_LjmetInputTuner_h
+#define LJMet_Com_interface_LjmetInputTuner_h
+
+/*
+ TTreeCache tuning of the ljmet input files
+
+ The input branches the selector and calculators read are either declared
+ in inputs.branches (branch names, wildcards allowed) or learned from the
+ branches read during the first inputs.learnBranches events. For every
+ input file the TTreeCache is then sized to one cluster of these branches
+ and holds only them, without a learning phase of its own.
+
+ The other branches are left out of the cache but not disabled: FWLite
+ reads products branch by branch on request, so a branch nobody asks for
+ is never read, while a disabled branch would come back as an empty
+ product if a rarely taken code path asked for it after the warm-up.
+
+ Bytes read and event rate are reported for the events before and after
+ the cache was tuned.
+ */
+
+#include <chrono>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+#include "TTree.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+class LjmetInputTuner {
+public:
+    LjmetInputTuner(edm::ParameterSet const & inputs);
+
+    bool IsEnabled() const { return mLearnEvents > 0 || !mvDeclared.empty(); }
+
+    /// Call for every event, once it is read, with its input file (0 for none)
+    void Process(TFile * file);
+
+    void Report(std::ostream & out) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Window {
+        Window(): events(0), bytes(0), seconds(0.0) { }
+        long long events;
+        long long bytes;
+        double seconds;
+    };
+
+    TTree * getTree(TFile * file) const;
+    void learn(TTree * tree);
+    bool isActive(std::string const & branchName) const;
+    void tune(TTree * tree);
+    void printWindow(std::ostream & out, std::string const & name, Window const & window) const;
+
+    std::string mLegend;
+    int mLearnEvents;
+    long long mCacheSize;
+    std::vector<std::string> mvDeclared;
+    std::set<std::string> mLearned;
+
+    bool mTuned;
+    TFile * mFile;
+    std::string mFileName;
+    int mBranches;
+    int mActiveBranches;
+    long long mTunedCacheSize;
+
+    long long mEvents;
+    long long mStartBytes;
+    Clock::time_point mStartTime;
+    Window mBefore;
+};
+
+#endif
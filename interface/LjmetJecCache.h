@@ -0,0 +1,70 @@
+#ifndef LJMet_Com_interface_LjmetJecCache_h
+#define LJMet_Com_interface_LjmetJecCache_h
+
+/*
+ Binary cache of jet energy correction parameters
+
+ Every job parses the L1/L2/L3/residual text files of the JEC. The
+ parsing goes through stringstreams, one float at a time, and costs a
+ noticeable part of a short job. ljmet-jec-compile parses the text files
+ once and writes their records as floats into one binary file. A job
+ memory-maps that file and builds the JetCorrectorParameters straight
+ from it.
+
+ The file starts with a format version and a checksum of its contents.
+ If the version is not the current one, the checksum does not match, or
+ a text file is not in the cache, the text file is parsed as before.
+ An entry is found by the text file name, without the directory, and
+ the JEC section. It also stores the size of its text file. If the text
+ file is present with another size, the entry is treated as stale.
+
+ usage: ljmet-jec-compile <cache> <text file>[:section] ...
+ */
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "CondFormats/JetMETObjects/interface/JetCorrectorParameters.h"
+
+class LjmetJecCache {
+public:
+    /// Map the cache file, an empty name or an invalid file leaves the cache empty
+    explicit LjmetJecCache(std::string const & fileName);
+    ~LjmetJecCache();
+
+    /// Parameters of a JEC text file, from the cache if it holds them
+    JetCorrectorParameters Load(std::string const & txtFile, std::string const & section = "");
+
+    /// Time spent in Load and where the parameters came from
+    void Report(std::ostream & out) const;
+
+    /// Parse the text files, "file" or "file:section", and write the cache, false on failure
+    static bool Write(std::string const & fileName, std::vector<std::string> const & txtFiles);
+
+private:
+    struct Entry {
+        std::string name;
+        std::string section;
+        unsigned long long txtSize;
+        /// offset of the parameters in the mapped file
+        std::size_t offset;
+    };
+
+    LjmetJecCache(LjmetJecCache const &); // stop default
+
+    bool map(std::string const & fileName);
+    Entry const * find(std::string const & txtFile, std::string const & section) const;
+
+    std::string mLegend;
+    std::string mFileName;
+    char const * mpData;
+    std::size_t mSize;
+    std::vector<Entry> mvEntries;
+
+    unsigned int mFromCache;
+    unsigned int mFromText;
+    double mSeconds;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef LJMet_Com_interface_LjmetLeptonId_h
+#define LJMet_Com_interface_LjmetLeptonId_h
+
+/*
+ Lepton identification over whole collections
+
+ The lepton selectors evaluate their ID one lepton at a time through
+ Selector<>::operator() and the strbitset bookkeeping, once for each
+ working point. LjmetLeptonId copies the variables the IDs cut on
+ (isolation, impact parameters, hits, shower shape, ...) into one array
+ per variable once per event, then evaluates the working points cut by
+ cut over all leptons. Each cut is a loop of comparisons without
+ branches over one array, which the compiler can vectorize. The result is
+ one mask per working point, bit i set when lepton i passes.
+
+ The working points are read from configured selectors, so versions
+ and cutsToIgnore keep their meaning:
+   PFMuonSelector       TOPPAG12_LJETS, TOPPAG12_LJETS_MOD, TOPPAG12_LJETS_VETO
+   TopElectronSelector  all versions but HEEP
+ A muon working point can also be the tight (w.r.t. the PV) or loose
+ ID of pat::Muon with a relative isolation cut. The muon working points
+ and, if given, the electron ones have the pt and |eta| cuts the event
+ selectors apply after the ID.
+
+ A lepton passes a cut of a working point as in the selectors:
+   ignored cut                       pass
+   barrel electron                   the _EB cut
+   endcap electron                   the _EE cut
+   electron neither EB nor EE        pass only if both cuts are ignored
+ */
+
+#include <string>
+#include <vector>
+
+#include "DataFormats/Common/interface/Ptr.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "FWCore/Common/interface/EventBase.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "LJMet/Com/interface/PFMuonSelector.h"
+#include "LJMet/Com/interface/TopElectronSelector.h"
+
+class LjmetLeptonId {
+public:
+    /// Bit i%64 of word i/64 is set when lepton i passes
+    typedef std::vector<unsigned long long> Mask;
+
+    LjmetLeptonId();
+
+    /// Working point of a PFMuonSelector, its index
+    int AddMuonWorkingPoint(PFMuonSelector const & selector, double minPt, double maxEta);
+    /// Tight ID of pat::Muon w.r.t. the first PV, or its loose ID, with pfRelIso < maxRelIso
+    int AddMuonWorkingPoint(bool tight, double maxRelIso, double minPt, double maxEta);
+    /// Working point of a TopElectronSelector, its index, -1 for HEEP or
+    /// for PV and rho inputs other than those of the first working point
+    int AddElectronWorkingPoint(TopElectronSelector const & selector);
+    int AddElectronWorkingPoint(TopElectronSelector const & selector, double minPt, double maxEta);
+
+    /// Evaluate all muon working points, pv for the tight ID of pat::Muon
+    void EvaluateMuons(std::vector<pat::Muon> const & muons, reco::Vertex const * pv);
+    /// Evaluate all electron working points, the PV and rho are read from the event
+    void EvaluateElectrons(std::vector<pat::Electron> const & electrons, edm::EventBase const & event);
+    void EvaluateElectrons(std::vector<edm::Ptr<pat::Electron> > const & electrons, edm::EventBase const & event);
+
+    Mask const & GetMuonMask(int wp) const { return mvMuonMasks[wp]; }
+    Mask const & GetElectronMask(int wp) const { return mvElectronMasks[wp]; }
+    bool PassMuon(int wp, unsigned int i) const { return Test(mvMuonMasks[wp], i); }
+    bool PassElectron(int wp, unsigned int i) const { return Test(mvElectronMasks[wp], i); }
+
+    static bool Test(Mask const & mask, unsigned int i) { return (mask[i >> 6] >> (i & 63)) & 1; }
+
+private:
+    enum MuonColumn { muGlobal, muTracker, muGlobalOrTracker, muChi2, muTrackerLayers, muValidMuHits,
+                      muIp, muPixelHits, muStations, muRelIso, muTightPv, muLoose, muPt, muAbsEta, muNColumns };
+    enum ElectronColumn { elValid, elDeta, elDphi, elSihih, elHoE, elD0, elDz, elOoemoop, elRelIso,
+                          elMissingHits, elConvVeto, elPt, elAbsEta, elNColumns };
+    enum Op { opLess, opLessEqual, opGreater, opGreaterEqual };
+    /// Lepton region, the muons are all in the barrel
+    enum Region { regionEB, regionEE, regionNone, nRegions };
+
+    struct Cut {
+        Cut(int column, int op, double value);
+        int column;
+        int op;
+        double value[nRegions];
+        /// 1 where the cut is ignored
+        unsigned char skip[nRegions];
+        /// 0 where a lepton fails unless the cut is ignored
+        unsigned char test[nRegions];
+    };
+    typedef std::vector<Cut> WorkingPoint;
+
+    /// Flag that must be set, in all regions
+    void addFlag(WorkingPoint & wp, bool considered, int column);
+    /// Cut of a selector applied in all regions
+    template <class T, class S>
+    void addSelectorCut(WorkingPoint & wp, S const & selector, std::string const & name, int column, int op);
+    /// Cut of a selector with _EB and _EE values
+    template <class T, class S>
+    void addRegionCut(WorkingPoint & wp, S const & selector, std::string const & name, int column, int op);
+
+    void resize(std::vector<std::vector<double> > & columns, unsigned int n);
+    void fillMuon(unsigned int i, pat::Muon const & muon, reco::Vertex const * pv);
+    void fillElectron(unsigned int i, pat::Electron const & electron);
+    void readElectronInputs(edm::EventBase const & event);
+    void evaluate(std::vector<WorkingPoint> const & wps, std::vector<std::vector<double> > const & columns,
+                  unsigned int n, std::vector<Mask> & masks);
+
+    std::vector<WorkingPoint> mvMuonWps;
+    std::vector<WorkingPoint> mvElectronWps;
+    /// the tight and loose IDs of pat::Muon are only computed if cut on
+    bool mMuonTightPv;
+    bool mMuonLoose;
+    edm::InputTag mPvSrc;
+    edm::InputTag mRhoSrc;
+
+    // per event, reused
+    std::vector<std::vector<double> > mvMuonColumns;
+    std::vector<std::vector<double> > mvElectronColumns;
+    std::vector<int> mvRegions;
+    std::vector<unsigned char> mvPass;
+    std::vector<Mask> mvMuonMasks;
+    std::vector<Mask> mvElectronMasks;
+    reco::Vertex::Point mPv;
+    double mRho;
+};
+
+#endif
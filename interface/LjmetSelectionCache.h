@@ -0,0 +1,102 @@
+#ifndef LJMet_Com_interface_LjmetSelectionCache_h
+#define LJMet_Com_interface_LjmetSelectionCache_h
+
+/*
+ Sidecar file with the event selection result of an ljmet job
+ 
+ For every event passing the selection, the entry in the input chain,
+ the selector pass bits, the indices of the objects the selector keeps
+ in their input collections, whether it set the MET and type-1
+ corrected MET, and the corrected jets and MET. A later job on the
+ same inputs reads it back instead of running the selector, visits only
+ the passing entries and runs the calculators on the restored objects.
+ 
+ The file also holds the input file names, skipEvents, nEvents, the
+ number of events processed and the cut flow of the job that wrote it;
+ they are written on Close(), so a file without them is incomplete.
+ A job reading it must have the same input files, skipEvents and
+ nEvents.
+ */
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+#include "TTree.h"
+
+class LjmetSelectionCache {
+public:
+    struct Record {
+        Long64_t entry;
+        std::vector<bool> passBits;
+        std::vector<int> muons;
+        std::vector<int> looseMuons;
+        std::vector<int> allMuons;
+        std::vector<int> electrons;
+        std::vector<int> looseElectrons;
+        std::vector<int> allElectrons;
+        std::vector<int> jets;
+        std::vector<int> looseJets;
+        std::vector<int> allJets;
+        std::vector<int> bJets;
+        std::vector<int> pvs;
+        std::vector<int> triggers;
+        bool met;                       // MET is set
+        bool type1CorrMet;              // type-1 corrected MET is set
+        std::vector<double> corrJetPx;
+        std::vector<double> corrJetPy;
+        std::vector<double> corrJetPz;
+        std::vector<double> corrJetE;
+        std::vector<bool> corrJetBTag;
+        double corrMet[4];              // px, py, pz, E
+    };
+    
+    LjmetSelectionCache();
+    ~LjmetSelectionCache();
+    
+    /// Create a new cache file
+    bool Create(std::string const & fileName);
+    /// Open a complete cache file for reading
+    bool Open(std::string const & fileName);
+    
+    /// Append the record of a passing event
+    void Fill(Record const & record);
+    /// Write the job summary and close the file
+    void Close(std::vector<std::string> const & fileNames, int skipEvents, int nEvents, Long64_t processed, std::vector<size_t> const & cutFlow);
+    
+    Long64_t GetEntries() const { return mpTree ? mpTree->GetEntries() : 0; }
+    /// Read record i, valid until the next call
+    Record const & GetRecord(Long64_t i);
+    
+    /// Job summary of a cache opened for reading
+    std::vector<std::string> const & GetFileNames() const { return mvFileNames; }
+    int GetSkipEvents() const { return mSkipEvents; }
+    int GetNEvents() const { return mNEvents; }
+    Long64_t GetProcessed() const { return mProcessed; }
+    std::vector<size_t> GetCutFlow() const { return std::vector<size_t>(mvCutFlow.begin(), mvCutFlow.end()); }
+    
+private:
+    LjmetSelectionCache(LjmetSelectionCache const &);
+    LjmetSelectionCache & operator=(LjmetSelectionCache const &);
+    
+    void setBranches(bool create);
+    template <class T> void vectorBranch(bool create, char const * name, std::vector<T> & value, std::list<std::vector<T>*> & addresses);
+    
+    std::string mLegend;
+    TFile * mpFile;
+    TTree * mpTree;
+    Record mRecord;
+    // stable addresses of the vector branches
+    std::list<std::vector<int>*> mlIntAddresses;
+    std::list<std::vector<bool>*> mlBoolAddresses;
+    std::list<std::vector<double>*> mlDoubleAddresses;
+    
+    std::vector<std::string> mvFileNames;
+    int mSkipEvents;
+    int mNEvents;
+    Long64_t mProcessed;
+    std::vector<Long64_t> mvCutFlow;
+};
+
+#endif
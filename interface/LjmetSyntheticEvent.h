@@ -0,0 +1,151 @@
+#ifndef LJMet_Com_interface_LjmetSyntheticEvent_h
+#define LJMet_Com_interface_LjmetSyntheticEvent_h
+
+/*
+ Generated miniAOD-like events for throughput tests of selectors and
+ calculators without input files
+ 
+ Every entry holds, under the miniAOD labels by default,
+   offlineSlimmedPrimaryVertices  std::vector<reco::Vertex>
+   packedPFCandidates             std::vector<pat::PackedCandidate>, the jet constituents
+   slimmedMuons                   std::vector<pat::Muon>
+   slimmedElectrons               std::vector<pat::Electron>
+   slimmedJets                    std::vector<pat::Jet>, with constituents, JEC levels,
+                                  b tag discriminators and parton flavour
+   slimmedJetsAK8                 std::vector<pat::Jet>, the hard jets merged with
+                                  their neighbours within dR < 0.8
+   slimmedMETs                    std::vector<pat::MET>
+   TriggerResults::HLT            edm::TriggerResults of the configured paths
+   selectedPatTrigger             pat::TriggerObjectStandAloneCollection, empty
+   prunedGenParticles             reco::GenParticleCollection, a semileptonic ttbar
+                                  decay chain and stable particles
+   slimmedGenJets                 reco::GenJetCollection, the smeared jets
+   fixedGridRhoAll                double
+ Multiplicities are Poisson distributed around configurable means. The
+ generator is seeded per entry, so an entry is the same event whenever it
+ is visited, and skipping, checkpoint resume and selection cache replay
+ work as with files.
+ 
+ Detector-level inputs of the identification (tracks, hits, superclusters)
+ are not generated: the muon selector cuts on them have to be ignored, and
+ electrons cannot be passed through the electron selector.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "TRandom3.h"
+#include "DataFormats/Common/interface/EventBase.h"
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include "DataFormats/Common/interface/Wrapper.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticleFwd.h"
+#include "DataFormats/JetReco/interface/GenJetCollection.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/PatCandidates/interface/Jet.h"
+#include "DataFormats/PatCandidates/interface/MET.h"
+#include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/PatCandidates/interface/PackedCandidate.h"
+#include "DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h"
+#include "DataFormats/Provenance/interface/EventAuxiliary.h"
+#include "DataFormats/Provenance/interface/ProcessHistory.h"
+#include "DataFormats/Provenance/interface/Provenance.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "FWCore/Common/interface/TriggerNames.h"
+#include "FWCore/Common/interface/TriggerResultsByName.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "LJMet/Com/interface/LjmetEventSource.h"
+
+class LjmetSyntheticEvent : public edm::EventBase {
+public:
+    LjmetSyntheticEvent(edm::ParameterSet const & par);
+    virtual ~LjmetSyntheticEvent();
+
+    /// Replace the products by those of an entry
+    void Generate(Long64_t entry);
+
+    virtual edm::EventAuxiliary const & eventAuxiliary() const { return mAux; }
+    virtual edm::TriggerNames const & triggerNames(edm::TriggerResults const & triggerResults) const { return mTriggerNames; }
+    virtual edm::TriggerResultsByName triggerResultsByName(std::string const & process) const;
+    virtual edm::ProcessHistory const & processHistory() const { return mHistory; }
+
+private:
+    virtual edm::BasicHandle getByLabelImpl(std::type_info const & iWrapperType, std::type_info const & iProductType, edm::InputTag const & iTag) const;
+    virtual edm::BasicHandle getImpl(std::type_info const & iProductType, edm::ProductID const & iID) const;
+
+    /// New empty product, filled by the caller
+    template <class T> T & put(edm::InputTag const & tag);
+    void clear();
+
+    void generateVertices(std::vector<reco::Vertex> & vertices);
+    void generateJets(std::vector<reco::Vertex> const & vertices, std::vector<pat::PackedCandidate> & packed, std::vector<pat::Jet> & jets);
+    void generateFatJets(std::vector<pat::Jet> const & jets, std::vector<pat::Jet> & fatJets);
+    void generateLeptons(std::vector<reco::Vertex> const & vertices, std::vector<pat::Muon> & muons, std::vector<pat::Electron> & electrons);
+    void generateMet(std::vector<reco::Vertex> const & vertices, std::vector<pat::Jet> const & jets, std::vector<pat::Muon> const & muons, std::vector<pat::Electron> const & electrons, std::vector<pat::MET> & mets);
+    void generateTrigger(edm::TriggerResults & results);
+    void generateGenParticles(reco::GenParticleCollection & particles);
+    void generateGenJets(std::vector<pat::Jet> const & jets, reco::GenJetCollection & genJets);
+
+    std::string mLegend;
+
+    unsigned int mSeed;
+    bool mIsMc;
+    double mMeanVertices;
+    double mMeanMuons;
+    double mMeanElectrons;
+    double mMeanJets;
+    double mMeanConstituents;
+    double mBJetFraction;
+    double mFatJetMinPt;
+    double mMeanMet;
+    double mMeanGenParticles;
+    double mTriggerEfficiency;
+    std::vector<std::string> mvBTaggers;
+
+    edm::InputTag mVertexTag;
+    edm::InputTag mPackedTag;
+    edm::InputTag mMuonTag;
+    edm::InputTag mElectronTag;
+    edm::InputTag mJetTag;
+    edm::InputTag mFatJetTag;
+    edm::InputTag mMetTag;
+    edm::InputTag mTriggerTag;
+    edm::InputTag mTriggerObjectTag;
+    edm::InputTag mGenParticleTag;
+    edm::InputTag mGenJetTag;
+    edm::InputTag mRhoTag;
+
+    TRandom3 mRandom;
+    std::map<std::string, edm::WrapperBase *> mProducts;
+
+    edm::EventAuxiliary mAux;
+    edm::ParameterSet mTriggerPSet;
+    edm::TriggerNames mTriggerNames;
+    edm::ProcessHistory mHistory;
+    edm::Provenance mProvenance;
+};
+
+
+
+class LjmetSyntheticEventSource : public LjmetEventSource {
+public:
+    LjmetSyntheticEventSource(edm::ParameterSet const & par);
+    virtual ~LjmetSyntheticEventSource() { }
+
+    virtual Long64_t Size() { return mEntries; }
+    virtual void ToBegin() { To(0); }
+    virtual bool AtEnd() const { return mEntry >= mEntries; }
+    virtual void Next() { To(mEntry + 1); }
+    virtual bool To(Long64_t entry);
+    /// generates the entry on first access
+    virtual edm::EventBase const & GetEvent();
+
+private:
+    LjmetSyntheticEvent mEvent;
+    Long64_t mEntries;
+    Long64_t mEntry;
+    bool mGenerated;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef LJMet_Com_interface_NeutrinoSolver_h
+#define LJMet_Com_interface_NeutrinoSolver_h
+
+/*
+  Neutrino pz from the W mass constraint on a lepton + MET pair
+
+  One call returns both roots of the quadratic, the root picked by every
+  selection policy of METzCalculator, the rescaled neutrino pT for
+  complex roots, and the D0-style solution where the MET is scaled down
+  until the transverse mass does not exceed the W mass.
+
+  Works on plain numbers. Solve() keeps the last few results, so
+  calculators asking for the same lepton/MET pair within an event get
+  the cached solution. The solution is returned by value and each thread
+  has its own solver, so the memo is never shared between threads.
+*/
+
+
+
+class NeutrinoSolver {
+
+ public:
+
+  /// root selection policies, same numbering as METzCalculator::Calculate(type)
+  enum Policy {
+    nearestLeptonOrCentral = 0, // nearest to lepton pz, most central if that is above 300 GeV
+    nearestLepton          = 1, // nearest to lepton pz
+    mostCentral            = 2, // smallest |pz|
+    maxCosine              = 3, // largest cos(theta*) of the lepton in the W frame
+    nPolicies              = 4
+  };
+
+  struct Input {
+    double lepPx, lepPy, lepPz, lepE;
+    double metPx, metPy, metE;
+    double leptonMass;
+    double mW;
+  };
+
+  struct Solution {
+    bool isComplex;
+    /// roots (-B+sqrt(D))/2A and (-B-sqrt(D))/2A, both the real part if complex
+    double pz[2];
+    /// complex roots only: neutrino pT for which the discriminant vanishes,
+    /// [0] is the one closest to the MET pT
+    double ptNu[2];
+    /// root picked by each policy, and the other root
+    double best[nPolicies];
+    double other[nPolicies];
+
+    /// D0 style: MET px, py scaled by mtScale (1 if mT(l,MET) < mW),
+    /// massless lepton, negative discriminant clamped to 0,
+    /// mtPz[0] is the root with the smaller |pz|
+    double mtScale;
+    double mtPx, mtPy;
+    double mtPz[2];
+  };
+
+  NeutrinoSolver();
+
+  /// Solver of the calling thread, so that the memo is shared by all calculators
+  static NeutrinoSolver * GetInstance();
+
+  /// Solve one lepton/MET pair, served from the memo if it was solved recently
+  Solution Solve(const Input & in);
+
+  /// Solve n pairs, no memo
+  static void Solve(unsigned int n, const Input * in, Solution * out);
+
+  /// Solve one pair, no memo
+  static void Compute(const Input & in, Solution & out);
+
+ private:
+
+  static const unsigned int memoSize = 4;
+  Input memoInput[memoSize];
+  Solution memoSolution[memoSize];
+  unsigned int memoUsed;
+  unsigned int memoNext;
+};
+
+
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef LJMet_Com_interface_NsubjettinessEngine_h
+#define LJMet_Com_interface_NsubjettinessEngine_h
+
+/*
+ N-subjettiness tau_1..tau_N of one jet in a single call
+
+ Same definitions as Njettiness.hh (kt_axes and onepass_kt_axes modes),
+ but the constituents are taken as SoA arrays, the exclusive-kt seeds for
+ all N come from one clustering sequence, and particle-axis distance
+ columns are shared between the N values whenever the (seed) axes
+ coincide. All work buffers are kept between calls.
+
+ */
+
+#include <limits>
+#include <vector>
+
+#include "fastjet/PseudoJet.hh"
+
+class NsubjettinessEngine {
+public:
+    enum AxesMode {
+        kt_axes,         // exclusive kt axes
+        onepass_kt_axes  // one-pass minimization from kt starting point
+    };
+
+    NsubjettinessEngine(AxesMode axes, double beta, double R0, double Rcutoff = std::numeric_limits<double>::max());
+
+    /// Compute tau_1..tau_nMax for n constituents, result written to tau[0..nMax-1]
+    void GetTaus(unsigned int nMax,
+                 const double * px, const double * py, const double * pz, const double * e,
+                 unsigned int n,
+                 double * tau);
+
+private:
+    /// Fill particle pt/rap/phi arrays and the pseudojets for clustering
+    void setParticles(const double * px, const double * py, const double * pz, const double * e, unsigned int n);
+    /// Return the cached distance^2 column for an axis, compute it if needed
+    const double * distanceColumn(double rap, double phi);
+    /// Nearest axis and its distance^2 for every particle
+    void assign(unsigned int nAxes, const double * axRap, const double * axPhi);
+    /// tau for the current assignment
+    double tauValue() const;
+    /// One-pass k-means minimization starting from the given axes (in place)
+    void minimizeAxes(unsigned int nAxes, double * axRap, double * axPhi, double * axMom);
+
+    AxesMode mAxes;
+    double mBeta;
+    double mR0;
+    double mRcutoff;
+    double mPrecision;
+    int mHalt;
+
+    unsigned int mN;
+    double mTauDen;
+    std::vector<double> mPt;
+    std::vector<double> mRap;
+    std::vector<double> mPhi;
+    std::vector<double> mPx;
+    std::vector<double> mPy;
+    std::vector<double> mPz;
+    std::vector<fastjet::PseudoJet> mPseudoJets;
+
+    // distance^2 columns, keyed by axis (rap, phi)
+    std::vector<double> mColumns;
+    std::vector<double> mColumnRap;
+    std::vector<double> mColumnPhi;
+    unsigned int mNColumns;
+
+    // nearest axis assignment
+    std::vector<double> mMinDist2;
+    std::vector<int> mAssign;
+    std::vector<double> mWeight;
+
+    // current axes
+    std::vector<double> mAxRap;
+    std::vector<double> mAxPhi;
+    std::vector<double> mAxMom;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef LJMet_Com_interface_PdfWeightEngine_h
+#define LJMet_Com_interface_PdfWeightEngine_h
+
+/*
+  PDF weights for all members of all configured PDF sets in one sweep
+
+  At beginJob() every member of every set is tabulated once on a grid in
+  logit(x) and log(Q), with all members of a grid point stored next to
+  each other. Per event the interpolation stencil is located once per
+  parton and applied to all members in a single vectorizable loop, so
+  there is no LHAPDF member switching in the event loop.
+
+  Points outside the grid (or top quarks) fall back to direct LHAPDF calls.
+*/
+
+
+
+#include <string>
+#include <vector>
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+
+
+class PdfWeightEngine {
+
+ public:
+
+  explicit PdfWeightEngine(const edm::ParameterSet&);
+  ~PdfWeightEngine();
+
+  /// Initialize LHAPDF sets and tabulate all members
+  void beginJob();
+
+  /// Total number of weights (all members of all sets)
+  unsigned int GetNWeights() const { return nWeights_; }
+  unsigned int GetNSets() const { return pdfSetNames_.size(); }
+  std::string const & GetShortName(unsigned int set) const { return pdfShortNames_[set]; }
+  /// Index of the central member of a set in the weight array
+  unsigned int GetOffset(unsigned int set) const { return offsets_[set]; }
+  unsigned int GetNMembers(unsigned int set) const { return nMembers_[set]; }
+
+  /// Fill weights[GetNWeights()] with xf_i(x1) xf_i(x2) / (xf_0(x1) xf_0(x2)) per set.
+  /// Returns false if the event fell back to direct LHAPDF calls
+  bool GetWeights(double x1, int id1, double x2, int id2, double Q, float * weights);
+
+  /// Same as GetWeights(), evaluated member by member with LHAPDF (reference)
+  void GetWeightsDirect(double x1, int id1, double x2, int id2, double Q, float * weights);
+
+ private:
+
+  bool onGrid(double x, int id, double Q) const;
+  /// xf(x,Q) for parton id, all members of all sets
+  void interpolate(double x, int id, double Q, double * xf) const;
+  void fillWeights(const double * xf1, const double * xf2, float * weights) const;
+
+  std::vector<std::string> pdfSetNames_;
+  std::vector<std::string> pdfShortNames_;
+  std::vector<unsigned int> offsets_;
+  std::vector<unsigned int> nMembers_;
+  unsigned int nWeights_;
+
+  // grid: uniform in u = log(x/(1-x)) and l = log(Q)
+  int nX_;
+  int nQ_;
+  double xMin_;
+  double xMax_;
+  double qMin_;
+  double qMax_;
+  double uMin_;
+  double du_;
+  double lMin_;
+  double dl_;
+
+  // table_[((flavour*nQ_ + iq)*nX_ + ix)*nWeights_ + member], flavour = id+5
+  std::vector<float> table_;
+
+  // per-event work arrays
+  std::vector<double> xf1_;
+  std::vector<double> xf2_;
+};
+
+
+
+#endif
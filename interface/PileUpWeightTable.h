@@ -0,0 +1,60 @@
+#ifndef LJMet_Com_interface_PileUpWeightTable_h
+#define LJMet_Com_interface_PileUpWeightTable_h
+
+/*
+  Pileup weights for any number of data scenarios in one table
+
+  Each column is data/MC for one data distribution (a scenario or its
+  up/down variation), both normalized to unit area, with the same
+  binning as edm::LumiReWeighting: bin i covers nTrue in [i-0.5, i+0.5).
+  The weights of all columns for one nTrue bin are stored next to each
+  other, so one lookup returns every scenario. Out-of-range nTrue gets
+  weight 0, as in edm::LumiReWeighting.
+*/
+
+
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+
+
+class PileUpWeightTable {
+
+ public:
+
+  PileUpWeightTable();
+
+  void SetMCDistribution(std::vector<double> const & mc);
+  /// Add a weight column, name is used as the branch name
+  void AddScenario(std::string const & name, std::vector<double> const & data);
+
+  /// Compute the table from the distributions
+  void Initialize();
+
+  unsigned int GetNColumns() const { return names_.size(); }
+  unsigned int GetNBins() const { return nBins_; }
+  std::string const & GetName(unsigned int column) const { return names_[column]; }
+
+  /// Weights of all columns for nTrue, GetNColumns() values
+  const double * GetWeights(float nTrue) const {
+    int _bin = (int)std::floor(nTrue + 0.5f);
+    if (_bin < 0 || _bin >= (int)nBins_) _bin = nBins_;
+    return table_.data() + _bin*names_.size();
+  }
+
+ private:
+
+  unsigned int nBins_;
+  std::vector<double> mc_;
+  std::vector<std::string> names_;
+  std::vector<std::vector<double> > data_;
+
+  // table_[bin*nColumns + column], one extra row of zeros for out-of-range nTrue
+  std::vector<double> table_;
+};
+
+
+
+#endif
@@ -26,6 +26,9 @@ public: // interface
     
     void setUseData(const bool &flag) { runData_ = flag; }
     enum Version_t { VETO, LOOSE, MEDIUM, TIGHT, NONE, HEEP, N_VERSIONS};
+    Version_t version() const { return version_; }
+    edm::InputTag const & pvSrc() const { return pvSrc_; }
+    edm::InputTag const & rhoSrc() const { return rhoSrc_; }
     TopElectronSelector() {}
     
     
@@ -32,7 +32,7 @@
 	// Constructor, destructor:
         template<class Container>
 	TopTopologicalVariables(const Container& objects) 
-	  : _pv (0)
+	  : _pvOK (false)
         {
             copy(objects.begin(), objects.end(), back_inserter(_myobjects));
         }
@@ -79,7 +79,8 @@
         typedef std::vector<TMBLorentzVector>::const_iterator Iterator;
 	std::vector<TMBLorentzVector> _myobjects;
     
-        mutable TVectorD *_pv; // internal representation: can change even for a const object
+        mutable double _pv[3]; // internal representation: can change even for a const object
+        mutable bool _pvOK;
         void ensurePV() const; // will calculate the eigen values (_pv) if it hasn't been done yet
 
      //ClassDef(TopTopologicalVariables,1) // top topological variables
@@ -6,7 +6,7 @@ DileptonCalc = cms.PSet (
                          isMc         = cms.bool(False),
                          dataType     = cms.string('ElMu'),
 #                         rhoSrc       = cms.InputTag("fixedGridRhoAll", "rho"),
-                         pvCollection = cms.InputTag("offlineSlimmedPrimaryVertices"),
+#                         pvCollection = cms.InputTag("offlineSlimmedPrimaryVertices"), # default: primaryVertices of CommonCalc
                          genParticles = cms.InputTag("prunedGenParticles"),
                          keepPDGID    = cms.vuint32(8000001, 11, 12, 13, 14, 15, 16),
                          keepMomPDGID = cms.vuint32(6, 24, 8000001),
@@ -25,5 +25,10 @@ defaultHitFitParameters = cms.PSet(
     hitfitMinJetPt           = cms.untracked.double(15.0),
     hitfitMinMET             = cms.untracked.double(0.0),
     hitfitUseNLeadJets       = cms.untracked.bool(False),
-    hitfitMaxNJet            = cms.untracked.uint32(5)
+    hitfitMaxNJet            = cms.untracked.uint32(5),
+    hitfitNWorkers           = cms.untracked.uint32(1),     # fit threads per event, 0 - one per core
+    hitfitBTagPruning        = cms.untracked.int32(0),      # 0 - fit all permutations, 1 - up to 2 tags: tagged jets are b's, 2 - also both b's tagged with more tags
+    hitfitMaxPreFitChi2      = cms.untracked.double(0.0),   # skip permutations with unfitted mass chi2 above this, 0 - off; not lossless, can change the best fit
+    hitfitCheckPreFitChi2    = cms.untracked.bool(False),   # also fit the skipped permutations and report the events whose best fit the cut drops
+    hitfitPreFitJetResolution = cms.untracked.double(0.1)   # jet energy resolution for the pre-fit chi2
     )
@@ -15,5 +15,12 @@ JetSubCalc = cms.PSet(
                       slimmedJetColl     = cms.InputTag("slimmedJets"),
                       slimmedJetsAK8Coll = cms.InputTag("slimmedJetsAK8"),
                       bDiscriminant      = cms.string("combinedInclusiveSecondaryVertexV2BJetTags"),
-                      tagInfo            = cms.string("caTop")
+                      tagInfo            = cms.string("caTop"),
+                      # recompute tau1..tau3 from AK8 constituents (onepass kt axes, beta=1, R0=0.8)
+                      recomputeNsubjettiness = cms.bool(False),
+                      # constituent output: "double" (per-constituent vectors with mother index),
+                      # "float" or "int16" (per-jet DaughterOffset plus flat float or 16-bit packed
+                      # vectors, see interface/ConstituentPacking.h), or "summary" (pT-D and tau
+                      # ratios per jet, no constituents)
+                      constituentFormat = cms.string("double")
                       )
@@ -1,3 +1,6 @@
 import FWCore.ParameterSet.Config as cms
 
-CommonCalc = cms.PSet( )
+CommonCalc = cms.PSet(
+                      # PVs shared with the other calculators as primaryVertices, not selected
+                      pvCollection = cms.InputTag("offlineSlimmedPrimaryVertices")
+                      )
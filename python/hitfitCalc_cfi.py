@@ -0,0 +1,6 @@
+import FWCore.ParameterSet.Config as cms
+
+from LJMet.Com.HitFitParameters_cfi import defaultHitFitParameters
+
+# HitFitCalc runs only if it is named in process.ljmet.calculators
+HitFitCalc = defaultHitFitParameters.clone()
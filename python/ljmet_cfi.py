@@ -4,5 +4,8 @@ ljmet = cms.PSet(
                  isMc      = cms.bool(True),
                  verbosity = cms.int32(0),
                  runs                 = cms.vint32([]),
-                 excluded_calculators = cms.vstring()
+                 excluded_calculators = cms.vstring(),
+                 # only these calculators are built and run, all if empty;
+                 # PdfCalc, PileUpCalc and HitFitCalc run only when named here
+                 calculators          = cms.vstring()
                  )
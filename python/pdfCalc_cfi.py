@@ -1,5 +1,6 @@
 import FWCore.ParameterSet.Config as cms
 
+# PdfCalc runs only if it is named in process.ljmet.calculators
 PdfCalc = cms.PSet(
     # Fix POWHEG if buggy (this PDF set will also appear on output,
     # so only two more PDF sets can be added in PdfSetNames if not "")
@@ -10,5 +11,14 @@ PdfCalc = cms.PSet(
         "cteq66.LHgrid"
         , "MRST2006nnlo.LHgrid"
         , "NNPDF10_100.LHgrid"
-        )
+        ),
+    # interpolate all PDF members from a table made at BeginJob
+    # instead of calling LHAPDF member by member in every event
+    useGridInterpolation = cms.untracked.bool(False),
+    #PdfGridNX   = cms.untracked.int32(100),
+    #PdfGridNQ   = cms.untracked.int32(30),
+    #PdfGridXMin = cms.untracked.double(1.e-5),
+    #PdfGridXMax = cms.untracked.double(0.99),
+    #PdfGridQMin = cms.untracked.double(5.0),
+    #PdfGridQMax = cms.untracked.double(1.e4),
     )
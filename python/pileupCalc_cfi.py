@@ -1,5 +1,14 @@
 import FWCore.ParameterSet.Config as cms
 
+# PileUpCalc runs only if it is named in process.ljmet.calculators
 PileUpCalc = cms.PSet(
-    verbosity = cms.int32(1)
+    verbosity = cms.int32(1),
+    # data scenarios, each one is a weight branch; the data distribution
+    # of scenario X is given as X, optional variations as XUp and XDown.
+    # Without DataScenarios the built-in 2012 distributions are used
+    #MCDist = cms.vdouble(...),
+    #DataScenarios = cms.vstring('weight_PU_ABCD'),
+    #weight_PU_ABCD = cms.vdouble(...),
+    #weight_PU_ABCDUp = cms.vdouble(...),
+    #weight_PU_ABCDDown = cms.vdouble(...),
 )
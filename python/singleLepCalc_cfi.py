@@ -3,7 +3,7 @@ import FWCore.ParameterSet.Config as cms
 singleLepCalc = cms.PSet(
                          dataType          = cms.string('All'),
                          isMc              = cms.bool(True),
-                         pvCollection = cms.InputTag("offlineSlimmedPrimaryVertices"),
+#                         pvCollection = cms.InputTag("offlineSlimmedPrimaryVertices"), # default: primaryVertices of CommonCalc
                          genParticles = cms.InputTag("prunedGenParticles"),
 			 genJets_it = cms.InputTag("slimmedGenJets"),
 			 triggerCollection = cms.InputTag("TriggerResults::HLT"),
@@ -39,7 +39,7 @@ private:
     
 };
 
-static int reg = LjmetFactory::GetInstance()->Register(new BTagSFCalc(), "BTagSFCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<BTagSFCalc>, "BTagSFCalc");
 
 BTagSFCalc::BTagSFCalc()
 {
@@ -35,19 +35,61 @@ void BaseCalc::SetValue(std::string name, double value)
     mpEc->SetValue(_name, value);
 }
 
-void BaseCalc::SetValue(std::string name, std::vector<bool> value)
+void BaseCalc::SetValue(std::string name, std::vector<bool> const & value)
 {
     std::string _name = name + "_" + mName;
     mpEc->SetValue(_name, value);
 }
 
-void BaseCalc::SetValue(std::string name, std::vector<int> value)
+void BaseCalc::SetValue(std::string name, std::vector<int> const & value)
 {
     std::string _name = name + "_" + mName;
     mpEc->SetValue(_name, value);
 }
 
-void BaseCalc::SetValue(std::string name, std::vector<double> value)
+void BaseCalc::SetValue(std::string name, std::vector<double> const & value)
+{
+    std::string _name = name + "_" + mName;
+    mpEc->SetValue(_name, value);
+}
+
+void BaseCalc::SetValue(std::string name, std::vector<float> const & value)
+{
+    std::string _name = name + "_" + mName;
+    mpEc->SetValue(_name, value);
+}
+
+void BaseCalc::SetValue(std::string name, std::vector<short> const & value)
+{
+    std::string _name = name + "_" + mName;
+    mpEc->SetValue(_name, value);
+}
+
+void BaseCalc::SetValue(std::string name, LjmetArenaVector<bool> const & value)
+{
+    std::string _name = name + "_" + mName;
+    mpEc->SetValue(_name, value);
+}
+
+void BaseCalc::SetValue(std::string name, LjmetArenaVector<int> const & value)
+{
+    std::string _name = name + "_" + mName;
+    mpEc->SetValue(_name, value);
+}
+
+void BaseCalc::SetValue(std::string name, LjmetArenaVector<double> const & value)
+{
+    std::string _name = name + "_" + mName;
+    mpEc->SetValue(_name, value);
+}
+
+void BaseCalc::SetValue(std::string name, LjmetArenaVector<float> const & value)
+{
+    std::string _name = name + "_" + mName;
+    mpEc->SetValue(_name, value);
+}
+
+void BaseCalc::SetValue(std::string name, LjmetArenaVector<short> const & value)
 {
     std::string _name = name + "_" + mName;
     mpEc->SetValue(_name, value);
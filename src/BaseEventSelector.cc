@@ -1,9 +1,11 @@
+#include <cstdlib>
 #include <math.h>
 
 #include "LJMet/Com/interface/BaseEventSelector.h"
 #include "JetMETCorrections/Objects/interface/JetCorrector.h"
 #include "CondFormats/JetMETObjects/interface/JetCorrectorParameters.h"
 #include "CondFormats/JetMETObjects/interface/FactorizedJetCorrector.h"
+#include "LJMet/Com/interface/LjmetJecCache.h"
 
 BaseEventSelector::BaseEventSelector():
 mName(""),
@@ -113,6 +115,8 @@ void BaseEventSelector::BeginJob(std::map<std::string, edm::ParameterSet const >
         }
         if (par[_key].exists("doNewJEC")) mbPar["doNewJEC"] = par[_key].getParameter<bool> ("doNewJEC");
         else mbPar["doNewJEC"] = false;
+        if (par[_key].exists("JEC_cache")) msPar["JEC_cache"] = par[_key].getParameter<std::string> ("JEC_cache");
+        else msPar["JEC_cache"] = "";
         
         if (_missing_config) {
             std::cout << mLegend
@@ -130,63 +134,47 @@ void BaseEventSelector::BeginJob(std::map<std::string, edm::ParameterSet const >
     bTagCut = mdPar["btag_min_discr"];
     std::cout << "b-tag check "<<msPar["btagOP"]<<" "<< msPar["btagger"]<<" "<<mdPar["btag_min_discr"]<<std::endl;
     
+    // JEC parameters from the binary cache of ljmet-jec-compile, or parsed from the text files
+    LjmetJecCache _jecCache(msPar["JEC_cache"]);
+
     if ( mbPar["isMc"] && ( mbPar["JECup"] || mbPar["JECdown"]))
-        jecUnc = new JetCorrectionUncertainty(*(new JetCorrectorParameters(msPar["JEC_txtfile"].c_str(), "Total")));
+        jecUnc = new JetCorrectionUncertainty(_jecCache.Load(msPar["JEC_txtfile"], "Total"));
 
     vector<JetCorrectorParameters> vPar;
     vector<JetCorrectorParameters> vParAK8;
 
     if ( mbPar["isMc"] && mbPar["doNewJEC"] ) {
-        // Create the JetCorrectorParameter objects, the order does not matter.
-
-        JetCorrectorParameters *L3JetPar  = new JetCorrectorParameters(msPar["MCL3JetPar"]);
-        JetCorrectorParameters *L2JetPar  = new JetCorrectorParameters(msPar["MCL2JetPar"]);
-    	JetCorrectorParameters *L1JetPar  = new JetCorrectorParameters(msPar["MCL1JetPar"]);
-        
-	JetCorrectorParameters *L3JetParAK8  = new JetCorrectorParameters(msPar["MCL3JetParAK8"]);
-        JetCorrectorParameters *L2JetParAK8  = new JetCorrectorParameters(msPar["MCL2JetParAK8"]);
-    	JetCorrectorParameters *L1JetParAK8  = new JetCorrectorParameters(msPar["MCL1JetParAK8"]);
     	// Load the JetCorrectorParameter objects into a vector,
     	// IMPORTANT: THE ORDER MATTERS HERE !!!! 
-    	vPar.push_back(*L1JetPar);
-    	vPar.push_back(*L2JetPar);
-    	vPar.push_back(*L3JetPar);
+    	vPar.push_back(_jecCache.Load(msPar["MCL1JetPar"]));
+    	vPar.push_back(_jecCache.Load(msPar["MCL2JetPar"]));
+    	vPar.push_back(_jecCache.Load(msPar["MCL3JetPar"]));
 
-    	vParAK8.push_back(*L1JetParAK8);
-    	vParAK8.push_back(*L2JetParAK8);
-    	vParAK8.push_back(*L3JetParAK8);
+    	vParAK8.push_back(_jecCache.Load(msPar["MCL1JetParAK8"]));
+    	vParAK8.push_back(_jecCache.Load(msPar["MCL2JetParAK8"]));
+    	vParAK8.push_back(_jecCache.Load(msPar["MCL3JetParAK8"]));
 
     	std::cout << mLegend << "Applying new jet energy corrections" << std::endl;
     }
     else if ( !mbPar["isMc"] && mbPar["doNewJEC"] ) {
-        // Create the JetCorrectorParameter objects, the order does not matter.
-
-        JetCorrectorParameters *ResJetPar = new JetCorrectorParameters(msPar["DataResJetPar"]); 
-    	JetCorrectorParameters *L3JetPar  = new JetCorrectorParameters(msPar["DataL3JetPar"]);
-    	JetCorrectorParameters *L2JetPar  = new JetCorrectorParameters(msPar["DataL2JetPar"]);
-    	JetCorrectorParameters *L1JetPar  = new JetCorrectorParameters(msPar["DataL1JetPar"]);
-
-        JetCorrectorParameters *ResJetParAK8 = new JetCorrectorParameters(msPar["DataResJetParAK8"]); 
-    	JetCorrectorParameters *L3JetParAK8  = new JetCorrectorParameters(msPar["DataL3JetParAK8"]);
-    	JetCorrectorParameters *L2JetParAK8  = new JetCorrectorParameters(msPar["DataL2JetParAK8"]);
-    	JetCorrectorParameters *L1JetParAK8  = new JetCorrectorParameters(msPar["DataL1JetParAK8"]);
     	// Load the JetCorrectorParameter objects into a vector,
     	// IMPORTANT: THE ORDER MATTERS HERE !!!! 
-    	vPar.push_back(*L1JetPar);
-   	vPar.push_back(*L2JetPar);
-    	vPar.push_back(*L3JetPar);
-    	vPar.push_back(*ResJetPar);
+    	vPar.push_back(_jecCache.Load(msPar["DataL1JetPar"]));
+    	vPar.push_back(_jecCache.Load(msPar["DataL2JetPar"]));
+    	vPar.push_back(_jecCache.Load(msPar["DataL3JetPar"]));
+    	vPar.push_back(_jecCache.Load(msPar["DataResJetPar"]));
 
-    	vParAK8.push_back(*L1JetParAK8);
-   	vParAK8.push_back(*L2JetParAK8);
-    	vParAK8.push_back(*L3JetParAK8);
-    	vParAK8.push_back(*ResJetParAK8);
+    	vParAK8.push_back(_jecCache.Load(msPar["DataL1JetParAK8"]));
+    	vParAK8.push_back(_jecCache.Load(msPar["DataL2JetParAK8"]));
+    	vParAK8.push_back(_jecCache.Load(msPar["DataL3JetParAK8"]));
+    	vParAK8.push_back(_jecCache.Load(msPar["DataResJetParAK8"]));
 
     	std::cout << mLegend << "Applying new jet energy corrections" << std::endl;
     }
     else{
     	std::cout << mLegend << "NOT applying new jet energy corrections - ARE YOU SURE?" << std::endl;
     }
+    _jecCache.Report(std::cout);
     JetCorrector = new FactorizedJetCorrector(vPar);
     JetCorrectorAK8 = new FactorizedJetCorrector(vParAK8);
   
@@ -213,6 +201,146 @@ void BaseEventSelector::Init( void )
     mpEc->SetHistogram(mName, "nBtagSfCorrections", 100, 0.0, 10.0);
 }
 
+std::vector<size_t> BaseEventSelector::GetCutFlow() const
+{
+    std::vector<size_t> counts;
+    for (cut_flow_map::const_iterator icut = cutFlow_.begin(); icut != cutFlow_.end(); ++icut) counts.push_back(icut->second);
+    return counts;
+}
+
+void BaseEventSelector::SetCutFlow(std::vector<size_t> const & counts)
+{
+    if (counts.size() != cutFlow_.size()) {
+        std::cout << mLegend << "checkpoint has " << counts.size() << " cuts, selector has " << cutFlow_.size() << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+    for (unsigned int i = 0; i < counts.size(); ++i) cutFlow_[i].second = counts[i];
+}
+
+BaseEventSelector::CutIndex BaseEventSelector::GetCutIndex(std::string const & name) const
+{
+    CutIndex _index;
+    // the counters are in the order of the cuts, as the bits
+    for (_index.position = 0; _index.position < cutFlow_.size(); ++_index.position) {
+        if (cutFlow_[_index.position].first.str() == name) break;
+    }
+    if (_index.position == cutFlow_.size()) {
+        std::cout << mLegend << "no cut " << name << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+    _index.bit = pat::strbitset::index_type(&bits_, name);
+    
+    std::map<pat::strbitset::index_type, int>::const_iterator _int = intCuts_.find(_index.bit);
+    if (_int != intCuts_.end()) _index.intCut = _int->second;
+    std::map<pat::strbitset::index_type, double>::const_iterator _double = doubleCuts_.find(_index.bit);
+    if (_double != doubleCuts_.end()) _index.doubleCut = _double->second;
+    
+    return _index;
+}
+
+namespace {
+    template <class T>
+    void selectionIndices(std::vector<edm::Ptr<T> > const & objects, std::vector<int> & indices)
+    {
+        indices.clear();
+        for (unsigned int i = 0; i < objects.size(); ++i) indices.push_back(objects[i].key());
+    }
+    
+    template <class T>
+    void selectionPtrs(edm::EventBase const & event, edm::InputTag const & tag, std::vector<int> const & indices, std::vector<edm::Ptr<T> > & objects)
+    {
+        objects.clear();
+        if (indices.empty()) return;
+        edm::Handle<std::vector<T> > _handle;
+        event.getByLabel(tag, _handle);
+        for (unsigned int i = 0; i < indices.size(); ++i) objects.push_back(edm::Ptr<T>(_handle, indices[i]));
+    }
+}
+
+void BaseEventSelector::GetSelection(pat::strbitset const & ret, LjmetSelectionCache::Record & record) const
+{
+    record.passBits = ret.bits();
+    selectionIndices(mvSelMuons, record.muons);
+    selectionIndices(mvLooseMuons, record.looseMuons);
+    selectionIndices(mvAllMuons, record.allMuons);
+    selectionIndices(mvSelElectrons, record.electrons);
+    selectionIndices(mvLooseElectrons, record.looseElectrons);
+    selectionIndices(mvAllElectrons, record.allElectrons);
+    selectionIndices(mvSelJets, record.jets);
+    selectionIndices(mvLooseJets, record.looseJets);
+    selectionIndices(mvAllJets, record.allJets);
+    selectionIndices(mvSelBtagJets, record.bJets);
+    selectionIndices(mvSelPVs, record.pvs);
+    record.triggers.assign(mvSelTriggers.begin(), mvSelTriggers.end());
+    record.met = mpMet.isNonnull();
+    record.type1CorrMet = mpType1CorrMet.isNonnull();
+    
+    record.corrJetPx.clear();
+    record.corrJetPy.clear();
+    record.corrJetPz.clear();
+    record.corrJetE.clear();
+    record.corrJetBTag.clear();
+    for (unsigned int i = 0; i < mvCorrJetsWithBTags.size(); ++i) {
+        TLorentzVector const & _p4 = mvCorrJetsWithBTags[i].first;
+        record.corrJetPx.push_back(_p4.Px());
+        record.corrJetPy.push_back(_p4.Py());
+        record.corrJetPz.push_back(_p4.Pz());
+        record.corrJetE.push_back(_p4.E());
+        record.corrJetBTag.push_back(mvCorrJetsWithBTags[i].second);
+    }
+    record.corrMet[0] = correctedMET_p4.Px();
+    record.corrMet[1] = correctedMET_p4.Py();
+    record.corrMet[2] = correctedMET_p4.Pz();
+    record.corrMet[3] = correctedMET_p4.E();
+}
+
+void BaseEventSelector::SetSelection(edm::EventBase const & event, LjmetSelectionCache::Record const & record, pat::strbitset & ret)
+{
+    if (mvCutBits.size() != cutFlow_.size()) {
+        mvCutBits.clear();
+        for (unsigned int i = 0; i < cutFlow_.size(); ++i) mvCutBits.push_back(GetCutIndex(cutFlow_[i].first.str()).bit);
+    }
+    if (mvCutBits.size() != record.passBits.size()) {
+        std::cout << mLegend << "cached selection has " << record.passBits.size() << " cuts, selector has " << mvCutBits.size() << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+    for (unsigned int i = 0; i < mvCutBits.size(); ++i) ret[mvCutBits[i]] = record.passBits[i];
+    
+    // collections are only read if the event has objects from them
+    selectionPtrs(event, mtPar["muon_collection"], record.muons, mvSelMuons);
+    selectionPtrs(event, mtPar["muon_collection"], record.looseMuons, mvLooseMuons);
+    selectionPtrs(event, mtPar["muon_collection"], record.allMuons, mvAllMuons);
+    selectionPtrs(event, mtPar["electron_collection"], record.electrons, mvSelElectrons);
+    selectionPtrs(event, mtPar["electron_collection"], record.looseElectrons, mvLooseElectrons);
+    selectionPtrs(event, mtPar["electron_collection"], record.allElectrons, mvAllElectrons);
+    selectionPtrs(event, mtPar["jet_collection"], record.jets, mvSelJets);
+    selectionPtrs(event, mtPar["jet_collection"], record.looseJets, mvLooseJets);
+    selectionPtrs(event, mtPar["jet_collection"], record.allJets, mvAllJets);
+    selectionPtrs(event, mtPar["jet_collection"], record.bJets, mvSelBtagJets);
+    selectionPtrs(event, mtPar["pv_collection"], record.pvs, mvSelPVs);
+    mvSelTriggers.assign(record.triggers.begin(), record.triggers.end());
+    
+    mpMet = edm::Ptr<pat::MET>();
+    if (record.met) {
+        edm::Handle<std::vector<pat::MET> > _met;
+        event.getByLabel(mtPar["met_collection"], _met);
+        mpMet = edm::Ptr<pat::MET>(_met, 0);
+    }
+    mpType1CorrMet = edm::Ptr<reco::PFMET>();
+    if (record.type1CorrMet) {
+        edm::Handle<std::vector<reco::PFMET> > _type1CorrMet;
+        event.getByLabel(mtPar["type1corrmet_collection"], _type1CorrMet);
+        mpType1CorrMet = edm::Ptr<reco::PFMET>(_type1CorrMet, 0);
+    }
+    
+    mvCorrJetsWithBTags.clear();
+    for (unsigned int i = 0; i < record.corrJetE.size(); ++i) {
+        TLorentzVector _p4(record.corrJetPx[i], record.corrJetPy[i], record.corrJetPz[i], record.corrJetE[i]);
+        mvCorrJetsWithBTags.push_back(std::make_pair(_p4, (bool)record.corrJetBTag[i]));
+    }
+    correctedMET_p4.SetPxPyPzE(record.corrMet[0], record.corrMet[1], record.corrMet[2], record.corrMet[3]);
+}
+
 TLorentzVector BaseEventSelector::correctJet(const pat::Jet & jet, edm::EventBase const & event, bool doAK8Corr)
 {
 
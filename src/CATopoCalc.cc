@@ -37,7 +37,7 @@ private:
                      bool isMuon );
 };
 
-static int reg = LjmetFactory::GetInstance()->Register(new CATopoCalc(), "CATopoCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<CATopoCalc>, "CATopoCalc");
 
 CATopoCalc::CATopoCalc()
 {
@@ -11,6 +11,7 @@
 #include "LJMet/Com/interface/LjmetFactory.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
 #include "SimDataFormats/PileupSummaryInfo/interface/PileupSummaryInfo.h" 
+#include "DataFormats/VertexReco/interface/Vertex.h"
 
 #include "PhysicsTools/Utilities/interface/LumiReWeighting.h"
 
@@ -34,12 +35,13 @@ public:
 private:
 
   edm::LumiReWeighting LumiWeights_;
+  edm::InputTag pvCollection_it;
 
 };
 
 
 
-static int reg = LjmetFactory::GetInstance()->Register(new CommonCalc(), "CommonCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<CommonCalc>, "CommonCalc");
 
 
 
@@ -62,6 +64,13 @@ int CommonCalc::BeginJob(){
 	        << std::endl;
   }
   */
+
+  if (mPset.exists("pvCollection")) pvCollection_it = mPset.getParameter<edm::InputTag>("pvCollection");
+  else                              pvCollection_it = edm::InputTag("offlineSlimmedPrimaryVertices");
+
+  // the PV collection as it is, no quality selection; read by singleLepCalc and DileptonCalc
+  Produces("primaryVertices");
+
   return 0;
 }
 
@@ -73,8 +82,9 @@ int CommonCalc::ProduceEvent(edm::EventBase const & event,
   // produce and store some new data for other modules
   //
 
-  double _val = 2.34;
-  selector->SetTestValue(_val);
+  edm::Handle<std::vector<reco::Vertex> > pvHandle;
+  event.getByLabel(pvCollection_it, pvHandle);
+  PutProduct("primaryVertices", pvHandle);
 
   return 0;
 }
@@ -13,6 +13,7 @@
 
 #include "EgammaAnalysis/ElectronTools/interface/ElectronEffectiveArea.h"
 #include "LJMet/Com/interface/TopElectronSelector.h"
+#include "LJMet/Com/interface/LjmetLeptonId.h"
 
 #include "DataFormats/JetReco/interface/CATopJetTagInfo.h"
 
@@ -37,7 +38,6 @@ private:
     bool                      isMc;
     std::string               dataType;
     edm::InputTag             rhoSrc_it;
-    edm::InputTag             pvCollection_it;
     edm::InputTag             genParticles_it;
     std::vector<unsigned int> keepPDGID;
     std::vector<unsigned int> keepMomPDGID;
@@ -46,13 +46,20 @@ private:
     double rhoIso;
     
     boost::shared_ptr<TopElectronSelector>     electronSelL_, electronSelM_, electronSelT_;
-    std::vector<reco::Vertex> goodPVs;
+    // the three working points in one pass over the electrons, -1 if the selector is HEEP
+    LjmetLeptonId electronId_;
+    int electronIdL_, electronIdM_, electronIdT_;
+    /// pvCollection, read here if set or if CommonCalc does not run
+    edm::InputTag             pvCollection_it;
+    bool                      pvFromProduct;
+    /// all PVs, no quality selection
+    std::vector<reco::Vertex> const * goodPVs;
     int findMatch(const reco::GenParticleCollection & genParticles, int idToMatch, double eta, double phi);
     double mdeltaR(double eta1, double phi1, double eta2, double phi2);
     void fillMotherInfo(const reco::Candidate *mother, int i, vector <int> & momid, vector <int> & momstatus, vector<double> & mompt, vector<double> & mometa, vector<double> & momphi, vector<double> & momenergy);
 };
 
-static int reg = LjmetFactory::GetInstance()->Register(new DileptonCalc(), "DileptonCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<DileptonCalc>, "DileptonCalc");
 
 DileptonCalc::DileptonCalc()
 {
@@ -66,6 +73,8 @@ int DileptonCalc::BeginJob()
     if (mPset.exists("rhoSrc"))       rhoSrc_it = mPset.getParameter<edm::InputTag>("rhoSrc");
     else                              rhoSrc_it = edm::InputTag("fixedGridRhoAll", "", "RECO");
     
+    // an explicit pvCollection is kept, otherwise the PVs come from CommonCalc
+    pvFromProduct = !mPset.exists("pvCollection");
     if (mPset.exists("pvCollection")) pvCollection_it = mPset.getParameter<edm::InputTag>("pvCollection");
     else                              pvCollection_it = edm::InputTag("offlineSlimmedPrimaryVertices");
     
@@ -113,6 +122,10 @@ int DileptonCalc::BeginJob()
         std::exit(-1);
     }
     
+    electronIdL_ = electronId_.AddElectronWorkingPoint(*electronSelL_);
+    electronIdM_ = electronId_.AddElectronWorkingPoint(*electronSelM_);
+    electronIdT_ = electronId_.AddElectronWorkingPoint(*electronSelT_);
+    
     return 0;
 }
 
@@ -172,11 +185,16 @@ int DileptonCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector *
     //
     
     //Primary vertices
-    edm::Handle<std::vector<reco::Vertex> > pvHandle;
-    event.getByLabel(pvCollection_it, pvHandle);
-    goodPVs = *(pvHandle.product());
+    if (pvFromProduct && HasProduct("primaryVertices")) {
+        goodPVs = GetProduct<edm::Handle<std::vector<reco::Vertex> > >("primaryVertices").product();
+    }
+    else {
+        edm::Handle<std::vector<reco::Vertex> > pvHandle;
+        event.getByLabel(pvCollection_it, pvHandle);
+        goodPVs = pvHandle.product();
+    }
     
-    SetValue("nPV", (int)goodPVs.size());
+    SetValue("nPV", (int)goodPVs->size());
     
     //
     //_____ Electrons _________________________
@@ -245,6 +263,8 @@ int DileptonCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector *
     
     pat::strbitset retElectron  = electronSelL_->getBitTemplate();
     bool retElectronT,retElectronM,retElectronL;
+    bool const idKernel = electronIdL_ >= 0 && electronIdM_ >= 0 && electronIdT_ >= 0;
+    if (idKernel) electronId_.EvaluateElectrons(vSelElectrons, event);
     
     
     //
@@ -301,16 +321,24 @@ int DileptonCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector *
             elCharge.push_back((*iel)->charge());
             elNotConversion . push_back(notConv);
             
-            retElectronL = (*electronSelL_)(**iel, event, retElectron);
-            retElectronM = (*electronSelM_)(**iel, event, retElectron);
-            retElectronT = (*electronSelT_)(**iel, event, retElectron);
+            if (idKernel) {
+                unsigned int const iEl = iel - vSelElectrons.begin();
+                retElectronL = electronId_.PassElectron(electronIdL_, iEl);
+                retElectronM = electronId_.PassElectron(electronIdM_, iEl);
+                retElectronT = electronId_.PassElectron(electronIdT_, iEl);
+            }
+            else {
+                retElectronL = (*electronSelL_)(**iel, event, retElectron);
+                retElectronM = (*electronSelM_)(**iel, event, retElectron);
+                retElectronT = (*electronSelT_)(**iel, event, retElectron);
+            }
             
             elQuality.push_back((retElectronT<<2) + (retElectronM<<1) + retElectronL);
             
             //IP: for some reason this is with respect to the first vertex in the collection
-            if(goodPVs.size() > 0){
-                elDxy.push_back((*iel)->gsfTrack()->dxy(goodPVs.at(0).position()));
-                elDZ.push_back((*iel)->gsfTrack()->dz(goodPVs.at(0).position()));
+            if(goodPVs->size() > 0){
+                elDxy.push_back((*iel)->gsfTrack()->dxy(goodPVs->at(0).position()));
+                elDZ.push_back((*iel)->gsfTrack()->dz(goodPVs->at(0).position()));
             } else {
                 elDxy.push_back(-999);
                 elDZ.push_back(-999);
@@ -493,7 +521,7 @@ int DileptonCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector *
             muEnergy . push_back((*imu)->energy());
             
 
-	    muIsTight.push_back((*imu)->isTightMuon(goodPVs.at(0)));
+	    muIsTight.push_back((*imu)->isTightMuon(goodPVs->at(0)));
 	    muIsLoose.push_back((*imu)->isLooseMuon());
 
             muGlobal.push_back(((*imu)->isGlobalMuon()<<2)+(*imu)->isTrackerMuon());
@@ -514,9 +542,9 @@ int DileptonCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector *
             muPuIso . push_back(puIso);
             
             //IP: for some reason this is with respect to the first vertex in the collection
-            if (goodPVs.size() > 0){
-                muDxy . push_back((*imu)->muonBestTrack()->dxy(goodPVs.at(0).position()));
-                muDz  . push_back((*imu)->muonBestTrack()->dz(goodPVs.at(0).position()));
+            if (goodPVs->size() > 0){
+                muDxy . push_back((*imu)->muonBestTrack()->dxy(goodPVs->at(0).position()));
+                muDz  . push_back((*imu)->muonBestTrack()->dz(goodPVs->at(0).position()));
             } else {
                 muDxy . push_back(-999);
                 muDz  . push_back(-999);
@@ -92,6 +92,27 @@ protected:
     
     std::vector<edm::Ptr<reco::Vertex> >  good_pvs_;
     
+    // cuts in cut flow order
+    enum Cut {
+        cutNoSelection,
+        cutTrigger,
+        cutPv,
+        cutHbhe,
+        cutMinMuon,
+        cutMaxMuon,
+        cutMinElectron,
+        cutMaxElectron,
+        cutMinLepton,
+        cutOneJet,
+        cutTwoJets,
+        cutThreeJets,
+        cutMinJets,
+        cutMaxJets,
+        cutMinMet,
+        cutAllCuts
+    };
+    std::vector<CutIndex> mvCuts;
+    
 private:
     
     void initialize(std::map<std::string, edm::ParameterSet const> par);
@@ -100,7 +121,7 @@ private:
 };
 
 
-static int reg = LjmetFactory::GetInstance()->Register(new DileptonEventSelector(), "DileptonSelector");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeSelector<DileptonEventSelector>, "DileptonSelector");
 
 
 DileptonEventSelector::DileptonEventSelector(){
@@ -255,6 +276,10 @@ void DileptonEventSelector::BeginJob( std::map<std::string, edm::ParameterSet co
     
     set("All cuts", true);
     
+    // resolve the cuts once, in the order of push_back
+    mvCuts.clear();
+    for (unsigned int i = 0; i < cutFlow_.size(); ++i) mvCuts.push_back(GetCutIndex(cutFlow_[i].first.str()));
+    
 } // initialize()
 
 
@@ -266,12 +291,12 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
     
     while(1){ // standard infinite while loop trick to avoid nested ifs
         
-        passCut(ret, "No selection");
+        passCut(ret, mvCuts[cutNoSelection]);
         
         //
         //_____ Trigger cuts __________________________________
         //
-        if ( considerCut("Trigger") ) {
+        if ( considerCut(mvCuts[cutTrigger]) ) {
             
             
             event.getByLabel( mtPar["trigger_collection"], mhEdmTriggerResults );
@@ -327,7 +352,7 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
             mvSelTriggers.push_back(passEM);
             mvSelTriggers.push_back(passMM);
             
-            if ( ignoreCut("Trigger") || passEE + passEM + passMM > 0 ) passCut(ret, "Trigger");
+            if ( ignoreCut(mvCuts[cutTrigger]) || passEE + passEM + passMM > 0 ) passCut(ret, mvCuts[cutTrigger]);
             else break;
             
         } // end of trigger cuts
@@ -337,10 +362,10 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
         //
         //_____ Primary vertex cuts __________________________________
         //
-        if ( considerCut("Primary vertex") ) {
+        if ( considerCut(mvCuts[cutPv]) ) {
             
             if ( (*pvSel_)(event) ){
-                passCut(ret, "Primary vertex"); // PV cuts total
+                passCut(ret, mvCuts[cutPv]); // PV cuts total
             }
             
         } // end of PV cuts
@@ -351,9 +376,9 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
         //
         //_____ HBHE noise and scraping filter________________________
         //
-        if ( considerCut("HBHE noise and scraping filter") ) {
+        if ( considerCut(mvCuts[cutHbhe]) ) {
             
-            passCut(ret, "HBHE noise and scraping filter"); // PV cuts total
+            passCut(ret, mvCuts[cutHbhe]); // PV cuts total
             
         } // end of PV cuts
         
@@ -400,10 +425,10 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
                 _n_muons++;
             } // end of the muon loop
             
-            if( nSelMuons >= cut("Min muon", int()) || ignoreCut("Min muon") ) passCut(ret, "Min muon");
+            if( nSelMuons >= mvCuts[cutMinMuon].intCut || ignoreCut(mvCuts[cutMinMuon]) ) passCut(ret, mvCuts[cutMinMuon]);
             else break;
             
-            if( nSelMuons <= cut("Max muon", int()) || ignoreCut("Max muon") ) passCut(ret, "Max muon");
+            if( nSelMuons <= mvCuts[cutMaxMuon].intCut || ignoreCut(mvCuts[cutMaxMuon]) ) passCut(ret, mvCuts[cutMaxMuon]);
             else break;
             
         } // end of muon cuts
@@ -452,17 +477,17 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
                 _n_electrons++;
             } // end of the electron loop
             
-            if( nSelElectrons >= cut("Min electron", int()) || ignoreCut("Min electron") ) passCut(ret, "Min electron");
+            if( nSelElectrons >= mvCuts[cutMinElectron].intCut || ignoreCut(mvCuts[cutMinElectron]) ) passCut(ret, mvCuts[cutMinElectron]);
             else break;
             
-            if( nSelElectrons <= cut("Max electron", int()) || ignoreCut("Max electron") ) passCut(ret, "Max electron");
+            if( nSelElectrons <= mvCuts[cutMaxElectron].intCut || ignoreCut(mvCuts[cutMaxElectron]) ) passCut(ret, mvCuts[cutMaxElectron]);
             else break;
             
         } // end of electron cuts
         
         int nSelLeptons = nSelElectrons + nSelMuons;
         
-        if( nSelLeptons >= cut("Min lepton", int()) || ignoreCut("Min lepton") ) passCut(ret, "Min lepton");
+        if( nSelLeptons >= mvCuts[cutMinLepton].intCut || ignoreCut(mvCuts[cutMinLepton]) ) passCut(ret, mvCuts[cutMinLepton]);
         else break;
         
         //     if (nSelLeptons < 2) std::cout<<"Too few leptons!"<<std::endl;
@@ -498,19 +523,19 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
         
         if ( mbPar["jet_cuts"] ) {
             
-            if ( ignoreCut("One jet or more") || _n_good_jets >= 1 ) passCut(ret, "One jet or more");
+            if ( ignoreCut(mvCuts[cutOneJet]) || _n_good_jets >= 1 ) passCut(ret, mvCuts[cutOneJet]);
             else break; 
             
-            if ( ignoreCut("Two jets or more") || _n_good_jets >= 2 ) passCut(ret, "Two jets or more");
+            if ( ignoreCut(mvCuts[cutTwoJets]) || _n_good_jets >= 2 ) passCut(ret, mvCuts[cutTwoJets]);
             else break; 
             
-            if ( ignoreCut("Three jets or more") || _n_good_jets >= 3 ) passCut(ret, "Three jets or more");
+            if ( ignoreCut(mvCuts[cutThreeJets]) || _n_good_jets >= 3 ) passCut(ret, mvCuts[cutThreeJets]);
             else break; 
             
-            if ( ignoreCut("Min jet multiplicity") || _n_good_jets >= cut("Min jet multiplicity",int()) ) passCut(ret, "Min jet multiplicity");
+            if ( ignoreCut(mvCuts[cutMinJets]) || _n_good_jets >= mvCuts[cutMinJets].intCut ) passCut(ret, mvCuts[cutMinJets]);
             else break; 
             
-            if ( ignoreCut("Max jet multiplicity") || _n_good_jets <= cut("Max jet multiplicity",int()) ) passCut(ret, "Max jet multiplicity");
+            if ( ignoreCut(mvCuts[cutMaxJets]) || _n_good_jets <= mvCuts[cutMaxJets].intCut ) passCut(ret, mvCuts[cutMaxJets]);
             else break; 
             
         } // end of jet cuts
@@ -531,7 +556,7 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
             if ( mpMet.isNonnull() && mpMet.isAvailable() ) {
                 
                 pat::MET const & met = mhMet->at(0);
-                if ( ignoreCut("Min MET") || met.et()>cut("Min MET", double()) ) passCut(ret, "Min MET");
+                if ( ignoreCut(mvCuts[cutMinMet]) || met.et()>mvCuts[cutMinMet].doubleCut ) passCut(ret, mvCuts[cutMinMet]);
             }
         } // end of MET cuts
         
@@ -550,7 +575,7 @@ bool DileptonEventSelector::operator()( edm::EventBase const & event, pat::strbi
             if (_isTagged) mvSelBtagJets.push_back(*_ijet); 
         }
         
-        passCut(ret, "All cuts");
+        passCut(ret, mvCuts[cutAllCuts]);
         break;
         
     } // end of while loop
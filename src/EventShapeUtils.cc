@@ -0,0 +1,171 @@
+#include <cmath>
+#include <algorithm>
+
+#include "LJMet/Com/interface/EventShapeUtils.h"
+
+namespace {
+
+  inline void sortDescending( double * v ){
+    if (v[0] < v[1]) std::swap(v[0], v[1]);
+    if (v[1] < v[2]) std::swap(v[1], v[2]);
+    if (v[0] < v[1]) std::swap(v[0], v[1]);
+  }
+
+  inline double dot( const double * a, const double * b ){
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+  }
+
+  inline void cross( const double * a, const double * b, double * c ){
+    c[0] = a[1]*b[2] - a[2]*b[1];
+    c[1] = a[2]*b[0] - a[0]*b[2];
+    c[2] = a[0]*b[1] - a[1]*b[0];
+  }
+
+  // symmetric matrix in upper triangle storage times a vector
+  inline void multiply( const double * t, const double * x, double * y ){
+    using namespace EventShapeUtils;
+    y[0] = t[kXX]*x[0] + t[kXY]*x[1] + t[kXZ]*x[2];
+    y[1] = t[kXY]*x[0] + t[kYY]*x[1] + t[kYZ]*x[2];
+    y[2] = t[kXZ]*x[0] + t[kYZ]*x[1] + t[kZZ]*x[2];
+  }
+
+}
+
+
+
+void EventShapeUtils::AccumulateMomentumTensor( const double * px, const double * py, const double * pz,
+                                                std::size_t n,
+                                                double * tensor, double & p2sum ){
+  // separate accumulators so the loop has no dependency on the
+  // output array and can be vectorized by the compiler
+  double _xx = 0.0, _xy = 0.0, _xz = 0.0;
+  double _yy = 0.0, _yz = 0.0, _zz = 0.0;
+  for (std::size_t k = 0; k < n; ++k){
+    _xx += px[k]*px[k];
+    _xy += px[k]*py[k];
+    _xz += px[k]*pz[k];
+    _yy += py[k]*py[k];
+    _yz += py[k]*pz[k];
+    _zz += pz[k]*pz[k];
+  }
+  tensor[kXX] += _xx;
+  tensor[kXY] += _xy;
+  tensor[kXZ] += _xz;
+  tensor[kYY] += _yy;
+  tensor[kYZ] += _yz;
+  tensor[kZZ] += _zz;
+  p2sum += _xx + _yy + _zz;
+}
+
+
+
+void EventShapeUtils::SymmetricEigenvalues3x3( const double * a, double * eigenvalues ){
+  //
+  // Closed-form (trigonometric) solution of the characteristic cubic,
+  // O.K. Smith, Comm. ACM 4 (1961) 168.
+  //
+  // acos() loses about half of the digits when two eigenvalues are
+  // (nearly) degenerate, e.g. for a single jet or two collinear jets.
+  // The eigenvalue far from the degenerate pair is still accurate, so
+  // it is kept, and the other two are recomputed from the 2x2 block of
+  // the matrix in the plane orthogonal to its eigenvector.
+  //
+
+  double _offdiag = a[kXY]*a[kXY] + a[kXZ]*a[kXZ] + a[kYZ]*a[kYZ];
+
+  if ( _offdiag == 0.0 ){
+    // already diagonal
+    eigenvalues[0] = a[kXX];
+    eigenvalues[1] = a[kYY];
+    eigenvalues[2] = a[kZZ];
+    sortDescending(eigenvalues);
+    return;
+  }
+
+  double _q = (a[kXX] + a[kYY] + a[kZZ])/3.0;
+  double _dxx = a[kXX] - _q;
+  double _dyy = a[kYY] - _q;
+  double _dzz = a[kZZ] - _q;
+  double _p = std::sqrt( (_dxx*_dxx + _dyy*_dyy + _dzz*_dzz + 2.0*_offdiag)/6.0 );
+
+  // r = det( (A - qI)/p ) / 2
+  double _det = _dxx*(_dyy*_dzz - a[kYZ]*a[kYZ])
+    - a[kXY]*(a[kXY]*_dzz - a[kYZ]*a[kXZ])
+    + a[kXZ]*(a[kXY]*a[kYZ] - _dyy*a[kXZ]);
+  double _r = _det/(2.0*_p*_p*_p);
+
+  double _phi;
+  if (_r <= -1.0) _phi = M_PI/3.0;
+  else if (_r >= 1.0) _phi = 0.0;
+  else _phi = std::acos(_r)/3.0;
+
+  eigenvalues[0] = _q + 2.0*_p*std::cos(_phi);
+  eigenvalues[2] = _q + 2.0*_p*std::cos(_phi + 2.0*M_PI/3.0);
+  eigenvalues[1] = 3.0*_q - eigenvalues[0] - eigenvalues[2];
+
+  // the isolated eigenvalue: largest for prolate, smallest for oblate shapes
+  int _iso = (eigenvalues[0] - eigenvalues[1] >= eigenvalues[1] - eigenvalues[2]) ? 0 : 2;
+  double _l = eigenvalues[_iso];
+
+  // its eigenvector: largest cross product of two rows of (A - lI)
+  double _r0[3] = { a[kXX] - _l, a[kXY], a[kXZ] };
+  double _r1[3] = { a[kXY], a[kYY] - _l, a[kYZ] };
+  double _r2[3] = { a[kXZ], a[kYZ], a[kZZ] - _l };
+  double _c[3][3];
+  cross(_r0, _r1, _c[0]);
+  cross(_r0, _r2, _c[1]);
+  cross(_r1, _r2, _c[2]);
+  int _best = 0;
+  double _bestNorm2 = 0.0;
+  for (int i = 0; i < 3; ++i){
+    double _n2 = dot(_c[i], _c[i]);
+    if (_n2 > _bestNorm2){ _bestNorm2 = _n2; _best = i; }
+  }
+  if ( _bestNorm2 == 0.0 ){
+    sortDescending(eigenvalues);
+    return;
+  }
+  double _n[3];
+  double _inv = 1.0/std::sqrt(_bestNorm2);
+  for (int i = 0; i < 3; ++i) _n[i] = _c[_best][i]*_inv;
+
+  // orthonormal basis (u, v) of the plane orthogonal to n
+  double _axis[3] = { 0.0, 0.0, 0.0 };
+  int _amin = 0;
+  if (std::fabs(_n[1]) < std::fabs(_n[_amin])) _amin = 1;
+  if (std::fabs(_n[2]) < std::fabs(_n[_amin])) _amin = 2;
+  _axis[_amin] = 1.0;
+  double _u[3], _v[3];
+  cross(_n, _axis, _u);
+  _inv = 1.0/std::sqrt(dot(_u, _u));
+  for (int i = 0; i < 3; ++i) _u[i] *= _inv;
+  cross(_n, _u, _v);
+
+  // 2x2 block and its eigenvalues
+  double _Au[3], _Av[3];
+  multiply(a, _u, _Au);
+  multiply(a, _v, _Av);
+  double _buu = dot(_u, _Au);
+  double _buv = dot(_u, _Av);
+  double _bvv = dot(_v, _Av);
+  double _mean = 0.5*(_buu + _bvv);
+  double _half = std::hypot(0.5*(_buu - _bvv), _buv);
+
+  eigenvalues[0] = _l;
+  eigenvalues[1] = _mean + _half;
+  eigenvalues[2] = _mean - _half;
+  sortDescending(eigenvalues);
+}
+
+
+
+void EventShapeUtils::MomentumTensorEigenvalues( const double * px, const double * py, const double * pz,
+                                                 std::size_t n,
+                                                 double * eigenvalues ){
+  double _tensor[kNTensor];
+  double _p2sum;
+  ResetMomentumTensor(_tensor, _p2sum);
+  AccumulateMomentumTensor(px, py, pz, n, _tensor, _p2sum);
+  NormalizeMomentumTensor(_tensor, _p2sum);
+  SymmetricEigenvalues3x3(_tensor, eigenvalues);
+}
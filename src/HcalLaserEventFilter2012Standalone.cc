@@ -1,25 +1,136 @@
 #include "LJMet/Com/interface/HcalLaserEventFilter2012Standalone.h"
 
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace std;
 
-HcalLaserEventFilter2012::HcalLaserEventFilter2012(const std::string & eventFileName)
+namespace {
+    // binary list layout: header, nRuns RunRange, nKeys keys
+    const char binaryMagic[8] = { 'L','J','M','H','C','A','L','1' };
+
+    struct BinaryHeader {
+        char magic[8];
+        uint64_t nKeys;
+        uint32_t nRuns;
+        uint32_t reserved;
+    };
+
+    bool lessRun(const HcalLaserEventFilter2012::RunRange & r, uint32_t run) { return r.run < run; }
+}
+
+HcalLaserEventFilter2012::HcalLaserEventFilter2012(const std::string & eventFileName):
+    keys_(0), nKeys_(0), runs_(0), nRuns_(0), map_(0), mapSize_(0)
 {
     verbose_=true;
+    minrun_=-1; maxrun_=-1;
     minRunInFile=999999; maxRunInFile=1;
     if (verbose_) cout << "HCAL laser event list from file "<<eventFileName;
-    readEventListFile(eventFileName);
-    std::sort(EventList_.begin(), EventList_.end());
-    if (verbose_) cout<<" A total of "<<EventList_.size()<<" listed HCAL laser events found in given run range";
+    if (!mapBinaryFile(eventFileName)) {
+        readEventListFile(eventFileName);
+        std::sort(EventList_.begin(), EventList_.end());
+        EventList_.erase(std::unique(EventList_.begin(), EventList_.end()), EventList_.end());
+        buildRunRanges();
+    }
+    if (verbose_) cout<<" A total of "<<nKeys_<<" listed HCAL laser events found in given run range";
+    if (nRuns_ > 0) {
+        minRunInFile=runs_[0].run;
+        maxRunInFile=runs_[nRuns_-1].run;
+    }
     minrun_=minRunInFile;
     maxrun_=maxRunInFile;
 }
 
+HcalLaserEventFilter2012::~HcalLaserEventFilter2012()
+{
+    if (map_) munmap(map_, mapSize_);
+}
+
+bool HcalLaserEventFilter2012::mapBinaryFile(const string & eventFileName)
+{
+    int fd = open(eventFileName.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    BinaryHeader header;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(header)
+        || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)
+        || memcmp(header.magic, binaryMagic, sizeof(binaryMagic)) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t expected = sizeof(header) + header.nRuns*sizeof(RunRange) + header.nKeys*sizeof(uint64_t);
+    if ((size_t)st.st_size != expected) {
+        cout<<"  Binary event list "<<eventFileName<<" is truncated";
+        close(fd);
+        return false;
+    }
+    void * map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        cout<<"  Unable to map binary event list "<<eventFileName;
+        return false;
+    }
+    map_ = map;
+    mapSize_ = st.st_size;
+    runs_ = reinterpret_cast<const RunRange *>(static_cast<const char *>(map) + sizeof(header));
+    nRuns_ = header.nRuns;
+    keys_ = reinterpret_cast<const uint64_t *>(runs_ + nRuns_);
+    nKeys_ = header.nKeys;
+    return true;
+}
+
+void HcalLaserEventFilter2012::buildRunRanges()
+{
+    RunList_.clear();
+    for (uint64_t i = 0; i < EventList_.size(); ++i) {
+        uint32_t run = EventList_[i] >> 46;
+        if (RunList_.empty() || RunList_.back().run != run) {
+            RunRange range = { run, 0, i };
+            RunList_.push_back(range);
+        }
+        ++RunList_.back().count;
+    }
+    keys_ = EventList_.empty() ? 0 : &EventList_[0];
+    nKeys_ = EventList_.size();
+    runs_ = RunList_.empty() ? 0 : &RunList_[0];
+    nRuns_ = RunList_.size();
+}
+
+bool HcalLaserEventFilter2012::writeBinaryFile(const string & eventFileName, const string & binaryFileName)
+{
+    HcalLaserEventFilter2012 list(eventFileName);
+    if (list.map_) {
+        cout<<"  "<<eventFileName<<" is already a binary event list"<<endl;
+        return false;
+    }
+
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, binaryMagic, sizeof(binaryMagic));
+    header.nKeys = list.nKeys_;
+    header.nRuns = list.nRuns_;
+
+    ofstream out(binaryFileName.c_str(), ios::binary);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(list.runs_), list.nRuns_*sizeof(RunRange));
+    out.write(reinterpret_cast<const char *>(list.keys_), list.nKeys_*sizeof(uint64_t));
+    out.close();
+    if (!out) {
+        cout<<"  Unable to write binary event list "<<binaryFileName<<endl;
+        return false;
+    }
+    return true;
+}
+
 void HcalLaserEventFilter2012::addEventString(const string & eventString)
 {
     // Loop through list of bad events, and if run is in allowed range, add bad event to EventList
     int run=0;
-    unsigned int ls=0;
-    unsigned int event=0;
+    int ls=0;
+    int event=0;
     // Check that event list object is in correct form
     size_t found = eventString.find(":");  // find first colon
     if (found!=std::string::npos)
@@ -34,7 +145,7 @@ void HcalLaserEventFilter2012::addEventString(const string & eventString)
     {
         /// Some event numbers are less than 0?  \JetHT\Run2012C-v1\RAW:201278:2145:-2130281065  -- due to events being dumped out as ints, not uints!
         ls=atoi((eventString.substr(found+1,(found2-found-1))).c_str());  // convert to ls
-        event=atoi((eventString.substr(found2+1)).c_str()); // convert to event
+        event=(int)strtoll((eventString.substr(found2+1)).c_str(), 0, 10); // convert to event, wraps as the int event numbers do
         /// Some event numbers are less than 0?  \JetHT\Run2012C-v1\RAW:201278:2145:-2130281065
         if (ls==0 || event==0) cout<<"  Strange lumi, event numbers for input '"<<eventString<<"'";
     }
@@ -54,10 +165,13 @@ void HcalLaserEventFilter2012::addEventString(const string & eventString)
         if (verbose_) cout <<"Skipping Event list input '"<<eventString<<"' because it is greater than maximum run # "<<maxrun_;
         return;
     }
-    if (minRunInFile>run) minRunInFile=run;
-    if (maxRunInFile<run) maxRunInFile=run;
+    if (run<0 || run>maxRun || ls<0 || ls>maxLumiSection)
+    {
+        cout<<"  Run or lumi section of Event list input '"<<eventString<<"' out of range, skipping";
+        return;
+    }
     // Now add event to Event List
-    EventList_.push_back(eventString);
+    EventList_.push_back(eventKey(run, ls, event));
 }
 
 #define LENGTH 0x2000
@@ -128,17 +242,22 @@ HcalLaserEventFilter2012::filter(int run, int lumiSection, int event)
     if (minrun_>-1 && run<minrun_) return true;
     if (maxrun_>-1 && run>maxrun_) return true;
     
-    // Okay, now create a string object for this run:ls:event
-    std::stringstream thisevent;
-    thisevent<<run<<":"<<lumiSection<<":"<<event;
-    
+    // Runs without listed events pass without looking at the event list
+    const RunRange * runEnd = runs_ + nRuns_;
+    const RunRange * range = std::lower_bound(runs_, runEnd, (uint32_t)run, lessRun);
+    if (range == runEnd || range->run != (uint32_t)run) return true;
+    if (lumiSection<0 || lumiSection>maxLumiSection) return true;
+
     // Event not found in bad list; it is a good event
-    strVecI it = std::lower_bound(EventList_.begin(), EventList_.end(), thisevent.str());
-    if (it == EventList_.end() || thisevent.str() < *it) return true;
+    uint64_t key = eventKey(run, lumiSection, event);
+    const uint64_t * first = keys_ + range->first;
+    const uint64_t * last = first + range->count;
+    const uint64_t * it = std::lower_bound(first, last, key);
+    if (it == last || *it != key) return true;
     // Otherwise, this is a bad event
     // if verbose, dump out event info
     // Dump out via cout, or via LogInfo?  For now, use cout
-    if (verbose_) std::cout <<"HcalLaserEventFilter2012 removed "<<thisevent.str()<<std::endl;
+    if (verbose_) std::cout <<"HcalLaserEventFilter2012 removed "<<run<<":"<<lumiSection<<":"<<event<<std::endl;
     
     return false;
 }
@@ -0,0 +1,249 @@
+/*
+ Calculator for the HitFit kinematic fit of semileptonic ttbar events
+
+ Fits the selected lepton, MET and leading selected jets with the
+ jet-parton hypotheses of HitFitDriver, pruned and fitted in parallel
+ as set in HitFitParameters_cfi, and stores the best fit.
+ With hitfitCheckPreFitChi2 it also reports the events where the
+ pre-fit chi2 cut dropped the best fit of the unpruned run.
+ Runs only when named in ljmet.calculators.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "LJMet/Com/interface/BaseCalc.h"
+#include "LJMet/Com/interface/LjmetEventContent.h"
+#include "LJMet/Com/interface/LjmetFactory.h"
+#include "LJMet/Com/interface/HitFitDriver.h"
+#include "LJMet/Com/interface/HitFitPermutationFit.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/PatCandidates/interface/Jet.h"
+#include "DataFormats/PatCandidates/interface/MET.h"
+#include "DataFormats/PatCandidates/interface/Muon.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "TopQuarkAnalysis/TopHitFit/interface/Defaults_Text.h"
+#include "TopQuarkAnalysis/TopHitFit/interface/LeptonTranslatorBase.h"
+#include "TopQuarkAnalysis/TopHitFit/interface/METTranslatorBase.h"
+
+class LjmetFactory;
+
+class HitFitCalc : public BaseCalc {
+
+public:
+    HitFitCalc();
+    virtual ~HitFitCalc();
+    virtual int BeginJob();
+    virtual int AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * selector);
+    virtual int EndJob();
+    virtual std::vector<double> GetState() const;
+    virtual void SetState(std::vector<double> const & state);
+
+private:
+    std::string fileName(std::string const & name) const;
+
+    hitfit::LeptonTranslatorBase<pat::Electron> * pElectronTranslator;
+    hitfit::LeptonTranslatorBase<pat::Muon> * pMuonTranslator;
+    hitfit::JetTranslatorBase<pat::Jet> * pJetTranslator;
+    hitfit::METTranslatorBase<pat::MET> * pMetTranslator;
+    hitfit::Top_Fit * pTopFit;
+    HitFitDriver * pDriver;
+    HitFitPermutationFit<pat::Jet> * pFit;
+
+    bool electronObjRes;
+    bool muonObjRes;
+    bool metObjRes;
+    double minLeptonPt;
+    double minJetPt;
+    double minMet;
+    unsigned int maxNJet;
+
+    unsigned long nEvents;
+    unsigned long nFits;
+    unsigned long nBestPruned;
+};
+
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<HitFitCalc>, "HitFitCalc", true);
+
+HitFitCalc::HitFitCalc():
+pElectronTranslator(0),
+pMuonTranslator(0),
+pJetTranslator(0),
+pMetTranslator(0),
+pTopFit(0),
+pDriver(0),
+pFit(0),
+nEvents(0),
+nFits(0),
+nBestPruned(0)
+{
+    mLegend = "[HitFitCalc]: ";
+}
+
+HitFitCalc::~HitFitCalc()
+{
+}
+
+std::string HitFitCalc::fileName(std::string const & name) const
+{
+    return mPset.getUntrackedParameter<edm::FileInPath>(name).fullPath();
+}
+
+int HitFitCalc::BeginJob()
+{
+    electronObjRes = mPset.exists("hitfitElectronObjRes") ? mPset.getUntrackedParameter<bool>("hitfitElectronObjRes") : false;
+    muonObjRes     = mPset.exists("hitfitMuonObjRes")     ? mPset.getUntrackedParameter<bool>("hitfitMuonObjRes")     : false;
+    metObjRes      = mPset.exists("hitfitMETsObjRes")     ? mPset.getUntrackedParameter<bool>("hitfitMETsObjRes")     : false;
+    minLeptonPt    = mPset.exists("hitfitMinLeptonPt")    ? mPset.getUntrackedParameter<double>("hitfitMinLeptonPt")  : 15.0;
+    minJetPt       = mPset.exists("hitfitMinJetPt")       ? mPset.getUntrackedParameter<double>("hitfitMinJetPt")     : 15.0;
+    minMet         = mPset.exists("hitfitMinMET")         ? mPset.getUntrackedParameter<double>("hitfitMinMET")       : 0.0;
+    maxNJet        = mPset.exists("hitfitMaxNJet")        ? mPset.getUntrackedParameter<unsigned int>("hitfitMaxNJet") : 5;
+    bool _jetObjRes = mPset.exists("hitfitJetObjRes") ? mPset.getUntrackedParameter<bool>("hitfitJetObjRes") : false;
+    std::string _jecLevel = mPset.exists("hitfitJetCorrectionLevel") ? mPset.getUntrackedParameter<std::string>("hitfitJetCorrectionLevel") : "L3Absolute";
+    double _udscJes = mPset.exists("hitfitUdscJES") ? mPset.getParameter<double>("hitfitUdscJES") : 1.0;
+    double _bJes    = mPset.exists("hitfitBJES")    ? mPset.getParameter<double>("hitfitBJES")    : 1.0;
+    double _lepWMass = mPset.exists("hitfitLepWMass") ? mPset.getUntrackedParameter<double>("hitfitLepWMass") : 80.4;
+    double _hadWMass = mPset.exists("hitfitHadWMass") ? mPset.getUntrackedParameter<double>("hitfitHadWMass") : 80.4;
+    double _topMass  = mPset.exists("hitfitTopMass")  ? mPset.getUntrackedParameter<double>("hitfitTopMass")  : 0.0;
+
+    if (maxNJet < 4) {
+        std::cout << mLegend << "hitfitMaxNJet must be at least 4, exiting" << std::endl;
+        std::exit(-1);
+    }
+
+    pElectronTranslator = new hitfit::LeptonTranslatorBase<pat::Electron>(fileName("hitfitElectronResolution"));
+    pMuonTranslator = new hitfit::LeptonTranslatorBase<pat::Muon>(fileName("hitfitMuonResolution"));
+    pJetTranslator = new hitfit::JetTranslatorBase<pat::Jet>(fileName("hitfitUdscJetResolution"),
+                                                             fileName("hitfitBJetResolution"),
+                                                             _jecLevel, _udscJes, _bJes);
+    pMetTranslator = new hitfit::METTranslatorBase<pat::MET>(fileName("hitfitMETResolution"));
+
+    hitfit::Defaults_Text _defaults(fileName("hitfitDefault"));
+    pTopFit = new hitfit::Top_Fit(hitfit::Top_Fit_Args(_defaults), _lepWMass, _hadWMass, _topMass);
+    pDriver = new HitFitDriver(mPset);
+    pFit = new HitFitPermutationFit<pat::Jet>(*pTopFit, *pJetTranslator, *pDriver, _jetObjRes);
+
+    std::cout << mLegend << "up to " << maxNJet << " jets, " << pDriver->GetNWorkers() << " fit threads" << std::endl;
+
+    return 0;
+}
+
+int HitFitCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * selector)
+{
+    //
+    // _____ Get objects from the selector _____________________
+    //
+    std::vector<edm::Ptr<pat::Jet> > const & vSelJets = selector->GetSelectedJets();
+    std::vector<edm::Ptr<pat::Jet> > const & vSelBtagJets = selector->GetSelectedBtagJets();
+    std::vector<edm::Ptr<pat::Muon> > const & vSelMuons = selector->GetSelectedMuons();
+    std::vector<edm::Ptr<pat::Electron> > const & vSelElectrons = selector->GetSelectedElectrons();
+    edm::Ptr<pat::MET> const & pMet = selector->GetMet();
+
+    std::vector<pat::Jet> _jets;
+    std::vector<HitFitDriver::Jet> _driverJets;
+    for (unsigned int i = 0; i < vSelJets.size() && _jets.size() < maxNJet; ++i) {
+        if (vSelJets[i]->pt() < minJetPt) continue;
+        HitFitDriver::Jet _jet;
+        _jet.px = vSelJets[i]->px();
+        _jet.py = vSelJets[i]->py();
+        _jet.pz = vSelJets[i]->pz();
+        _jet.e = vSelJets[i]->energy();
+        _jet.btag = std::find(vSelBtagJets.begin(), vSelBtagJets.end(), vSelJets[i]) != vSelBtagJets.end();
+        _jets.push_back(*vSelJets[i]);
+        _driverJets.push_back(_jet);
+    }
+
+    bool _isMuon = vSelMuons.size() > 0;
+    double _leptonPt = _isMuon ? vSelMuons[0]->pt() : (vSelElectrons.size() > 0 ? vSelElectrons[0]->pt() : 0.0);
+
+    int _nHypotheses = 0;
+    int _nFitted = 0;
+    int _best = -1;
+    int _bestPruned = -1;
+    if (_leptonPt > minLeptonPt && pMet.isNonnull() && pMet->pt() > minMet && _jets.size() >= 4) {
+        hitfit::Lepjets_Event _event(event.id().run(), event.id().event());
+        if (_isMuon) _event.add_lep((*pMuonTranslator)(*vSelMuons[0], hitfit::lepton_label, muonObjRes));
+        else _event.add_lep((*pElectronTranslator)(*vSelElectrons[0], hitfit::lepton_label, electronObjRes));
+        _event.met() = (*pMetTranslator)(*pMet, metObjRes);
+        _event.kt_res() = pMetTranslator->KtResolution(*pMet, metObjRes);
+
+        _nFitted = pDriver->SetJets(_driverJets);
+        pFit->SetEvent(_event, _jets);
+        pDriver->Run(*pFit);
+        _nHypotheses = pDriver->GetHypotheses().size();
+        _best = pDriver->GetBest();
+        _bestPruned = pDriver->GetBestPruned();
+        ++nEvents;
+        nFits += _nFitted;
+        if (_bestPruned >= 0) {
+            ++nBestPruned;
+            std::cout << mLegend << "run " << event.id().run() << " event " << event.id().event()
+                      << ": pre-fit chi2 cut dropped the best fit, chi2 " << pDriver->GetHypotheses()[_bestPruned].chi2
+                      << " (pre-fit " << pDriver->GetHypotheses()[_bestPruned].preFitChi2 << "), kept "
+                      << (_best < 0 ? -1.0 : pDriver->GetHypotheses()[_best].chi2) << std::endl;
+        }
+    }
+
+    SetValue("hitfitNHypotheses", _nHypotheses);
+    SetValue("hitfitNFitted", _nFitted);
+    SetValue("hitfitNJet", _best < 0 ? 0 : (int)_jets.size());
+
+    hitfit::Fit_Result const * _result = _best < 0 ? 0 : pFit->GetResult(_best);
+    SetValue("hitfitConverged", _result != 0);
+    SetValue("hitfitChi2", _result ? _result->chisq() : -1.0);
+    SetValue("hitfitMt", _result ? _result->mt() : -1.0);
+    SetValue("hitfitSigmaMt", _result ? _result->sigmt() : -1.0);
+    SetValue("hitfitUnfittedMWHad", _result ? _result->umwhad() : -1.0);
+    SetValue("hitfitUnfittedMTop", _result ? _result->utmass() : -1.0);
+
+    // jet roles of the best fit, in the order of the selected jets above the pt cut
+    std::vector<int> _roles;
+    if (_best >= 0) _roles = pDriver->GetHypotheses()[_best].roles;
+    SetValue("hitfitJetRoles", _roles);
+
+    // jet roles of the best fit dropped by the pre-fit chi2 cut, only with hitfitCheckPreFitChi2
+    if (pDriver->GetCheckPreFitChi2()) {
+        std::vector<int> _prunedRoles;
+        if (_bestPruned >= 0) _prunedRoles = pDriver->GetHypotheses()[_bestPruned].roles;
+        SetValue("hitfitPrunedBestChi2", _bestPruned < 0 ? -1.0 : pDriver->GetHypotheses()[_bestPruned].chi2);
+        SetValue("hitfitPrunedBestJetRoles", _prunedRoles);
+    }
+
+    return 0;
+}
+
+std::vector<double> HitFitCalc::GetState() const
+{
+    std::vector<double> _state;
+    _state.push_back(nEvents);
+    _state.push_back(nFits);
+    _state.push_back(nBestPruned);
+    return _state;
+}
+
+void HitFitCalc::SetState(std::vector<double> const & state)
+{
+    if (state.size() != 3) return;
+    nEvents = (unsigned long)state[0];
+    nFits = (unsigned long)state[1];
+    nBestPruned = (unsigned long)state[2];
+}
+
+int HitFitCalc::EndJob()
+{
+    if (nEvents > 0) {
+        std::cout << mLegend << nEvents << " events fitted, " << double(nFits)/nEvents << " fits per event" << std::endl;
+        if (pDriver->GetCheckPreFitChi2()) {
+            std::cout << mLegend << "pre-fit chi2 cut dropped the best fit in " << nBestPruned << " of " << nEvents << " events" << std::endl;
+        }
+    }
+    delete pFit;
+    delete pDriver;
+    delete pTopFit;
+    delete pMetTranslator;
+    delete pJetTranslator;
+    delete pMuonTranslator;
+    delete pElectronTranslator;
+    return 0;
+}
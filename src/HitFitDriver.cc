@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "LJMet/Com/interface/HitFitDriver.h"
+
+
+
+namespace {
+
+  double mass(HitFitDriver::Jet const & a, HitFitDriver::Jet const & b, HitFitDriver::Jet const * c = 0) {
+    double _e = a.e + b.e, _px = a.px + b.px, _py = a.py + b.py, _pz = a.pz + b.pz;
+    if (c) { _e += c->e; _px += c->px; _py += c->py; _pz += c->pz; }
+    double _m2 = _e*_e - _px*_px - _py*_py - _pz*_pz;
+    return _m2 > 0 ? std::sqrt(_m2) : 0.0;
+  }
+
+}
+
+
+
+HitFitDriver::HitFitDriver(edm::ParameterSet const & par):
+  next(0),
+  nPrunedBTag(0),
+  nPrunedChi2(0),
+  generation(0),
+  nRunWorkers(0),
+  nBusy(0),
+  stop(false)
+{
+  nWorkers       = par.exists("hitfitNWorkers")            ? par.getUntrackedParameter<unsigned int>("hitfitNWorkers")       : 1;
+  bTagPruning    = par.exists("hitfitBTagPruning")         ? par.getUntrackedParameter<int>("hitfitBTagPruning")             : 0;
+  maxPreFitChi2  = par.exists("hitfitMaxPreFitChi2")       ? par.getUntrackedParameter<double>("hitfitMaxPreFitChi2")        : 0.0;
+  checkPreFitChi2 = par.exists("hitfitCheckPreFitChi2")    ? par.getUntrackedParameter<bool>("hitfitCheckPreFitChi2")        : false;
+  jetResolution  = par.exists("hitfitPreFitJetResolution") ? par.getUntrackedParameter<double>("hitfitPreFitJetResolution")  : 0.1;
+  hadWMass       = par.exists("hitfitHadWMass")            ? par.getUntrackedParameter<double>("hitfitHadWMass")             : 80.4;
+  topMass        = par.exists("hitfitTopMass")             ? par.getUntrackedParameter<double>("hitfitTopMass")              : 0.0;
+
+  if (nWorkers == 0) nWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+  if (bTagPruning < 0 || bTagPruning > 2) {
+    std::cout << "[HitFitDriver]: hitfitBTagPruning must be 0, 1 or 2, exiting" << std::endl;
+    std::exit(-1);
+  }
+
+  for (unsigned int w = 1; w < nWorkers; ++w) {
+    pool.push_back(std::thread(&HitFitDriver::workerLoop, this, w));
+  }
+}
+
+
+
+HitFitDriver::~HitFitDriver()
+{
+  {
+    std::lock_guard<std::mutex> _lock(poolMutex);
+    stop = true;
+  }
+  wakeUp.notify_all();
+  for (unsigned int w = 0; w < pool.size(); ++w) pool[w].join();
+}
+
+
+
+unsigned int HitFitDriver::SetJets(std::vector<Jet> const & _jets)
+{
+  jets = _jets;
+  hypotheses.clear();
+  toFit.clear();
+  nPrunedBTag = 0;
+  nPrunedChi2 = 0;
+  if (jets.size() < 4) return 0;
+
+  unsigned int _nTags = 0;
+  for (unsigned int i = 0; i < jets.size(); ++i) _nTags += jets[i].btag;
+
+  // same enumeration as RunHitFit: both W daughters share one label
+  std::vector<int> _roles(jets.size(), roleUnknown);
+  _roles[0] = roleLepB;
+  _roles[1] = roleHadB;
+  _roles[2] = roleHadW;
+  _roles[3] = roleHadW;
+  std::stable_sort(_roles.begin(), _roles.end());
+
+  do {
+    bool _bTag = passBTag(_roles, _nTags);
+    double _chi2 = preFitChi2(_roles);
+    bool _chi2Ok = maxPreFitChi2 <= 0 || _chi2 < maxPreFitChi2;
+    for (int nusol = 0; nusol != 2; ++nusol) {
+      Hypothesis _h;
+      _h.roles = _roles;
+      _h.nuz = bool(nusol);
+      _h.preFitChi2 = _chi2;
+      _h.fit = _bTag && _chi2Ok;
+      _h.chi2 = -1;
+      if (!_bTag) ++nPrunedBTag;
+      else if (!_chi2Ok) ++nPrunedChi2;
+      // dropped by the pre-fit chi2 only: fitted anyway to check the cut
+      if (_bTag && (_chi2Ok || checkPreFitChi2)) toFit.push_back(hypotheses.size());
+      hypotheses.push_back(_h);
+    }
+  } while (std::next_permutation(_roles.begin(), _roles.end()));
+
+  return toFit.size();
+}
+
+
+
+void HitFitDriver::runTask()
+{
+  next = 0;
+  unsigned int _nThreads = nWorkers < toFit.size() ? nWorkers : toFit.size();
+
+  // a single fit, or a single worker, is not worth waking the pool
+  if (_nThreads > 1) {
+    {
+      std::lock_guard<std::mutex> _lock(poolMutex);
+      nRunWorkers = _nThreads;
+      nBusy = _nThreads - 1;
+      ++generation;
+    }
+    wakeUp.notify_all();
+  }
+
+  work(0);
+
+  if (_nThreads > 1) {
+    std::unique_lock<std::mutex> _lock(poolMutex);
+    while (nBusy > 0) done.wait(_lock);
+  }
+}
+
+
+
+void HitFitDriver::work(unsigned int worker)
+{
+  for (unsigned int i = next++; i < toFit.size(); i = next++) {
+    Hypothesis & _h = hypotheses[toFit[i]];
+    _h.chi2 = task(toFit[i], worker);
+  }
+}
+
+
+
+void HitFitDriver::workerLoop(unsigned int worker)
+{
+  unsigned long _seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> _lock(poolMutex);
+      while (!stop && generation == _seen) wakeUp.wait(_lock);
+      if (stop) return;
+      _seen = generation;
+      if (worker >= nRunWorkers) continue;
+    }
+    work(worker);
+    {
+      std::lock_guard<std::mutex> _lock(poolMutex);
+      if (--nBusy == 0) done.notify_one();
+    }
+  }
+}
+
+
+
+int HitFitDriver::GetBest() const
+{
+  int _best = -1;
+  for (unsigned int i = 0; i < hypotheses.size(); ++i) {
+    if (!hypotheses[i].fit || hypotheses[i].chi2 < 0) continue;
+    if (_best < 0 || hypotheses[i].chi2 < hypotheses[_best].chi2) _best = i;
+  }
+  return _best;
+}
+
+
+
+int HitFitDriver::GetBestPruned() const
+{
+  int _best = -1;
+  for (unsigned int i = 0; i < hypotheses.size(); ++i) {
+    if (hypotheses[i].chi2 < 0) continue;
+    if (_best < 0 || hypotheses[i].chi2 < hypotheses[_best].chi2) _best = i;
+  }
+  return _best >= 0 && !hypotheses[_best].fit ? _best : -1;
+}
+
+
+
+bool HitFitDriver::passBTag(std::vector<int> const & roles, unsigned int nTags) const
+{
+  if (bTagPruning == 0 || (bTagPruning == 1 && nTags > 2)) return true;
+
+  unsigned int _tagsAsB = 0;
+  for (unsigned int i = 0; i < roles.size(); ++i) {
+    if (!jets[i].btag) continue;
+    if (roles[i] == roleLepB || roles[i] == roleHadB) ++_tagsAsB;
+    else if (nTags <= 2) return false;
+  }
+  // up to two tags: all of them are b quarks, more: both b quarks are tagged
+  return _tagsAsB == std::min(nTags, 2u);
+}
+
+
+
+double HitFitDriver::preFitChi2(std::vector<int> const & roles) const
+{
+  if (maxPreFitChi2 <= 0) return 0.0;
+
+  int _w[2] = { -1, -1 }, _b = -1;
+  for (unsigned int i = 0; i < roles.size(); ++i) {
+    if (roles[i] == roleHadW) _w[_w[0] < 0 ? 0 : 1] = i;
+    if (roles[i] == roleHadB) _b = i;
+  }
+
+  // sigma(m)/m = 1/2 sqrt(sum of (sigma(E)/E)^2) for massless jets
+  double _mW = mass(jets[_w[0]], jets[_w[1]]);
+  double _sigmaW = 0.5*std::sqrt(2.0)*jetResolution*_mW;
+  double _chi2 = _sigmaW > 0 ? std::pow((_mW - hadWMass)/_sigmaW, 2) : 0.0;
+
+  if (topMass > 0) {
+    double _mTop = mass(jets[_w[0]], jets[_w[1]], &jets[_b]);
+    double _sigmaTop = 0.5*std::sqrt(3.0)*jetResolution*_mTop;
+    if (_sigmaTop > 0) _chi2 += std::pow((_mTop - topMass)/_sigmaTop, 2);
+  }
+  return _chi2;
+}
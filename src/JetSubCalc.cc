@@ -4,14 +4,18 @@
  Author: Joshua Swanson, 2014
  */
 
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <limits>   // std::numeric_limits
 #include <vector>
 #include <string>
 
 #include "LJMet/Com/interface/BaseCalc.h"
+#include "LJMet/Com/interface/ConstituentPacking.h"
 #include "LJMet/Com/interface/LjmetFactory.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
+#include "LJMet/Com/interface/NsubjettinessEngine.h"
 #include "DataFormats/PatCandidates/interface/Jet.h"
 #include "DataFormats/PatCandidates/interface/PackedCandidate.h"
 #include "DataFormats/PatCandidates/interface/PATObject.h"
@@ -33,11 +37,40 @@ private:
     edm::InputTag slimmedJetsAK8Coll_it;
     std::string bDiscriminant;
     std::string tagInfo;
+    bool recomputeNsubjettiness;
+    NsubjettinessEngine nsubEngine;
+    std::vector<double> daughterPx, daughterPy, daughterPz, daughterE;
+    
+    // how the jet constituents go to the ntuple
+    enum ConstituentFormat {
+        doubleFormat,  // per-constituent double vectors with mother index
+        floatFormat,   // per-jet offsets plus flat float vectors
+        int16Format,   // per-jet offsets plus 16-bit packed vectors (ConstituentPacking.h)
+        summaryFormat  // no constituents, per-jet summaries only
+    };
+    ConstituentFormat constituentFormat;
+    
+    // compact constituent output, buffers kept between events;
+    // constituents of jet i are [offset[i], offset[i+1])
+    struct Constituents {
+        std::vector<int>   offset;
+        std::vector<float> pt, eta, phi, energy;
+        std::vector<short> ptPacked, etaPacked, phiPacked, energyPacked;
+        void clear();
+    };
+    Constituents ak4Constituents, ak8Constituents;
+    
+    void addConstituents(pat::Jet const & jet, Constituents & out);
+    void setConstituents(std::string prefix, Constituents const & in);
+    /// sqrt(sum pt^2)/sum pt of the constituents
+    double ptD(pat::Jet const & jet);
 };
 
-static int reg = LjmetFactory::GetInstance()->Register(new JetSubCalc(), "JetSubCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<JetSubCalc>, "JetSubCalc");
 
-JetSubCalc::JetSubCalc()
+JetSubCalc::JetSubCalc():
+nsubEngine(NsubjettinessEngine::onepass_kt_axes, 1.0, 0.8),
+constituentFormat(doubleFormat)
 {
 }
 
@@ -59,9 +92,87 @@ int JetSubCalc::BeginJob()
     if (mPset.exists("tagInfo")) tagInfo = mPset.getParameter<std::string>("tagInfo");
     else tagInfo = "caTop";
     
+    // recompute tau1..tau3 from the AK8 constituents instead of reading the userFloats
+    if (mPset.exists("recomputeNsubjettiness")) recomputeNsubjettiness = mPset.getParameter<bool>("recomputeNsubjettiness");
+    else recomputeNsubjettiness = false;
+    
+    std::string _format = "double";
+    if (mPset.exists("constituentFormat")) _format = mPset.getParameter<std::string>("constituentFormat");
+    if (_format == "double") constituentFormat = doubleFormat;
+    else if (_format == "float") constituentFormat = floatFormat;
+    else if (_format == "int16") constituentFormat = int16Format;
+    else if (_format == "summary") constituentFormat = summaryFormat;
+    else {
+        std::cout << mLegend << "unknown constituentFormat " << _format
+                  << ", expect one of double, float, int16, summary. Exiting" << std::endl;
+        std::exit(-1);
+    }
+    
     return 0;
 }
 
+void JetSubCalc::Constituents::clear()
+{
+    offset.clear();
+    offset.push_back(0);
+    pt.clear();
+    eta.clear();
+    phi.clear();
+    energy.clear();
+    ptPacked.clear();
+    etaPacked.clear();
+    phiPacked.clear();
+    energyPacked.clear();
+}
+
+void JetSubCalc::addConstituents(pat::Jet const & jet, Constituents & out)
+{
+    for (size_t ui = 0; ui < jet.numberOfDaughters(); ui++) {
+        reco::Candidate const * theDaughter = jet.daughter(ui);
+        if (constituentFormat == floatFormat) {
+            out.pt    .push_back(theDaughter->pt());
+            out.eta   .push_back(theDaughter->eta());
+            out.phi   .push_back(theDaughter->phi());
+            out.energy.push_back(theDaughter->energy());
+        }
+        else {
+            out.ptPacked    .push_back(ConstituentPacking::PackLog(theDaughter->pt()));
+            out.etaPacked   .push_back(ConstituentPacking::PackEta(theDaughter->eta()));
+            out.phiPacked   .push_back(ConstituentPacking::PackPhi(theDaughter->phi()));
+            out.energyPacked.push_back(ConstituentPacking::PackLog(theDaughter->energy()));
+        }
+    }
+    out.offset.push_back(out.offset.back() + (int)jet.numberOfDaughters());
+}
+
+void JetSubCalc::setConstituents(std::string prefix, Constituents const & in)
+{
+    SetValue(prefix + "DaughterOffset", in.offset);
+    if (constituentFormat == floatFormat) {
+        SetValue(prefix + "DaughterPt",     in.pt);
+        SetValue(prefix + "DaughterEta",    in.eta);
+        SetValue(prefix + "DaughterPhi",    in.phi);
+        SetValue(prefix + "DaughterEnergy", in.energy);
+    }
+    else {
+        SetValue(prefix + "DaughterPtPacked",     in.ptPacked);
+        SetValue(prefix + "DaughterEtaPacked",    in.etaPacked);
+        SetValue(prefix + "DaughterPhiPacked",    in.phiPacked);
+        SetValue(prefix + "DaughterEnergyPacked", in.energyPacked);
+    }
+}
+
+double JetSubCalc::ptD(pat::Jet const & jet)
+{
+    double _sumPt = 0.0, _sumPt2 = 0.0;
+    for (size_t ui = 0; ui < jet.numberOfDaughters(); ui++) {
+        double _pt = jet.daughter(ui)->pt();
+        _sumPt  += _pt;
+        _sumPt2 += _pt*_pt;
+    }
+    return _sumPt > 0.0 ? std::sqrt(_sumPt2)/_sumPt : 0.0;
+}
+
 int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * selector)
 {
     float subjetCSV;
@@ -103,6 +214,11 @@ int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * s
     
     std::vector<int> theJetDaughterMotherIndex;
     
+    // summaries instead of constituents
+    std::vector<double> theJetPtD;
+    
+    ak4Constituents.clear();
+    
     std::vector<int> theJetCSVLSubJets;
     std::vector<int> theJetCSVMSubJets;
     std::vector<int> theJetCSVTSubJets;
@@ -148,7 +264,10 @@ int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * s
         CSVT = 0;
         subjetCSV = -std::numeric_limits<float>::max();
         
-        for (size_t ui = 0; ui < ijet->numberOfDaughters(); ui++) {
+        if (constituentFormat == summaryFormat) theJetPtD.push_back(ptD(*ijet));
+        else if (constituentFormat != doubleFormat) addConstituents(*ijet, ak4Constituents);
+        
+        for (size_t ui = 0; constituentFormat == doubleFormat && ui < ijet->numberOfDaughters(); ui++) {
             pat::PackedCandidate const * theDaughter = dynamic_cast<pat::PackedCandidate const *>(ijet->daughter(ui));
             
             theJetDaughterPt    .push_back(theDaughter->pt());
@@ -191,12 +310,18 @@ int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * s
     SetValue("theJetIndex",      theJetIndex);
     SetValue("theJetnDaughters", theJetnDaughters);
     
-    SetValue("theJetDaughterPt",     theJetDaughterPt);
-    SetValue("theJetDaughterEta",    theJetDaughterEta);
-    SetValue("theJetDaughterPhi",    theJetDaughterPhi);
-    SetValue("theJetDaughterEnergy", theJetDaughterEnergy);
-    
-    SetValue("theJetDaughterMotherIndex", theJetDaughterMotherIndex);
+    if (constituentFormat == doubleFormat) {
+        SetValue("theJetDaughterPt",     theJetDaughterPt);
+        SetValue("theJetDaughterEta",    theJetDaughterEta);
+        SetValue("theJetDaughterPhi",    theJetDaughterPhi);
+        SetValue("theJetDaughterEnergy", theJetDaughterEnergy);
+        
+        SetValue("theJetDaughterMotherIndex", theJetDaughterMotherIndex);
+    }
+    else if (constituentFormat == summaryFormat) {
+        SetValue("theJetPtD", theJetPtD);
+    }
+    else setConstituents("theJet", ak4Constituents);
     
     SetValue("theJetCSVLSubJets", theJetCSVLSubJets);
     SetValue("theJetCSVMSubJets", theJetCSVMSubJets);
@@ -239,6 +364,13 @@ int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * s
     
     std::vector<int> theJetAK8DaughterMotherIndex;
     
+    // summaries instead of constituents
+    std::vector<double> theJetAK8PtD;
+    std::vector<double> theJetAK8NjettinessTau21;
+    std::vector<double> theJetAK8NjettinessTau32;
+    
+    ak8Constituents.clear();
+    
     std::vector<int> theJetAK8CSVLSubJets;
     std::vector<int> theJetAK8CSVMSubJets;
     std::vector<int> theJetAK8CSVTSubJets;
@@ -264,6 +396,25 @@ int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * s
         theNjettinessTau1 = (double)ijet->userFloat("NjettinessAK8:tau1");
         theNjettinessTau2 = (double)ijet->userFloat("NjettinessAK8:tau2");
         theNjettinessTau3 = (double)ijet->userFloat("NjettinessAK8:tau3");
+        
+        if (recomputeNsubjettiness) {
+            daughterPx.clear();
+            daughterPy.clear();
+            daughterPz.clear();
+            daughterE.clear();
+            for (size_t ui = 0; ui < ijet->numberOfDaughters(); ui++) {
+                reco::Candidate const * theDaughter = ijet->daughter(ui);
+                daughterPx.push_back(theDaughter->px());
+                daughterPy.push_back(theDaughter->py());
+                daughterPz.push_back(theDaughter->pz());
+                daughterE .push_back(theDaughter->energy());
+            }
+            double tau[3];
+            nsubEngine.GetTaus(3, daughterPx.data(), daughterPy.data(), daughterPz.data(), daughterE.data(), daughterPx.size(), tau);
+            theNjettinessTau1 = tau[0];
+            theNjettinessTau2 = tau[1];
+            theNjettinessTau3 = tau[2];
+        }
 
         theJetAK8Pt    .push_back(ijet->pt());
         theJetAK8Eta   .push_back(ijet->eta());
@@ -305,7 +456,14 @@ int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * s
         CSVM = 0;
         CSVT = 0;
         
-        for (size_t ui = 0; ui < ijet->numberOfDaughters(); ui++) {
+        if (constituentFormat == summaryFormat) {
+            theJetAK8PtD.push_back(ptD(*ijet));
+            theJetAK8NjettinessTau21.push_back(theNjettinessTau1 > 0.0 ? theNjettinessTau2/theNjettinessTau1 : -1.0);
+            theJetAK8NjettinessTau32.push_back(theNjettinessTau2 > 0.0 ? theNjettinessTau3/theNjettinessTau2 : -1.0);
+        }
+        else if (constituentFormat != doubleFormat) addConstituents(*ijet, ak8Constituents);
+        
+        for (size_t ui = 0; constituentFormat == doubleFormat && ui < ijet->numberOfDaughters(); ui++) {
             pat::PackedCandidate const * theDaughter = dynamic_cast<pat::PackedCandidate const *>(ijet->daughter(ui));
             theJetAK8DaughterPt    .push_back(theDaughter->pt());
             theJetAK8DaughterEta   .push_back(theDaughter->eta());
@@ -353,12 +511,20 @@ int JetSubCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector * s
     SetValue("theJetAK8caTopMinMass", theJetAK8caTopMinMass);
     SetValue("theJetAK8caTopnSubJets", theJetAK8caTopnSubJets);
     
-    SetValue("theJetAK8DaughterPt",     theJetAK8DaughterPt);
-    SetValue("theJetAK8DaughterEta",    theJetAK8DaughterEta);
-    SetValue("theJetAK8DaughterPhi",    theJetAK8DaughterPhi);
-    SetValue("theJetAK8DaughterEnergy", theJetAK8DaughterEnergy);
-    
-    SetValue("theJetAK8DaughterMotherIndex", theJetAK8DaughterMotherIndex);
+    if (constituentFormat == doubleFormat) {
+        SetValue("theJetAK8DaughterPt",     theJetAK8DaughterPt);
+        SetValue("theJetAK8DaughterEta",    theJetAK8DaughterEta);
+        SetValue("theJetAK8DaughterPhi",    theJetAK8DaughterPhi);
+        SetValue("theJetAK8DaughterEnergy", theJetAK8DaughterEnergy);
+        
+        SetValue("theJetAK8DaughterMotherIndex", theJetAK8DaughterMotherIndex);
+    }
+    else if (constituentFormat == summaryFormat) {
+        SetValue("theJetAK8PtD",             theJetAK8PtD);
+        SetValue("theJetAK8NjettinessTau21", theJetAK8NjettinessTau21);
+        SetValue("theJetAK8NjettinessTau32", theJetAK8NjettinessTau32);
+    }
+    else setConstituents("theJetAK8", ak8Constituents);
     
     SetValue("theJetAK8CSVLSubJets", theJetAK8CSVLSubJets);
     SetValue("theJetAK8CSVMSubJets", theJetAK8CSVMSubJets);
@@ -2,9 +2,10 @@
 #include "LJMet/Com/interface/TopTopologicalVariables.h"
 #include "LJMet/Com/interface/AnglesUtil.h"
 #include "LJMet/Com/interface/TopAngleUtils.h"
+#include "LJMet/Com/interface/EventShapeUtils.h"
 
-#include "TMatrixDSymEigen.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -118,25 +119,19 @@ int LJetsTopoVarsNew::setEvent(const vector<std::pair<TLorentzVector,bool> > jet
             /// alternative method estimate Pz of neutrino//////////////
             /****************************************************************/
             TLorentzVector p4Nu, p4OtherNu;
-            fzCalculator.SetMET(m_met);
-            fzCalculator.SetLepton(m_lepton);
-            if (m_isMuon) {
-                fzCalculator.SetLeptonType("muon");
-            } else {
-                fzCalculator.SetLeptonType("electron");
-            }
+            NeutrinoSolver::Solution nuSolution = NeutrinoSolver::GetInstance()->Solve(neutrinoInput());
             
-            double pzNu = fzCalculator.Calculate();
+            double pzNu = nuSolution.best[NeutrinoSolver::nearestLeptonOrCentral];
             p4Nu = TLorentzVector();
             p4OtherNu = TLorentzVector();
             
             p4Nu.SetPxPyPzE(m_met.Px(), m_met.Py(), pzNu, sqrt(m_met.Px()*m_met.Px()+m_met.Py()*m_met.Py()+pzNu*pzNu));
-            double pzOtherNu = fzCalculator.getOther();
+            double pzOtherNu = nuSolution.other[NeutrinoSolver::nearestLeptonOrCentral];
             p4OtherNu.SetPxPyPzE( m_met.Px(), m_met.Py(),pzOtherNu,sqrt(m_met.Px()*m_met.Px()+m_met.Py()*m_met.Py()+pzOtherNu*pzOtherNu));
             //std::cout<<"metx "<<m_met.Px()<<" mety "<<m_met.Py()<<" pzNu "<<pzNu<<" pzOtherNu "<<pzOtherNu<<std::endl;
-            if ( fzCalculator.IsComplex() ) {
-                double ptNu1 = fzCalculator.getPtneutrino(1);
-                double ptNu2 = fzCalculator.getPtneutrino(2);
+            if ( nuSolution.isComplex ) {
+                double ptNu1 = nuSolution.ptNu[0];
+                double ptNu2 = nuSolution.ptNu[1];
                 TLorentzVector p4Nu1tmp;
                 TLorentzVector p4Nu2tmp;
                 
@@ -188,42 +183,13 @@ int LJetsTopoVarsNew::setEvent(const vector<std::pair<TLorentzVector,bool> > jet
         }
         
         else {
-            double nu_pz = 0.;
-            double othernu_pz = 0.;
+            // D0 style: MET rescaled if mT > mW, choose solution with smallest |pz| a la Run I
+            NeutrinoSolver::Solution nuSolution = NeutrinoSolver::GetInstance()->Solve(neutrinoInput());
+            nu_px = nuSolution.mtPx;
+            nu_py = nuSolution.mtPy;
             double nu_e  = sqrt(pow(nu_px,2)+pow(nu_py,2));
-            
-            double Mw    = 80.4;  // NGO fix this!(read from one place)
-            double l_px  = m_lepton.Px();
-            double l_py  = m_lepton.Py();
-            double l_pz  = m_lepton.Pz();
-            double l_pt  = m_lepton.Pt();
-            double l_e   = m_lepton.E();
-            double Mt    = sqrt(pow(l_pt+nu_e ,2)-
-                                pow(l_px+nu_px,2)-
-                                pow(l_py+nu_py,2));
-            //if(debug) cout << "making W Mt = " << Mt << endl;
-            double A;
-            if (Mt<Mw) A = pow(Mw,2)/2.;
-            else       {           // assume Mt=Mw, rescale MET accordingly (NGO???)
-                A = pow(Mt,2)/2.;
-                double k = nu_e*l_pt - nu_px*l_px - nu_py*l_py;
-                k = (k == 0. ? 0.00001 : k);
-                //if(debug) cout << "K = " << k << endl;
-                double scf = 0.5*pow(Mw,2)/k ;
-                //if(debug) cout << "neutrio px py before  = " << nu_px  << " " << nu_py <<  endl;
-                nu_px *= scf;
-                nu_py *= scf;
-                //if(debug) cout << "neutrio px py after  = " << nu_px  << " " << nu_py <<  endl;
-                nu_e = sqrt(pow(nu_px,2)+pow(nu_py,2));
-            }
-            double B = nu_px*l_px + nu_py*l_py;
-            double C = TMath::Max(1. + pow(nu_e,2) * (pow(l_pz,2)-pow(l_e,2)) / pow(A+B,2)  , 0.);
-            C = sqrt(C);
-            double S1= (-(A+B)*l_pz + (A+B)*l_e*C) / (pow(l_pz,2)-pow(l_e,2));
-            double S2= (-(A+B)*l_pz - (A+B)*l_e*C) / (pow(l_pz,2)-pow(l_e,2));
-            // choose solution with smallest |l_pz| a la Run I
-            nu_pz = fabs (S1) < fabs (S2) ? S1 : S2 ;
-            othernu_pz = fabs (S1) < fabs (S2) ? S2 : S1 ;
+            double nu_pz = nuSolution.mtPz[0];
+            double othernu_pz = nuSolution.mtPz[1];
             
             //NGO: NOTE: neutrino PX, PY are not necessarily metPX, metPY any more!!!
             _neutrino.SetPxPyPzE(nu_px,nu_py,nu_pz,nu_e);
@@ -340,6 +306,21 @@ int LJetsTopoVarsNew::setEventMetFixed(TLorentzVector& Jet1, TLorentzVector& Jet
 }
 
 
+NeutrinoSolver::Input LJetsTopoVarsNew::neutrinoInput() const
+{
+    NeutrinoSolver::Input _in;
+    _in.lepPx = m_lepton.Px();
+    _in.lepPy = m_lepton.Py();
+    _in.lepPz = m_lepton.Pz();
+    _in.lepE  = m_lepton.E();
+    _in.metPx = m_met.Px();
+    _in.metPy = m_met.Py();
+    _in.metE  = m_met.E();
+    _in.leptonMass = m_isMuon ? 0.105658367 : 0.00051099891;
+    _in.mW = 80.4;  // NGO fix this!(read from one place)
+    return _in;
+}
+
 double LJetsTopoVarsNew::pznu() const
 {
     return _neutrino.Pz();
@@ -1387,40 +1368,33 @@ void LJetsTopoVarsNew::calcEvtTopo(){
     //evtTopo[1] = aplanarity
     //evtTopo[2] = aplanarity including muon
     
-    int nJet = m_jets.size();
-    
     // calculate tensor
     //
-    double psum = 0.;
-    for(int k=0;k<nJet;k++){
-        psum += m_jets[k].Vect().Mag32();
-    }
+    double M[EventShapeUtils::kNTensor];
+    double psum;
+    EventShapeUtils::ResetMomentumTensor(M, psum);
+    EventShapeUtils::AccumulateMomentumTensor(m_jets, M, psum);
     
-    TMatrixDSym M(3);
-    for(int i=0;i<3;i++){
-        for(int j=i;j<3;j++){
-            M(i,j)=0.;
-            for(int k=0;k<nJet;k++){
-                M(i,j) += m_jets[k](i) * m_jets[k](j);
-            }
-            M(i,j)/=psum;
-            if(i!=j){M(j,i) = M(i,j);}
-        }
-    }
+    // keep the unnormalized jet tensor for the muon-included variant
+    double M_01[EventShapeUtils::kNTensor];
+    double psum_01 = psum;
+    std::copy(M, M+EventShapeUtils::kNTensor, M_01);
+    
+    EventShapeUtils::NormalizeMomentumTensor(M, psum);
     
     //
     // get eigenvalues
     //
-    TMatrixDSymEigen eigenMatrix(M);
-    const TVectorD *eigen = &eigenMatrix.GetEigenValues();
+    double eigen[3];
+    EventShapeUtils::SymmetricEigenvalues3x3(M, eigen);
     
-    eigenval.ResizeTo(eigen->GetNrows());
-    eigenval = *eigen;
+    eigenval.ResizeTo(3);
     
     //NGO fix eigenvalues to zero if too small
     //otherwise ev might be marginally below zero!
     for(int i=0;i<3;i++){
-        if(fabs(eigenval[i])<1e-10) eigenval[i]=0.;
+        if(fabs(eigen[i])<1e-10) eigen[i]=0.;
+        eigenval[i] = eigen[i];
     }
     
     _evtTopo[0] = (3./2.) * (eigenval[1]+eigenval[2]);
@@ -1439,7 +1413,9 @@ void LJetsTopoVarsNew::calcEvtTopo(){
     if(_evtTopo[0]<0. || _evtTopo[1]<0.){
         cout << "ERROR: SPHERICITY: " << _evtTopo[0] << endl;
         cout << "ERROR: APLANARITY: " << _evtTopo[1] << endl;
-        M.Print();
+        cout << "ERROR: TENSOR (xx xy xz yy yz zz):";
+        for(int i=0;i<EventShapeUtils::kNTensor;i++) cout << " " << M[i];
+        cout << endl;
     }
     
     
@@ -1448,30 +1424,12 @@ void LJetsTopoVarsNew::calcEvtTopo(){
     // include muon in calculation
     //
     // ------------------------------------------------------
-    std::vector<TMBLorentzVector> jetMu(m_jets);
-    jetMu.push_back(m_lepton);
-    nJet = jetMu.size();
-    
-    // calculate tensor
-    psum = 0.;
-    for(int k=0;k<nJet;k++){
-        psum += jetMu[k].Vect().Mag32();
-    }
-    
-    for(int i=0;i<3;i++){
-        for(int j=i;j<3;j++){
-            M(i,j)=0.;
-            for(int k=0;k<nJet;k++){
-                M(i,j) += jetMu[k](i) * jetMu[k](j);
-            }
-            M(i,j)/=psum;
-            if(i!=j){M(j,i) = M(i,j);}
-        }
-    }
+    EventShapeUtils::AddToMomentumTensor(m_lepton.Px(), m_lepton.Py(), m_lepton.Pz(), M_01, psum_01);
+    EventShapeUtils::NormalizeMomentumTensor(M_01, psum_01);
     
     // get eigenvalues
-    TMatrixDSymEigen       eigenMatrix_01(M);
-    TVectorD eigenval_01 = eigenMatrix_01.GetEigenValues();
+    double eigenval_01[3];
+    EventShapeUtils::SymmetricEigenvalues3x3(M_01, eigenval_01);
     for(int i=0;i<3;i++){
         if(fabs(eigenval_01[i])<1e-10) eigenval_01[i]=0.;
     }
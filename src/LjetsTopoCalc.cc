@@ -45,7 +45,7 @@ private:
 
 
 
-//static int reg = LjmetFactory::GetInstance()->Register(new LjetsTopoCalc(), "LjetsTopoCalc");
+//static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<LjetsTopoCalc>, "LjetsTopoCalc");
 
 
 
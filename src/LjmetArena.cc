@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#include "LJMet/Com/interface/LjmetArena.h"
+
+namespace {
+    /// first block, enough for the temporaries of a typical event
+    std::size_t const kFirstBlockSize = 256 * 1024;
+
+    /// heap allocations of the process, relaxed: the prefetch thread allocates too
+    std::atomic<unsigned long long> gHeapAllocations(0);
+}
+
+LjmetArena * LjmetArena::GetInstance()
+{
+    static LjmetArena instance;
+    return &instance;
+}
+
+LjmetArena::LjmetArena():
+mLegend("[LjmetArena]: "),
+mBlock(0),
+mUsedBefore(0),
+mInEvent(false),
+mEvents(0),
+mAllocations(0),
+mHeapAtBegin(0),
+mHeapAllocations(0),
+mMaxBytes(0)
+{
+    Block _block;
+    _block.size = kFirstBlockSize;
+    _block.begin = static_cast<char *>(std::malloc(_block.size));
+    if (!_block.begin) {
+        std::cout << mLegend << "cannot allocate " << _block.size << " bytes, exiting" << std::endl;
+        std::exit(-1);
+    }
+    mvBlocks.push_back(_block);
+    mpCur = _block.begin;
+    mpEnd = _block.begin + _block.size;
+}
+
+LjmetArena::~LjmetArena()
+{
+    for (unsigned int i = 0; i < mvBlocks.size(); ++i) std::free(mvBlocks[i].begin);
+}
+
+void * LjmetArena::allocateSlow(std::size_t bytes, std::size_t align)
+{
+    // the next block kept from an earlier event, or a new one twice as large
+    mUsedBefore += mpCur - mvBlocks[mBlock].begin;
+    ++mBlock;
+    if (mBlock == mvBlocks.size() || mvBlocks[mBlock].size < bytes + align) {
+        Block _block;
+        _block.size = std::max(2 * mvBlocks.back().size, bytes + align);
+        _block.begin = static_cast<char *>(std::malloc(_block.size));
+        if (!_block.begin) {
+            std::cout << mLegend << "cannot allocate " << _block.size << " bytes, exiting" << std::endl;
+            std::exit(-1);
+        }
+        mvBlocks.insert(mvBlocks.begin() + mBlock, _block);
+    }
+    mpCur = mvBlocks[mBlock].begin;
+    mpEnd = mpCur + mvBlocks[mBlock].size;
+
+    // counted again by Allocate
+    --mAllocations;
+    return Allocate(bytes, align);
+}
+
+void LjmetArena::Reset()
+{
+    std::size_t _used = mUsedBefore + (mpCur - mvBlocks[mBlock].begin);
+    mMaxBytes = std::max(mMaxBytes, _used);
+
+    // the event spilled over several blocks: one block for all of them,
+    // so that the next events are served from a single block
+    if (mBlock > 0) {
+        std::size_t _size = 0;
+        for (unsigned int i = 0; i < mvBlocks.size(); ++i) {
+            _size += mvBlocks[i].size;
+            std::free(mvBlocks[i].begin);
+        }
+        mvBlocks.resize(1);
+        mvBlocks[0].size = _size;
+        mvBlocks[0].begin = static_cast<char *>(std::malloc(_size));
+        if (!mvBlocks[0].begin) {
+            std::cout << mLegend << "cannot allocate " << _size << " bytes, exiting" << std::endl;
+            std::exit(-1);
+        }
+    }
+    mBlock = 0;
+    mUsedBefore = 0;
+    mpCur = mvBlocks[0].begin;
+    mpEnd = mpCur + mvBlocks[0].size;
+}
+
+void LjmetArena::BeginEvent()
+{
+    // events failing the selection do not reach RunEndEvent, rewind here too
+    closeEvent();
+    Reset();
+    mInEvent = true;
+    mHeapAtBegin = gHeapAllocations.load(std::memory_order_relaxed);
+}
+
+void LjmetArena::closeEvent()
+{
+    if (!mInEvent) return;
+    ++mEvents;
+    mHeapAllocations += gHeapAllocations.load(std::memory_order_relaxed) - mHeapAtBegin;
+    mInEvent = false;
+}
+
+void LjmetArena::CountHeapAllocation()
+{
+    gHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LjmetArena::Report(std::ostream & out)
+{
+    closeEvent();
+    if (mEvents == 0) return;
+
+    double _arena = double(mAllocations) / mEvents;
+    out << mLegend << "allocations per event in " << mEvents << " events" << std::endl;
+    if (gHeapAllocations.load(std::memory_order_relaxed) > 0) {
+        double _heap = double(mHeapAllocations) / mEvents;
+        out << mLegend << "    heap " << _heap << ", without the arena " << _heap + _arena << std::endl;
+    }
+    else {
+        out << mLegend << "    heap not counted by this executable" << std::endl;
+    }
+    out << mLegend << "    arena " << _arena << ", largest event " << mMaxBytes / 1024 << " kB, "
+        << mvBlocks[0].size / 1024 << " kB reserved" << std::endl;
+}
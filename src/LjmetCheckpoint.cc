@@ -0,0 +1,205 @@
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+#include "TClass.h"
+#include "TH1.h"
+#include "TKey.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "LJMet/Com/interface/LjmetCheckpoint.h"
+
+namespace {
+    // FNV-1a
+    void hashString(std::string const & s, unsigned long long & hash) {
+        for (size_t i = 0; i <= s.size(); ++i) {
+            hash ^= (unsigned char)s.c_str()[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    /// Delete the keys of dir and its subdirectories that are not the cycle to keep,
+    /// a name without that cycle keeps its newest one
+    void keepCycle(TDirectory * dir, short cycle) {
+        std::map<std::string, short> _kept;
+        std::vector<std::string> _subdirs;
+        TIter _next(dir->GetListOfKeys());
+        while (TKey * _key = (TKey *)_next()) {
+            TClass * _class = TClass::GetClass(_key->GetClassName());
+            if (_class && _class->InheritsFrom(TDirectory::Class())) {
+                _subdirs.push_back(_key->GetName());
+                continue;
+            }
+            short & _keptCycle = _kept[_key->GetName()];
+            if (_keptCycle != cycle && _key->GetCycle() > _keptCycle) _keptCycle = _key->GetCycle();
+            if (_key->GetCycle() == cycle) _keptCycle = cycle;
+        }
+        
+        std::vector<std::string> _delete;
+        _next.Reset();
+        while (TKey * _key = (TKey *)_next()) {
+            std::map<std::string, short>::const_iterator _k = _kept.find(_key->GetName());
+            if (_k == _kept.end() || _key->GetCycle() == _k->second) continue;
+            std::ostringstream _name;
+            _name << _key->GetName() << ";" << _key->GetCycle();
+            _delete.push_back(_name.str());
+        }
+        for (size_t i = 0; i < _delete.size(); ++i) dir->Delete(_delete[i].c_str());
+        
+        for (size_t i = 0; i < _subdirs.size(); ++i) {
+            TDirectory * _subdir = dir->GetDirectory(_subdirs[i].c_str());
+            if (_subdir) keepCycle(_subdir, cycle);
+        }
+    }
+}
+
+LjmetCheckpoint::LjmetCheckpoint(std::string const & outputName, std::string const & treeName,
+                                 std::vector<std::string> const & fileNames, int skipEvents, int nEvents):
+mLegend("[LjmetCheckpoint]: "),
+mOutputName(outputName),
+mTreeName(treeName),
+mFileName(outputName + ".ckpt"),
+mInputHash(14695981039346656037ULL),
+mEntry(0),
+mProcessed(0),
+mTreeEntries(0),
+mCycle(0)
+{
+    for (unsigned int i = 0; i < fileNames.size(); ++i) hashString(fileNames[i], mInputHash);
+    std::ostringstream _range;
+    _range << skipEvents << " " << nEvents;
+    hashString(_range.str(), mInputHash);
+}
+
+bool LjmetCheckpoint::Read()
+{
+    std::ifstream _file(mFileName.c_str());
+    if (!_file) return false;
+    
+    std::string _key;
+    unsigned long long _hash = 0;
+    size_t _nCuts = 0;
+    size_t _nCalcs = 0;
+    _file >> _key >> _hash >> _key >> mEntry >> _key >> mProcessed >> _key >> mTreeEntries >> _key >> mCycle >> _key >> _nCuts;
+    mvCutFlow.resize(_nCuts);
+    for (size_t i = 0; i < _nCuts; ++i) _file >> mvCutFlow[i];
+    _file >> _key >> _nCalcs;
+    mCalcState.clear();
+    for (size_t i = 0; i < _nCalcs && _file; ++i) {
+        std::string _name;
+        size_t _nValues = 0;
+        _file >> _name >> _nValues;
+        std::vector<double> & _state = mCalcState[_name];
+        _state.resize(_nValues);
+        for (size_t k = 0; k < _nValues; ++k) _file >> _state[k];
+    }
+    if (!_file) {
+        std::cout << mLegend << "cannot read " << mFileName << ", starting from the beginning" << std::endl;
+        return false;
+    }
+    if (_hash != mInputHash) {
+        std::cout << mLegend << mFileName << " is for other inputs, starting from the beginning" << std::endl;
+        return false;
+    }
+    std::cout << mLegend << "resuming at entry " << mEntry << " with " << mTreeEntries << " selected events" << std::endl;
+    return true;
+}
+
+TFile * LjmetCheckpoint::OpenOutput()
+{
+    std::string _outputFileName = mOutputName + ".root";
+    if (gSystem->AccessPathName(_outputFileName.c_str())) {
+        std::cout << mLegend << "no output " << _outputFileName << ", starting from the beginning" << std::endl;
+        return 0;
+    }
+    TFile * _file = TFile::Open(_outputFileName.c_str(), "UPDATE");
+    if (!_file || _file->IsZombie()) {
+        std::cout << mLegend << "cannot open " << _outputFileName << ", starting from the beginning" << std::endl;
+        delete _file;
+        return 0;
+    }
+    
+    // A job killed after the output was written but before the sidecar was
+    // updated leaves a newer cycle, the checkpointed one is still there
+    std::ostringstream _cycle;
+    _cycle << ";" << mCycle;
+    TTree * _tree = 0;
+    TH1 * _nevents = 0;
+    _file->GetObject((mTreeName + _cycle.str()).c_str(), _tree);
+    _file->GetObject(("histos/nevents" + _cycle.str()).c_str(), _nevents);
+    bool _matching = _tree && _nevents &&
+                     _tree->GetEntries() == mTreeEntries &&
+                     (long long)_nevents->GetEntries() == mProcessed;
+    // the histograms are booked again and take the checkpointed contents
+    delete _nevents;
+    if (!_matching) {
+        std::cout << mLegend << _outputFileName << " does not match " << mFileName << ", starting from the beginning" << std::endl;
+        _file->Close();
+        delete _file;
+        return 0;
+    }
+    
+    // drop the cycles after the checkpoint, the tree continues from its entries
+    keepCycle(_file, mCycle);
+    return _file;
+}
+
+bool LjmetCheckpoint::Write(TFile & file, long long entry, long long processed, long long treeEntries,
+                            std::vector<size_t> const & cutFlow, std::map<std::string, std::vector<double> > const & calcState)
+{
+    // a new cycle, the checkpointed one stays until the sidecar is replaced
+    file.Write();
+    file.Flush();
+    TKey * _treeKey = file.GetKey(mTreeName.c_str());
+    if (!_treeKey) {
+        std::cout << mLegend << "no tree " << mTreeName << " in the output, no checkpoint" << std::endl;
+        return false;
+    }
+    short _cycle = _treeKey->GetCycle();
+    
+    // replace the sidecar atomically, a job killed here keeps the previous checkpoint
+    std::ostringstream _tmpStream;
+    _tmpStream << mFileName << ".tmp" << getpid();
+    std::string _tmpName = _tmpStream.str();
+    std::ofstream _file(_tmpName.c_str());
+    _file << std::setprecision(17)
+          << "inputs " << mInputHash << "\n"
+          << "entry " << entry << "\n"
+          << "processed " << processed << "\n"
+          << "treeEntries " << treeEntries << "\n"
+          << "cycle " << _cycle << "\n"
+          << "cutflow " << cutFlow.size();
+    for (size_t i = 0; i < cutFlow.size(); ++i) _file << " " << cutFlow[i];
+    _file << "\n"
+          << "calculators " << calcState.size() << "\n";
+    for (std::map<std::string, std::vector<double> >::const_iterator iCalc = calcState.begin(); iCalc != calcState.end(); ++iCalc) {
+        _file << iCalc->first << " " << iCalc->second.size();
+        for (size_t i = 0; i < iCalc->second.size(); ++i) _file << " " << iCalc->second[i];
+        _file << "\n";
+    }
+    _file.close();
+    if (!_file || std::rename(_tmpName.c_str(), mFileName.c_str()) != 0) {
+        std::cout << mLegend << "could not write " << mFileName << std::endl;
+        std::remove(_tmpName.c_str());
+        return false;
+    }
+    mEntry = entry;
+    mProcessed = processed;
+    mTreeEntries = treeEntries;
+    mCycle = _cycle;
+    mvCutFlow = cutFlow;
+    mCalcState = calcState;
+    
+    // the new cycle now holds everything the previous one had
+    keepCycle(&file, _cycle);
+    return true;
+}
+
+void LjmetCheckpoint::Clear(TFile & file)
+{
+    std::remove(mFileName.c_str());
+    keepCycle(&file, 0);
+}
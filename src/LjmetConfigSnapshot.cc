@@ -0,0 +1,303 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+#include "FWCore/ParameterSet/interface/Entry.h"
+#include "LJMet/Com/interface/LjmetConfigSnapshot.h"
+
+namespace {
+    // snapshot layout: header, string config, parameter set
+    //   parameter set  u32 n, n x (string name, string encoded entry),
+    //                  u32 n, n x (string name, u8 tracked, parameter set),
+    //                  u32 n, n x (string name, u8 tracked, u32 m, m x parameter set)
+    //   string         u32 length, chars
+    const char snapshotMagic[8] = { 'L','J','M','C','F','G','S','N' };
+    const unsigned int snapshotVersion = 1;
+    const std::string legend = "[LjmetConfigSnapshot]: ";
+
+    struct SnapshotHeader {
+        char magic[8];
+        unsigned int version;
+        unsigned int reserved;
+        unsigned long long size;
+        /// of everything after the header
+        unsigned long long checksum;
+    };
+
+    // FNV-1a
+    unsigned long long checksum(const char * data, size_t n) {
+        unsigned long long _hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < n; ++i) {
+            _hash ^= (unsigned char)data[i];
+            _hash *= 1099511628211ULL;
+        }
+        return _hash;
+    }
+
+    template <class T> void put(std::string & out, T const & value) {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+    void putString(std::string & out, std::string const & value) {
+        put(out, (unsigned int)value.size());
+        out.append(value);
+    }
+
+    /// Bounds-checked reads from the snapshot
+    struct Cursor {
+        Cursor(const char * begin, const char * end): p(begin), end(end), ok(true) { }
+        template <class T> T get() {
+            T _value = T();
+            if (ok && (size_t)(end - p) >= sizeof(T)) {
+                std::memcpy(&_value, p, sizeof(T));
+                p += sizeof(T);
+            }
+            else ok = false;
+            return _value;
+        }
+        std::string getString() {
+            unsigned int _n = get<unsigned int>();
+            if (!ok || (size_t)(end - p) < _n) {
+                ok = false;
+                return "";
+            }
+            p += _n;
+            return std::string(p - _n, _n);
+        }
+        const char * p;
+        const char * end;
+        bool ok;
+    };
+
+    void putPSet(std::string & out, edm::ParameterSet const & pset) {
+        put(out, (unsigned int)pset.tbl().size());
+        for (edm::ParameterSet::table::const_iterator it = pset.tbl().begin(); it != pset.tbl().end(); ++it) {
+            std::string _rep;
+            it->second.toString(_rep);
+            putString(out, it->first);
+            putString(out, _rep);
+        }
+        put(out, (unsigned int)pset.psetTable().size());
+        for (edm::ParameterSet::psettable::const_iterator it = pset.psetTable().begin(); it != pset.psetTable().end(); ++it) {
+            putString(out, it->first);
+            put(out, (unsigned char)it->second.isTracked());
+            putPSet(out, it->second.pset());
+        }
+        put(out, (unsigned int)pset.vpsetTable().size());
+        for (edm::ParameterSet::vpsettable::const_iterator it = pset.vpsetTable().begin(); it != pset.vpsetTable().end(); ++it) {
+            std::vector<edm::ParameterSet> const & _vpset = it->second.vpset();
+            putString(out, it->first);
+            put(out, (unsigned char)it->second.isTracked());
+            put(out, (unsigned int)_vpset.size());
+            for (unsigned int i = 0; i < _vpset.size(); ++i) putPSet(out, _vpset[i]);
+        }
+    }
+
+    void getPSet(Cursor & cursor, edm::ParameterSet & pset) {
+        unsigned int _n = cursor.get<unsigned int>();
+        for (unsigned int i = 0; cursor.ok && i < _n; ++i) {
+            std::string _name = cursor.getString();
+            std::string _rep = cursor.getString();
+            if (cursor.ok) pset.insert(true, _name, edm::Entry(_name, _rep));
+        }
+        _n = cursor.get<unsigned int>();
+        for (unsigned int i = 0; cursor.ok && i < _n; ++i) {
+            std::string _name = cursor.getString();
+            bool _tracked = cursor.get<unsigned char>();
+            edm::ParameterSet _pset;
+            getPSet(cursor, _pset);
+            if (_tracked) pset.addParameter<edm::ParameterSet>(_name, _pset);
+            else pset.addUntrackedParameter<edm::ParameterSet>(_name, _pset);
+        }
+        _n = cursor.get<unsigned int>();
+        for (unsigned int i = 0; cursor.ok && i < _n; ++i) {
+            std::string _name = cursor.getString();
+            bool _tracked = cursor.get<unsigned char>();
+            std::vector<edm::ParameterSet> _vpset(cursor.get<unsigned int>());
+            for (unsigned int k = 0; cursor.ok && k < _vpset.size(); ++k) getPSet(cursor, _vpset[k]);
+            if (_tracked) pset.addParameter<std::vector<edm::ParameterSet> >(_name, _vpset);
+            else pset.addUntrackedParameter<std::vector<edm::ParameterSet> >(_name, _vpset);
+        }
+    }
+
+    std::string trim(std::string const & s) {
+        size_t _begin = s.find_first_not_of(" \t\r");
+        if (_begin == std::string::npos) return "";
+        return s.substr(_begin, s.find_last_not_of(" \t\r") + 1 - _begin);
+    }
+
+    std::string unquote(std::string const & s) {
+        if (s.size() >= 2 && (s[0] == '\'' || s[0] == '"') && s[s.size()-1] == s[0]) return s.substr(1, s.size() - 2);
+        return s;
+    }
+
+    void badOverride(std::string const & fileName, int line, std::string const & what) {
+        std::cout << legend << fileName << ":" << line << ": " << what << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+
+    /// One value of type T, false if the text is not one
+    template <class T> bool parse(std::string const & text, T & value) {
+        std::istringstream _in(text);
+        return (_in >> value) && _in.eof();
+    }
+    template <> bool parse(std::string const & text, std::string & value) {
+        value = text;
+        return true;
+    }
+    template <> bool parse(std::string const & text, bool & value) {
+        if (text == "true" || text == "True" || text == "1") value = true;
+        else if (text == "false" || text == "False" || text == "0") value = false;
+        else return false;
+        return true;
+    }
+
+    template <class T> void setValue(edm::ParameterSet & pset, std::string const & name, bool tracked, std::string const & text,
+                                     std::string const & fileName, int line) {
+        T _value;
+        if (!parse(unquote(text), _value)) badOverride(fileName, line, "cannot read '" + text + "' as the type of " + name);
+        if (tracked) pset.addParameter<T>(name, _value);
+        else pset.addUntrackedParameter<T>(name, _value);
+    }
+
+    template <class T> void setVector(edm::ParameterSet & pset, std::string const & name, bool tracked, std::string const & text,
+                                      std::string const & fileName, int line) {
+        std::string _text = text;
+        for (unsigned int i = 0; i < _text.size(); ++i) if (_text[i] == ',') _text[i] = ' ';
+        std::istringstream _in(_text);
+        std::vector<T> _values;
+        std::string _token;
+        while (_in >> _token) {
+            T _value;
+            if (!parse(unquote(_token), _value)) badOverride(fileName, line, "cannot read '" + _token + "' as the type of " + name);
+            _values.push_back(_value);
+        }
+        if (tracked) pset.addParameter<std::vector<T> >(name, _values);
+        else pset.addUntrackedParameter<std::vector<T> >(name, _values);
+    }
+}
+
+bool LjmetConfigSnapshot::Write(edm::ParameterSet const & pset, std::string const & config, std::string const & fileName)
+{
+    std::string _data;
+    putString(_data, config);
+    putPSet(_data, pset);
+
+    SnapshotHeader _header;
+    std::memset(&_header, 0, sizeof(_header));
+    std::memcpy(_header.magic, snapshotMagic, sizeof(snapshotMagic));
+    _header.version = snapshotVersion;
+    _header.size = _data.size();
+    _header.checksum = checksum(_data.data(), _data.size());
+
+    // write to a temporary file first, so jobs never read a partial snapshot
+    std::ostringstream _tmpStream;
+    _tmpStream << fileName << ".tmp" << getpid();
+    std::string _tmpName = _tmpStream.str();
+    std::ofstream _file(_tmpName.c_str(), std::ios::binary);
+    _file.write(reinterpret_cast<const char *>(&_header), sizeof(_header));
+    _file.write(_data.data(), _data.size());
+    _file.close();
+    if (!_file || std::rename(_tmpName.c_str(), fileName.c_str()) != 0) {
+        std::cout << legend << "could not write " << fileName << std::endl;
+        std::remove(_tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool LjmetConfigSnapshot::IsSnapshot(std::string const & fileName)
+{
+    std::ifstream _file(fileName.c_str(), std::ios::binary);
+    char _magic[sizeof(snapshotMagic)];
+    return _file.read(_magic, sizeof(_magic)) && std::memcmp(_magic, snapshotMagic, sizeof(snapshotMagic)) == 0;
+}
+
+std::shared_ptr<edm::ParameterSet> LjmetConfigSnapshot::Read(std::string const & fileName)
+{
+    std::ifstream _file(fileName.c_str(), std::ios::binary);
+    SnapshotHeader _header;
+    if (!_file.read(reinterpret_cast<char *>(&_header), sizeof(_header))
+        || std::memcmp(_header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0) {
+        std::cout << legend << fileName << " is not a configuration snapshot, exiting" << std::endl;
+        std::exit(-1);
+    }
+    if (_header.version != snapshotVersion) {
+        std::cout << legend << fileName << " has version " << _header.version << ", expected " << snapshotVersion
+                  << ", recompile it with ljmet-config-compile, exiting" << std::endl;
+        std::exit(-1);
+    }
+    std::string _data(_header.size, '\0');
+    if (!_file.read(&_data[0], _data.size()) || checksum(_data.data(), _data.size()) != _header.checksum) {
+        std::cout << legend << fileName << " is truncated or corrupt, exiting" << std::endl;
+        std::exit(-1);
+    }
+
+    Cursor _cursor(_data.data(), _data.data() + _data.size());
+    std::string _config = _cursor.getString();
+    std::shared_ptr<edm::ParameterSet> _pset(new edm::ParameterSet());
+    getPSet(_cursor, *_pset);
+    if (!_cursor.ok || _cursor.p != _cursor.end) {
+        std::cout << legend << fileName << " is corrupt, exiting" << std::endl;
+        std::exit(-1);
+    }
+    std::cout << legend << "configuration " << _config << " from the snapshot " << fileName << std::endl;
+    return _pset;
+}
+
+void LjmetConfigSnapshot::Override(edm::ParameterSet & pset, std::string const & fileName)
+{
+    std::ifstream _file(fileName.c_str());
+    if (!_file) {
+        std::cout << legend << "cannot read the overrides " << fileName << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+
+    std::string _line;
+    for (int _lineNumber = 1; std::getline(_file, _line); ++_lineNumber) {
+        _line = trim(_line);
+        if (_line.empty() || _line[0] == '#') continue;
+
+        size_t _equal = _line.find('=');
+        std::string _key = trim(_line.substr(0, _equal));
+        size_t _dot = _key.find('.');
+        if (_equal == std::string::npos || _dot == std::string::npos) badOverride(fileName, _lineNumber, "expected pset.parameter = value");
+        std::string _psetName = _key.substr(0, _dot);
+        std::string _name = _key.substr(_dot + 1);
+        std::string _value = trim(_line.substr(_equal + 1));
+
+        edm::ParameterSet::psettable::const_iterator _psetEntry = pset.psetTable().find(_psetName);
+        if (_psetEntry == pset.psetTable().end()) badOverride(fileName, _lineNumber, "no parameter set " + _psetName);
+        bool const _psetTracked = _psetEntry->second.isTracked();
+        edm::ParameterSet _sub = _psetEntry->second.pset();
+
+        edm::ParameterSet::table::const_iterator _entry = _sub.tbl().find(_name);
+        if (_entry == _sub.tbl().end()) badOverride(fileName, _lineNumber, "no parameter " + _key);
+        bool const _tracked = _entry->second.isTracked();
+
+        switch (_entry->second.typeCode()) {
+            case 'S': setValue<std::string>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 's': setVector<std::string>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'I': setValue<int>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'i': setVector<int>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'U': setValue<unsigned int>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'u': setVector<unsigned int>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'L': setValue<long long>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'l': setVector<long long>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'X': setValue<unsigned long long>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'x': setVector<unsigned long long>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'D': setValue<double>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'd': setVector<double>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            case 'B': setValue<bool>(_sub, _name, _tracked, _value, fileName, _lineNumber); break;
+            default: badOverride(fileName, _lineNumber, "cannot override " + _key + ", its type is not a number, bool or string");
+        }
+
+        if (_psetTracked) pset.addParameter<edm::ParameterSet>(_psetName, _sub);
+        else pset.addUntrackedParameter<edm::ParameterSet>(_psetName, _sub);
+        std::cout << legend << _key << " = " << _value << std::endl;
+    }
+}
@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "DataFormats/Math/interface/deltaR.h"
+#include "FWCore/Common/interface/TriggerNames.h"
+#include "LJMet/Com/interface/LjmetCutFlowSelector.h"
+
+void LjmetCutFlowSelector::Summary::clear()
+{
+    passTrigElMC = false;
+    passTrigMuMC = false;
+    passTrigElData = false;
+    passTrigMuData = false;
+    nTightMuons = 0;
+    nLooseMuons = 0;
+    nTightElectrons = 0;
+    nLooseElectrons = 0;
+    nTaus = 0;
+    nJets = 0;
+    nBtagJets = 0;
+    leadingJetPt = 0.0;
+    hasMet = false;
+    met = 0.0;
+}
+
+LjmetCutFlowSelector::LjmetCutFlowSelector():
+mFirstEntry(true),
+mSelectMuons(false),
+mSelectElectrons(false),
+mSelectTaus(false),
+mJetsFirst(false),
+mCleanJets(false),
+mKeepAllJets(false),
+mCorrectIdJets(false),
+mKeepLooseLeptons(true),
+mKeepNonTightElectrons(false),
+mCorrectMet(false),
+mType1CorrMet(false),
+mTightMuonId(-1),
+mLooseMuonId(-1),
+mTightElectronId(-1),
+mLooseElectronId(-1)
+{
+}
+
+void LjmetCutFlowSelector::BeginJob(std::map<std::string, edm::ParameterSet const > par)
+{
+    BaseEventSelector::BeginJob(par);
+
+    std::string _key = "pfJetIDSelector";
+    if ( par.find(_key)!=par.end() ){
+        jetSel_ = boost::shared_ptr<PFJetIDSelectionFunctor>( new PFJetIDSelectionFunctor(par[_key]) );
+        std::cout << mLegend << "jet ID selector configured!" << std::endl;
+    }
+    else {
+        std::cout << mLegend << "jet ID selector not configured, exiting" << std::endl;
+        std::exit(-1);
+    }
+
+    _key = "pvSelector";
+    if ( par.find(_key)!=par.end() ){
+        pvSel_ = boost::shared_ptr<PVSelector>( new PVSelector(par[_key]) );
+        std::cout << mLegend << "pv selector configured!" << std::endl;
+    }
+    else {
+        std::cout << mLegend << "PV selector not configured, exiting" << std::endl;
+        std::exit(-1);
+    }
+    mJetBits = jetSel_->getBitTemplate();
+
+    push_back("No selection");
+    set("No selection");
+
+    Configure(par);
+
+    push_back("All cuts");          // sanity check
+    set("All cuts", true);
+
+    mNoSelection = GetCutIndex("No selection");
+    mAllCuts = GetCutIndex("All cuts");
+    for (unsigned int i = 0; i < mvCuts.size(); ++i) mvCuts[i].index = GetCutIndex(mvCuts[i].name);
+
+    std::cout << mLegend << "initializing " << mSelection << " selection, " << mvCuts.size() << " cuts" << std::endl;
+    mFirstEntry = true;
+}
+
+void LjmetCutFlowSelector::AddCut(std::string const & name, CutTest const & test, int flags, bool active)
+{
+    push_back(name);
+    Cut _cut;
+    _cut.name = name;
+    _cut.test = test;
+    _cut.flags = flags;
+    _cut.active = active;
+    mvCuts.push_back(_cut);
+}
+
+bool LjmetCutFlowSelector::operator()(edm::EventBase const & event, pat::strbitset & ret)
+{
+    mSummary.clear();
+    mvSelPVs.clear();
+    bool _objects = false;
+    bool _passed = true;
+
+    passCut(ret, mNoSelection);
+
+    for (unsigned int i = 0; i < mvCuts.size(); ++i) {
+        Cut const & _cut = mvCuts[i];
+        if (!_cut.active) continue;
+
+        // objects are selected once, for the first cut that needs them
+        if ((_cut.flags & cutObjects) && !_objects) {
+            selectObjects(event);
+            _objects = true;
+        }
+        if ((_cut.flags & cutIfConsidered) && !considerCut(_cut.index)) continue;
+
+        if (ignoreCut(_cut.index) || _cut.test(event, _cut.index)) passCut(ret, _cut.index);
+        else if (!(_cut.flags & cutNoBreak)) {
+            _passed = false;
+            break;
+        }
+    }
+
+    // the calculators need the objects of a selected event
+    if (_passed) {
+        if (!_objects) selectObjects(event);
+        passCut(ret, mAllCuts);
+    }
+
+    mFirstEntry = false;
+    return (bool)ret;
+}
+
+void LjmetCutFlowSelector::selectObjects(edm::EventBase const & event)
+{
+    mvSelMuons.clear();
+    mvLooseMuons.clear();
+    mvSelElectrons.clear();
+    mvLooseElectrons.clear();
+
+    if (mJetsFirst) selectJets(event);
+    if (mSelectMuons) selectMuons(event);
+    if (mSelectElectrons) selectElectrons(event);
+    if (mSelectTaus) selectTaus(event);
+    if (!mJetsFirst) selectJets(event);
+    selectMet(event);
+
+    if (mbPar["debug"]) std::cout << mLegend << mSummary.nTightMuons << " muons, " << mSummary.nTightElectrons << " electrons, "
+                                  << mSummary.nJets << " jets, " << mSummary.nBtagJets << " b jets" << std::endl;
+}
+
+void LjmetCutFlowSelector::selectMuons(edm::EventBase const & event)
+{
+    event.getByLabel( mtPar["muon_collection"], mhMuons );
+    if (mTightMuonId >= 0 || mLooseMuonId >= 0) mLeptonId.EvaluateMuons(*mhMuons, mvSelPVs.empty() ? 0 : mvSelPVs[0].get());
+    for (unsigned int i = 0; i < mhMuons->size(); ++i) {
+        pat::Muon const & _muon = mhMuons->at(i);
+        if (mTightMuonId >= 0 ? mLeptonId.PassMuon(mTightMuonId, i) : isTightMuon(_muon, event)) {
+            ++mSummary.nTightMuons;
+            mvSelMuons.push_back( edm::Ptr<pat::Muon>( mhMuons, i) );
+        }
+        else if (mLooseMuonId >= 0 ? mLeptonId.PassMuon(mLooseMuonId, i) : isLooseMuon(_muon, event)) {
+            ++mSummary.nLooseMuons;
+            if (mKeepLooseLeptons) mvLooseMuons.push_back( edm::Ptr<pat::Muon>( mhMuons, i) );
+        }
+    }
+}
+
+void LjmetCutFlowSelector::selectElectrons(edm::EventBase const & event)
+{
+    event.getByLabel( mtPar["electron_collection"], mhElectrons );
+    if (mTightElectronId >= 0 || mLooseElectronId >= 0) mLeptonId.EvaluateElectrons(*mhElectrons, event);
+    for (unsigned int i = 0; i < mhElectrons->size(); ++i) {
+        pat::Electron const & _electron = mhElectrons->at(i);
+        if (mTightElectronId >= 0 ? mLeptonId.PassElectron(mTightElectronId, i) : isTightElectron(_electron, event)) {
+            ++mSummary.nTightElectrons;
+            if (!mKeepNonTightElectrons) mvSelElectrons.push_back( edm::Ptr<pat::Electron>( mhElectrons, i) );
+            continue;
+        }
+        if (mKeepNonTightElectrons) mvSelElectrons.push_back( edm::Ptr<pat::Electron>( mhElectrons, i) );
+        if (mLooseElectronId >= 0 ? mLeptonId.PassElectron(mLooseElectronId, i) : isLooseElectron(_electron, event)) {
+            ++mSummary.nLooseElectrons;
+            if (mKeepLooseLeptons) mvLooseElectrons.push_back( edm::Ptr<pat::Electron>( mhElectrons, i) );
+        }
+    }
+}
+
+void LjmetCutFlowSelector::selectTaus(edm::EventBase const & event)
+{
+    event.getByLabel( mtPar["tau_collection"], mhTaus );
+    for (std::vector<pat::Tau>::const_iterator _itau = mhTaus->begin(); _itau != mhTaus->end(); ++_itau) {
+        if (isTau(*_itau)) ++mSummary.nTaus;
+    }
+}
+
+void LjmetCutFlowSelector::selectJets(edm::EventBase const & event)
+{
+    event.getByLabel( mtPar["jet_collection"], mhJets );
+
+    mvSelJets.clear();
+    mvAllJets.clear();
+    mvCorrJetsWithBTags.clear();
+    mvSelBtagJets.clear();
+
+    for (unsigned int i = 0; i < mhJets->size(); ++i) {
+        pat::Jet const & _jet = mhJets->at(i);
+        edm::Ptr<pat::Jet> const _ptr(mhJets, i);
+
+        mJetBits.set(false);
+        bool const _passId = (*jetSel_)(_jet, mJetBits);
+        if (!_passId && mCorrectIdJets) {
+            if (mKeepAllJets) mvAllJets.push_back(_ptr);
+            continue;
+        }
+
+        TLorentzVector _jetP4;
+        bool _cleaned = false;
+        if (mCleanJets) {
+            // the electron wins if both overlap
+            if (!mvSelMuons.empty()) _cleaned = cleanJet(_jet, *mvSelMuons[0], mvSelMuons[0]->originalObjectRef(), event, _jetP4) || _cleaned;
+            if (!mvSelElectrons.empty()) _cleaned = cleanJet(_jet, *mvSelElectrons[0], mvSelElectrons[0]->originalObjectRef(), event, _jetP4) || _cleaned;
+        }
+        if (!_cleaned) _jetP4 = correctJet(_jet, event);
+        bool const _isTagged = isJetTagged(_jet, event);
+
+        bool const _pass = _passId && _jetP4.Pt() > mdPar["jet_minpt"] && std::fabs(_jetP4.Eta()) < mdPar["jet_maxeta"];
+
+        if (_pass) {
+            ++mSummary.nJets;
+            mvSelJets.push_back(_ptr);
+            mvCorrJetsWithBTags.push_back(std::make_pair(_jetP4, _isTagged));
+            if (_jetP4.Pt() > mSummary.leadingJetPt) mSummary.leadingJetPt = _jetP4.Pt();
+            if (_isTagged) {
+                ++mSummary.nBtagJets;
+                mvSelBtagJets.push_back(_ptr);
+            }
+        }
+
+        // needed for MET corrections with JER/JES uncertainty
+        if (_passId || mKeepAllJets) mvAllJets.push_back(_ptr);
+    }
+}
+
+bool LjmetCutFlowSelector::cleanJet(pat::Jet const & jet, reco::Candidate const & lepton, reco::CandidatePtr const & leptonSource, edm::EventBase const & event, TLorentzVector & jetP4)
+{
+    if ( reco::deltaR(lepton.p4(), jet.p4()) >= 0.4 ) return false;
+
+    if (mbPar["debug"]) {
+        std::cout << "Jet overlaps with the lepton... Cleaning jet..." << std::endl;
+        std::cout << "Lepton : pT = " << lepton.pt() << " eta = " << lepton.eta() << " phi = " << lepton.phi() << std::endl;
+        std::cout << "      Raw Jet : pT = " << jet.pt() << " eta = " << jet.eta() << " phi = " << jet.phi() << std::endl;
+    }
+
+    std::vector<reco::CandidatePtr> const & _constituents = jet.daughterPtrVector();
+    for (unsigned int i = 0; i < _constituents.size(); ++i) {
+        if ( _constituents[i].key() != leptonSource.key() ) continue;
+        pat::Jet _cleanJet = jet;
+        _cleanJet.setP4( jet.p4() - lepton.p4() );
+        jetP4 = correctJet(_cleanJet, event);
+        if (mbPar["debug"]) std::cout << "Corrected Jet : pT = " << jetP4.Pt() << " eta = " << jetP4.Eta() << " phi = " << jetP4.Phi() << std::endl;
+        return true;
+    }
+    return false;
+}
+
+void LjmetCutFlowSelector::selectMet(edm::EventBase const & event)
+{
+    event.getByLabel( mtPar["met_collection"], mhMet );
+    mpMet = edm::Ptr<pat::MET>( mhMet, 0);
+
+    if (mType1CorrMet) {
+        event.getByLabel( mtPar["type1corrmet_collection"], mhType1CorrMet );
+        mpType1CorrMet = edm::Ptr<reco::PFMET>( mhType1CorrMet, 0);
+    }
+
+    mSummary.hasMet = mpMet.isNonnull() && mpMet.isAvailable();
+    if (!mSummary.hasMet) return;
+    if (mCorrectMet) {
+        correctedMET_p4 = correctMet(*mpMet, event);
+        mSummary.met = correctedMET_p4.Pt();
+    }
+    else mSummary.met = mpMet->et();
+}
+
+bool LjmetCutFlowSelector::passTrigger(edm::EventBase const & event)
+{
+    if (mbPar["debug"]) std::cout<<"trigger cuts..."<<std::endl;
+
+    event.getByLabel( mtPar["trigger_collection"], mhEdmTriggerResults );
+    edm::TriggerNames const & trigNames = event.triggerNames(*mhEdmTriggerResults);
+    unsigned int const _tSize = mhEdmTriggerResults->size();
+
+    // dump trigger names
+    if (mFirstEntry && mbPar["dump_trigger"]){
+        for (unsigned int i=0; i<_tSize; i++){
+            std::string trigName = trigNames.triggerName(i);
+            std::cout << i << "   " << trigName;
+            bool fired = mhEdmTriggerResults->accept(trigNames.triggerIndex(trigName));
+            std::cout <<", FIRED = "<<fired<<std::endl;
+        }
+    }
+
+    unsigned int _tElMCIndex = trigNames.triggerIndex(msPar["mctrigger_path_el"]);
+    if ( _tElMCIndex<_tSize) mSummary.passTrigElMC = mhEdmTriggerResults->accept(_tElMCIndex);
+
+    unsigned int _tMuMCIndex = trigNames.triggerIndex(msPar["mctrigger_path_mu"]);
+    if ( _tMuMCIndex<_tSize) mSummary.passTrigMuMC = mhEdmTriggerResults->accept(_tMuMCIndex);
+
+    // first fired path of each data channel
+    int passTrigEl = 0;
+    std::vector<std::string> const & _elPaths = mvsPar["trigger_path_el"];
+    for (unsigned int ipath = 0; ipath < _elPaths.size() && passTrigEl == 0; ipath++){
+        unsigned int _tIndex = trigNames.triggerIndex(_elPaths[ipath]);
+        if ( _tIndex<_tSize && mhEdmTriggerResults->accept(_tIndex) ) passTrigEl++;
+    }
+    mSummary.passTrigElData = passTrigEl > 0;
+
+    int passTrigMu = 0;
+    std::vector<std::string> const & _muPaths = mvsPar["trigger_path_mu"];
+    for (unsigned int ipath = 0; ipath < _muPaths.size() && passTrigMu == 0; ipath++){
+        unsigned int _tIndex = trigNames.triggerIndex(_muPaths[ipath]);
+        if ( _tIndex<_tSize && mhEdmTriggerResults->accept(_tIndex) ) passTrigMu++;
+    }
+    mSummary.passTrigMuData = passTrigMu > 0;
+
+    mvSelTriggers.clear();
+    mvSelTriggers.push_back(passTrigEl);
+    mvSelTriggers.push_back(passTrigMu);
+
+    if (mbPar["isMc"]) return mSummary.passTrigMuMC || mSummary.passTrigElMC;
+    return mSummary.passTrigMuData || mSummary.passTrigElData;
+}
+
+bool LjmetCutFlowSelector::passPv(edm::EventBase const & event)
+{
+    if (mbPar["debug"]) std::cout<<"pv cuts..."<<std::endl;
+
+    bool const _pass = (*pvSel_)(event);
+
+    event.getByLabel( mtPar["pv_collection"], h_primVtx );
+    for (unsigned int i = 0; i < h_primVtx->size(); ++i) mvSelPVs.push_back(edm::Ptr<reco::Vertex>(h_primVtx, i));
+
+    return _pass;
+}
+
+void LjmetCutFlowSelector::loadLaserCalEvents(std::string const & fileName)
+{
+    // run:lumi:event per line
+    std::ifstream inFile(fileName.c_str());
+    std::string line,subString;
+    int begin,end;
+    int _events = 0;
+    while(inFile.good()){
+        getline(inFile,line);
+        begin=0;
+        end=line.find(":");
+        subString=line.substr(begin,end-begin);
+        int run=atoi(subString.c_str());
+        begin=end+1;
+        end=line.find(":",begin+1);
+        subString=line.substr(begin,end-begin);
+        int lumi=atoi(subString.c_str());
+        begin=end+1;
+        end=line.length();
+        subString=line.substr(begin,end-begin);
+        int event=atoi(subString.c_str());
+
+        mmvBadLaserCalEvents[run][lumi].push_back(event);
+        ++_events;
+    }
+
+    std::cout << mLegend << "Loaded " << _events << " laser events" << std::endl;
+}
+
+bool LjmetCutFlowSelector::passLaserCal(edm::EventBase const & event) const
+{
+    std::map<int, std::map<int, std::vector<int> > >::const_iterator _run = mmvBadLaserCalEvents.find(event.id().run());
+    if (_run == mmvBadLaserCalEvents.end()) return true;
+    std::map<int, std::vector<int> >::const_iterator _lumi = _run->second.find(event.id().luminosityBlock());
+    if (_lumi == _run->second.end()) return true;
+    int const _event = event.id().event();
+    return std::find(_lumi->second.begin(), _lumi->second.end(), _event) == _lumi->second.end();
+}
+
+double LjmetCutFlowSelector::pfRelIso(pat::Muon const & muon)
+{
+    double chIso = muon.userIsolation(pat::PfChargedHadronIso);
+    double nhIso = muon.userIsolation(pat::PfNeutralHadronIso);
+    double gIso  = muon.userIsolation(pat::PfGammaIso);
+    double puIso = muon.userIsolation(pat::PfPUChargedHadronIso);
+    return (chIso + std::max(0.,nhIso + gIso - 0.5*puIso))/muon.pt();
+}
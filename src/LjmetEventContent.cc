@@ -1,4 +1,6 @@
 #include "LJMet/Com/interface/LjmetEventContent.h"
+#include "TBranch.h"
+#include "TLeaf.h"
 
 LjmetEventContent::LjmetEventContent():
 mName("LjmetEventContent"),
@@ -78,21 +80,56 @@ void LjmetEventContent::SetValue(std::string key, double value)
     mDoubleBranch[key] = value;
 }
 
-void LjmetEventContent::SetValue(std::string key, std::vector<bool> value)
+void LjmetEventContent::SetValue(std::string key, std::vector<bool> const & value)
 {
     mVectorBoolBranch[key] = value;
 }
 
-void LjmetEventContent::SetValue(std::string key, std::vector<int> value)
+void LjmetEventContent::SetValue(std::string key, std::vector<int> const & value)
 {
     mVectorIntBranch[key] = value;
 }
 
-void LjmetEventContent::SetValue(std::string key, std::vector<double> value)
+void LjmetEventContent::SetValue(std::string key, std::vector<double> const & value)
 {
     mVectorDoubleBranch[key] = value;
 }
 
+void LjmetEventContent::SetValue(std::string key, std::vector<float> const & value)
+{
+    mVectorFloatBranch[key] = value;
+}
+
+void LjmetEventContent::SetValue(std::string key, std::vector<short> const & value)
+{
+    mVectorShortBranch[key] = value;
+}
+
+void LjmetEventContent::SetValue(std::string key, LjmetArenaVector<bool> const & value)
+{
+    mVectorBoolBranch[key].assign(value.begin(), value.end());
+}
+
+void LjmetEventContent::SetValue(std::string key, LjmetArenaVector<int> const & value)
+{
+    mVectorIntBranch[key].assign(value.begin(), value.end());
+}
+
+void LjmetEventContent::SetValue(std::string key, LjmetArenaVector<double> const & value)
+{
+    mVectorDoubleBranch[key].assign(value.begin(), value.end());
+}
+
+void LjmetEventContent::SetValue(std::string key, LjmetArenaVector<float> const & value)
+{
+    mVectorFloatBranch[key].assign(value.begin(), value.end());
+}
+
+void LjmetEventContent::SetValue(std::string key, LjmetArenaVector<short> const & value)
+{
+    mVectorShortBranch[key].assign(value.begin(), value.end());
+}
+
 void LjmetEventContent::SetHistValue(std::string modname, std::string histname, double value)
 {
     // Assign current hist value to hist metadata collection
@@ -212,5 +249,97 @@ int LjmetEventContent::createBranches()
     }
     std::cout << mLegend << "vector<double> branches created: " << mVectorDoubleBranch.size() << std::endl;
     
+    // Vector-of-float branches
+    for (std::map<std::string, std::vector<float>>::iterator br = mVectorFloatBranch.begin(); br != mVectorFloatBranch.end(); ++br) {
+        mpTree->Branch(br->first.c_str(), &(br->second));
+        
+        if (mVerbosity > 0) {
+            std::cout << mLegend << "Branch " << br->first << " std::vector<float> created" << std::endl;
+        }
+    }
+    std::cout << mLegend << "vector<float> branches created: " << mVectorFloatBranch.size() << std::endl;
+    
+    // Vector-of-short branches
+    for (std::map<std::string, std::vector<short>>::iterator br = mVectorShortBranch.begin(); br != mVectorShortBranch.end(); ++br) {
+        mpTree->Branch(br->first.c_str(), &(br->second));
+        
+        if (mVerbosity > 0) {
+            std::cout << mLegend << "Branch " << br->first << " std::vector<short> created" << std::endl;
+        }
+    }
+    std::cout << mLegend << "vector<short> branches created: " << mVectorShortBranch.size() << std::endl;
+    
     return 0;
 }
+
+bool LjmetEventContent::Resume(Long64_t nEntries)
+{
+    mLegend = "[" + mName + "]: " ;
+    
+    if (mpTree->GetEntries() != nEntries) {
+        std::cout << mLegend << "checkpointed tree has " << mpTree->GetEntries() << " of " << nEntries << " entries" << std::endl;
+        return false;
+    }
+    
+    // branch maps from the checkpointed tree, same types as createBranches makes them
+    TObjArray * _branches = mpTree->GetListOfBranches();
+    if (_branches->GetEntriesFast() == 0) {
+        // no event was filled before the checkpoint, branches are made by the first one as usual
+        return nEntries == 0;
+    }
+    for (int i = 0; i < _branches->GetEntriesFast(); ++i) {
+        TBranch * _br = (TBranch *)_branches->At(i);
+        std::string _name = _br->GetName();
+        std::string _class = _br->GetClassName();
+        std::string _type = _class.empty() ? ((TLeaf *)_br->GetListOfLeaves()->At(0))->GetTypeName() : _class;
+        
+        if (_type == "Bool_t") mBoolBranch[_name];
+        else if (_type == "Int_t") mIntBranch[_name];
+        else if (_type == "Double_t") mDoubleBranch[_name];
+        else if (_type == "vector<bool>") mVectorBoolBranch[_name];
+        else if (_type == "vector<int>") mVectorIntBranch[_name];
+        else if (_type == "vector<double>") mVectorDoubleBranch[_name];
+        else if (_type == "vector<float>") mVectorFloatBranch[_name];
+        else if (_type == "vector<short>") mVectorShortBranch[_name];
+        else {
+            std::cout << mLegend << "cannot resume branch " << _name << " of type " << _type << std::endl;
+            return false;
+        }
+    }
+    
+    // the existing branches are filled from the maps, as if createBranches had made them
+    resumeScalar(mBoolBranch);
+    resumeScalar(mIntBranch);
+    resumeScalar(mDoubleBranch);
+    resumeVector(mVectorBoolBranch, mlResumedVectorBool);
+    resumeVector(mVectorIntBranch, mlResumedVectorInt);
+    resumeVector(mVectorDoubleBranch, mlResumedVectorDouble);
+    resumeVector(mVectorFloatBranch, mlResumedVectorFloat);
+    resumeVector(mVectorShortBranch, mlResumedVectorShort);
+    mFirstEntry = false;
+    
+    // the buffers keep the values of the last entry, as after filling it
+    if (mpTree->GetEntry(nEntries - 1) <= 0) {
+        std::cout << mLegend << "cannot read entry " << nEntries - 1 << " of the checkpointed tree" << std::endl;
+        return false;
+    }
+    
+    std::cout << mLegend << "resumed after " << nEntries << " entries" << std::endl;
+    return true;
+}
+
+template <class T> void LjmetEventContent::resumeScalar(std::map<std::string, T> & branches)
+{
+    for (typename std::map<std::string, T>::iterator br = branches.begin(); br != branches.end(); ++br) {
+        mpTree->SetBranchAddress(br->first.c_str(), &(br->second));
+    }
+}
+
+template <class T> void LjmetEventContent::resumeVector(std::map<std::string, std::vector<T> > & branches, std::list<std::vector<T> *> & pointers)
+{
+    // object branches take the address of a pointer to the object
+    for (typename std::map<std::string, std::vector<T> >::iterator br = branches.begin(); br != branches.end(); ++br) {
+        pointers.push_back(&(br->second));
+        mpTree->SetBranchAddress(br->first.c_str(), &pointers.back());
+    }
+}
@@ -0,0 +1,97 @@
+#include <cstdlib>
+
+#include "LJMet/Com/interface/BaseCalc.h"
+#include "LJMet/Com/interface/LjmetEventProducts.h"
+
+LjmetEventProducts * LjmetEventProducts::GetInstance()
+{
+    static LjmetEventProducts instance;
+    return &instance;
+}
+
+LjmetEventProducts::LjmetEventProducts():
+mLegend("[LjmetEventProducts]: "),
+mEvent(0),
+mpEvent(0),
+mpSelector(0)
+{
+}
+
+LjmetEventProducts::~LjmetEventProducts()
+{
+    for (std::map<std::string, Slot>::iterator it = mSlots.begin(); it != mSlots.end(); ++it) delete it->second.holder;
+}
+
+void LjmetEventProducts::Declare(std::string const & name, BaseCalc * producer)
+{
+    Slot & _slot = mSlots[name];
+    if (_slot.producer && _slot.producer != producer) {
+        std::cout << mLegend << name << " is produced by both " << _slot.producer->GetName()
+                  << " and " << producer->GetName() << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+    _slot.producer = producer;
+    mProducers[producer];
+}
+
+bool LjmetEventProducts::IsProducer(BaseCalc const * calc) const
+{
+    return mProducers.find(calc) != mProducers.end();
+}
+
+bool LjmetEventProducts::IsDeclared(std::string const & name) const
+{
+    std::map<std::string, Slot>::const_iterator it = mSlots.find(name);
+    return it != mSlots.end() && it->second.producer;
+}
+
+void LjmetEventProducts::BeginEvent(edm::EventBase const & event, BaseEventSelector * selector)
+{
+    // the products are kept, only marked as from an old event
+    ++mEvent;
+    mpEvent = &event;
+    mpSelector = selector;
+}
+
+LjmetEventProducts::Slot & LjmetEventProducts::produce(std::string const & name)
+{
+    std::map<std::string, Slot>::iterator it = mSlots.find(name);
+    if (it == mSlots.end() || (!it->second.producer && it->second.event != mEvent)) {
+        std::cout << mLegend << "no calculator produces " << name << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+
+    Slot & _slot = it->second;
+    if (_slot.event != mEvent) {
+        runProducer(_slot.producer, name);
+        if (_slot.event != mEvent) {
+            std::cout << mLegend << _slot.producer->GetName() << " did not produce " << name
+                      << " in this event, exiting" << std::endl;
+            std::exit(-1);
+        }
+    }
+    return _slot;
+}
+
+void LjmetEventProducts::runProducer(BaseCalc * producer, std::string const & name)
+{
+    ProducerState & _state = mProducers[producer];
+    if (_state.running) {
+        std::cout << mLegend << "cycle of producers, " << name << " is read while "
+                  << producer->GetName() << " runs, exiting" << std::endl;
+        std::exit(-1);
+    }
+    // ran already, and did not put the product
+    if (_state.event == mEvent) return;
+
+    _state.running = true;
+    producer->ProduceEvent(*mpEvent, mpSelector);
+    _state.running = false;
+    _state.event = mEvent;
+}
+
+void LjmetEventProducts::wrongType(std::string const & name) const
+{
+    std::cout << mLegend << name << " is read or put with another type than it was put with, exiting" << std::endl;
+    std::exit(-1);
+}
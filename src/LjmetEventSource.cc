@@ -0,0 +1,34 @@
+#include <iostream>
+
+#include "LJMet/Com/interface/LjmetEventSource.h"
+#include "LJMet/Com/interface/LjmetFilePrefetcher.h"
+#include "LJMet/Com/interface/LjmetSyntheticEvent.h"
+
+LjmetEventSource * LjmetEventSource::Create(edm::ParameterSet const & inputs)
+{
+    std::string const _source = inputs.exists("source") ? inputs.getUntrackedParameter<std::string>("source") : "chain";
+
+    if (_source == "chain") {
+        std::vector<std::string> const _fileNames = inputs.getParameter<std::vector<std::string> >("fileNames");
+        int const _prefetchFiles = inputs.exists("prefetchFiles") ? inputs.getUntrackedParameter<int>("prefetchFiles") : 0;
+        if (_prefetchFiles > 0) {
+            long long const _memory = inputs.exists("prefetchMemory") ? inputs.getUntrackedParameter<int>("prefetchMemory") : 512;
+            return new LjmetPrefetchEventSource(_fileNames, _prefetchFiles, _memory*1024*1024);
+        }
+        return new LjmetChainEventSource(_fileNames);
+    }
+    if (_source == "synthetic") {
+        edm::ParameterSet const _par = inputs.exists("synthetic") ? inputs.getUntrackedParameter<edm::ParameterSet>("synthetic") : edm::ParameterSet();
+        return new LjmetSyntheticEventSource(_par);
+    }
+
+    std::cout << "[LjmetEventSource]: unknown event source " << _source << ", use chain or synthetic" << std::endl;
+    return 0;
+}
+
+
+
+LjmetChainEventSource::LjmetChainEventSource(std::vector<std::string> const & fileNames):
+mEvent(fileNames)
+{
+}
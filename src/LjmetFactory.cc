@@ -1,11 +1,15 @@
+#include <algorithm>
+
 #include "LJMet/Com/interface/LjmetFactory.h"
 #include "LJMet/Com/interface/BaseCalc.h"
+#include "LJMet/Com/interface/LjmetArena.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
+#include "LJMet/Com/interface/LjmetEventProducts.h"
 
 // Ensure a single instance
 LjmetFactory * LjmetFactory::instance = 0;
 
-LjmetFactory::LjmetFactory(): theSelector(0)
+LjmetFactory::LjmetFactory(): theSelector(0), mCalcsBuilt(false)
 {
     mLegend = "[LjmetFactory]: ";
 }
@@ -14,20 +18,52 @@ LjmetFactory::~LjmetFactory()
 {
 }
 
-int LjmetFactory::Register(BaseCalc * calc, std::string name)
+std::string LjmetFactory::makeName(std::string const & name, std::string const & prefix, unsigned long number) const
 {
     std::string _name = name;
     if (_name == "") {
         // no name given - need to generate one
         char buf[256];
-        unsigned long _calc_number = mpCalculators.size()+1;
-        sprintf(buf, "calc%lu", _calc_number);
+        sprintf(buf, "%s%lu", prefix.c_str(), number);
         _name.append(buf);
     }
+    return _name;
+}
+
+int LjmetFactory::Register(CalcMaker maker, std::string name, bool onRequest)
+{
+    std::string _name = makeName(name, "calc", mCalcMakers.size() + mpCalculators.size() + 1);
+    
+    if (mCalcMakers.find(_name) != mCalcMakers.end() || mpCalculators.find(_name) != mpCalculators.end()) {
+        std::cout << mLegend << "calculator " << _name << " already registered, rename" << std::endl;
+    } else {
+        mCalcMakers[_name] = maker;
+        if (onRequest) mOnRequestCalcs.insert(_name);
+    }
+    
+    return 0;
+}
+
+int LjmetFactory::Register(SelectorMaker maker, std::string name)
+{
+    std::string _name = makeName(name, "selector", mSelectorMakers.size() + mpSelectors.size() + 1);
+    
+    if (mSelectorMakers.find(_name) != mSelectorMakers.end() || mpSelectors.find(_name) != mpSelectors.end()) {
+        std::cout << mLegend << "event selector " << _name << " already registered, rename" << std::endl;
+    } else {
+        mSelectorMakers[_name] = maker;
+    }
+    
+    return 0;
+}
+
+int LjmetFactory::Register(BaseCalc * calc, std::string name)
+{
+    std::string _name = makeName(name, "calc", mCalcMakers.size() + mpCalculators.size() + 1);
     
     calc->setName(_name);
     
-    if (mpCalculators.find(_name) != mpCalculators.end()) {
+    if (mCalcMakers.find(_name) != mCalcMakers.end() || mpCalculators.find(_name) != mpCalculators.end()) {
         std::cout << mLegend << "calculator " << _name << " already registered, rename" << std::endl;
     } else {
         calc->init();
@@ -39,18 +75,11 @@ int LjmetFactory::Register(BaseCalc * calc, std::string name)
 
 int LjmetFactory::Register(BaseEventSelector * object, std::string name)
 {
-    std::string _name = name;
-    if (_name == "") {
-        // no name given - need to generate one
-        char buf[256];
-        unsigned long _object_number = mpSelectors.size() + 1;
-        sprintf(buf, "selector%lu", _object_number);
-        _name.append(buf);
-    }
+    std::string _name = makeName(name, "selector", mSelectorMakers.size() + mpSelectors.size() + 1);
     
     object->setName(_name);
     
-    if (mpSelectors.find(_name) != mpSelectors.end()) {
+    if (mSelectorMakers.find(_name) != mSelectorMakers.end() || mpSelectors.find(_name) != mpSelectors.end()) {
         std::cout << mLegend << "event selector " << _name << " already registered, rename" << std::endl;
     } else {
         object->init();
@@ -62,11 +91,18 @@ int LjmetFactory::Register(BaseEventSelector * object, std::string name)
 
 BaseEventSelector * LjmetFactory::GetEventSelector(std::string name)
 {
-    // Return pointer to registered event selector
+    // Return pointer to registered event selector, built on first use
     // Exit if not found
     if (mpSelectors.find(name) == mpSelectors.end()) {
-        std::cout << mLegend << "event selector " << name << " not registered" << std::endl;
-        std::exit(-1);
+        std::map<std::string, SelectorMaker>::const_iterator _maker = mSelectorMakers.find(name);
+        if (_maker == mSelectorMakers.end()) {
+            std::cout << mLegend << "event selector " << name << " not registered" << std::endl;
+            std::exit(-1);
+        }
+        BaseEventSelector * _selector = _maker->second();
+        _selector->setName(name);
+        _selector->init();
+        mpSelectors[name] = _selector;
     }
     
     // cache the current event selector
@@ -88,8 +124,11 @@ void LjmetFactory::RunAllCalculators(edm::EventBase const & event, BaseEventSele
 void LjmetFactory::RunAllProducers(edm::EventBase const & event, BaseEventSelector * selector)
 {
     // Loop over all registered calculators and
-    // run all producer methods (comes before selection)
+    // run all producer methods (comes before selection);
+    // calculators with declared products run when these are read
+    LjmetEventProducts const * _products = LjmetEventProducts::GetInstance();
     for (std::map<std::string, BaseCalc * >::const_iterator iCalc = mpCalculators.begin(); iCalc != mpCalculators.end(); ++iCalc) {
+        if (_products->IsProducer(iCalc->second)) continue;
         iCalc->second->ProduceEvent(event, selector);
     }
 }
@@ -118,6 +157,51 @@ void LjmetFactory::SetExcludedCalcs( std::vector<std::string> vExcl )
     }
 }
 
+void LjmetFactory::SetRequestedCalcs( std::vector<std::string> vCalcs )
+{
+    mvRequestedCalcs = vCalcs;
+    std::vector<std::string>::const_iterator c;
+    for ( c = mvRequestedCalcs.begin(); c != mvRequestedCalcs.end(); ++c) {
+        if (mCalcMakers.find(*c) == mCalcMakers.end() && mpCalculators.find(*c) == mpCalculators.end()) {
+            std::cout << mLegend << "requested calculator " << *c << " not registered" << std::endl;
+            std::exit(-1);
+        }
+    }
+}
+
+bool LjmetFactory::isCalcWanted(std::string const & name) const
+{
+    if (std::find(mvExcludedCalcs.begin(), mvExcludedCalcs.end(), name) != mvExcludedCalcs.end()) return false;
+    if (mvRequestedCalcs.empty() && mOnRequestCalcs.count(name)) return false;
+    return mvRequestedCalcs.empty() || std::find(mvRequestedCalcs.begin(), mvRequestedCalcs.end(), name) != mvRequestedCalcs.end();
+}
+
+void LjmetFactory::BuildCalcs()
+{
+    if (mCalcsBuilt) return;
+    mCalcsBuilt = true;
+    unsigned long _registered = mCalcMakers.size() + mpCalculators.size();
+    
+    // calculators registered as objects, not requested or excluded
+    std::map<std::string, BaseCalc * >::iterator iCalc = mpCalculators.begin();
+    while (iCalc != mpCalculators.end()) {
+        if (isCalcWanted(iCalc->first)) ++iCalc;
+        else {
+            delete iCalc->second;
+            mpCalculators.erase(iCalc++);
+        }
+    }
+    
+    for (std::map<std::string, CalcMaker>::const_iterator iMaker = mCalcMakers.begin(); iMaker != mCalcMakers.end(); ++iMaker) {
+        if (!isCalcWanted(iMaker->first)) continue;
+        BaseCalc * _calc = iMaker->second();
+        _calc->setName(iMaker->first);
+        _calc->init();
+        mpCalculators[iMaker->first] = _calc;
+    }
+    std::cout << mLegend << "built " << mpCalculators.size() << " of " << _registered << " registered calculators" << std::endl;
+}
+
 void LjmetFactory::BeginJobAllCalc()
 {
     // Run all BeginJob()'s
@@ -134,12 +218,38 @@ void LjmetFactory::EndJobAllCalc()
     }
 }
 
+std::map<std::string, std::vector<double> > LjmetFactory::GetAllCalcState() const
+{
+    std::map<std::string, std::vector<double> > _state;
+    for (std::map<std::string, BaseCalc * >::const_iterator iCalc = mpCalculators.begin(); iCalc != mpCalculators.end(); ++iCalc) {
+        std::vector<double> _calcState = iCalc->second->GetState();
+        if (!_calcState.empty()) _state[iCalc->first] = _calcState;
+    }
+    return _state;
+}
+
+void LjmetFactory::SetAllCalcState(std::map<std::string, std::vector<double> > const & state)
+{
+    for (std::map<std::string, std::vector<double> >::const_iterator iState = state.begin(); iState != state.end(); ++iState) {
+        std::map<std::string, BaseCalc * >::const_iterator iCalc = mpCalculators.find(iState->first);
+        if (iCalc == mpCalculators.end()) {
+            std::cout << mLegend << "no calculator " << iState->first << " to restore the checkpointed state of" << std::endl;
+            continue;
+        }
+        iCalc->second->SetState(iState->second);
+    }
+}
+
 void LjmetFactory::RunBeginEvent(edm::EventBase const & event, LjmetEventContent & ec)
 {
+    LjmetArena::GetInstance()->BeginEvent();
+    LjmetEventProducts::GetInstance()->BeginEvent(event, theSelector);
     theSelector->BeginEvent(event, ec);
 }
 
 void LjmetFactory::RunEndEvent(edm::EventBase const & event, LjmetEventContent & ec)
 {
     theSelector->EndEvent(event, ec);
+    // the temporaries of the calculators are gone
+    LjmetArena::GetInstance()->Reset();
 }
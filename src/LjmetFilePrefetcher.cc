@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "TROOT.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+#include "LJMet/Com/interface/LjmetFilePrefetcher.h"
+
+LjmetFilePrefetcher::LjmetFilePrefetcher(std::vector<std::string> const & fileNames, int nFiles, long long memoryBudget):
+mLegend("[LjmetFilePrefetcher]: "),
+mvFileNames(fileNames),
+mFiles(std::max(nFiles, 0)),
+mCacheSize(nFiles > 0 ? memoryBudget/nFiles : 0),
+mvEntries(fileNames.size(), -1),
+mNext(0),
+mStop(false),
+mGets(0),
+mHits(0),
+mStallSeconds(0.0),
+mMaxStallSeconds(0.0),
+mBytesAhead(0)
+{
+    // the files are opened and read in two threads
+    ROOT::EnableThreadSafety();
+
+    std::cout << mLegend << "reading " << mFiles << " files ahead, "
+              << mCacheSize/1024/1024 << " MB cache per file" << std::endl;
+    mThread = std::thread(&LjmetFilePrefetcher::run, this);
+}
+
+LjmetFilePrefetcher::~LjmetFilePrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> _lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    mThread.join();
+
+    for (std::map<unsigned int, Slot>::iterator it = mSlots.begin(); it != mSlots.end(); ++it) delete it->second.file;
+}
+
+TFile * LjmetFilePrefetcher::Get(unsigned int index)
+{
+    Clock::time_point const _start = Clock::now();
+
+    TFile * _file = 0;
+    {
+        std::unique_lock<std::mutex> _lock(mMutex);
+        mNext = index + 1;
+        std::map<unsigned int, Slot>::iterator it = mSlots.find(index);
+        if (it != mSlots.end()) {
+            // being read ahead, the thread keeps it while it is waited for
+            while (!it->second.ready) mCondition.wait(_lock);
+            _file = it->second.file;
+            mSlots.erase(it);
+            if (_file) ++mHits;
+        }
+        release(mNext);
+    }
+    mCondition.notify_all();
+
+    // not read ahead, or failed to open then
+    if (!_file) _file = open(index, false);
+    if (!_file) {
+        std::cout << mLegend << "cannot open " << mvFileNames[index] << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+
+    double const _stall = std::chrono::duration<double>(Clock::now() - _start).count();
+    std::lock_guard<std::mutex> _lock(mMutex);
+    ++mGets;
+    mStallSeconds += _stall;
+    mMaxStallSeconds = std::max(mMaxStallSeconds, _stall);
+    return _file;
+}
+
+Long64_t LjmetFilePrefetcher::GetEntries(unsigned int index)
+{
+    {
+        std::lock_guard<std::mutex> _lock(mMutex);
+        if (mvEntries[index] >= 0) return mvEntries[index];
+    }
+
+    TFile * _file = open(index, false);
+    if (!_file) {
+        std::cout << mLegend << "cannot open " << mvFileNames[index] << ", exiting" << std::endl;
+        std::exit(-1);
+    }
+    delete _file;
+
+    std::lock_guard<std::mutex> _lock(mMutex);
+    return mvEntries[index];
+}
+
+void LjmetFilePrefetcher::run()
+{
+    std::unique_lock<std::mutex> _lock(mMutex);
+    while (!mStop) {
+        // the first file of the window that is not read ahead yet
+        unsigned int _index = mNext;
+        unsigned int const _end = std::min<size_t>(mNext + mFiles, mvFileNames.size());
+        while (_index < _end && mSlots.find(_index) != mSlots.end()) ++_index;
+        if (_index >= _end) {
+            mCondition.wait(_lock);
+            continue;
+        }
+
+        mSlots[_index];
+        _lock.unlock();
+        TFile * _file = open(_index, true);
+        _lock.lock();
+
+        // the event loop may have moved past the file meanwhile
+        if (_index + 1 < mNext || _index >= mNext + mFiles) {
+            delete _file;
+            mSlots.erase(_index);
+        }
+        else {
+            mSlots[_index].file = _file;
+            mSlots[_index].ready = true;
+        }
+        mCondition.notify_all();
+    }
+}
+
+TFile * LjmetFilePrefetcher::open(unsigned int index, bool warm)
+{
+    TFile * _file = TFile::Open(mvFileNames[index].c_str());
+    if (!_file || _file->IsZombie()) {
+        delete _file;
+        return 0;
+    }
+
+    TTree * _tree = 0;
+    _file->GetObject("Events", _tree);
+    Long64_t const _entries = _tree ? _tree->GetEntries() : 0;
+
+    // the first cluster of all branches, the branches that are not read
+    // are dropped from the cache when the input is tuned
+    if (warm && _entries > 0 && mCacheSize > 0) {
+        _tree->SetCacheSize(mCacheSize);
+        _tree->AddBranchToCache("*", kTRUE);
+        _tree->StopCacheLearningPhase();
+        _tree->LoadTree(0);
+        TTreeCache * _cache = dynamic_cast<TTreeCache *>(_file->GetCacheRead(_tree));
+        if (_cache) _cache->FillBuffer();
+    }
+
+    std::lock_guard<std::mutex> _lock(mMutex);
+    mvEntries[index] = _entries;
+    if (warm) mBytesAhead += _file->GetBytesRead();
+    return _file;
+}
+
+void LjmetFilePrefetcher::release(unsigned int first)
+{
+    // files read ahead that are no longer ahead, e.g. after a jump back;
+    // files still being read are dropped by the thread
+    for (std::map<unsigned int, Slot>::iterator it = mSlots.begin(); it != mSlots.end(); ) {
+        if (it->second.ready && (it->first < first || it->first >= first + mFiles)) {
+            delete it->second.file;
+            mSlots.erase(it++);
+        }
+        else ++it;
+    }
+}
+
+void LjmetFilePrefetcher::Report(std::ostream & out) const
+{
+    std::lock_guard<std::mutex> _lock(mMutex);
+    out << mLegend << mGets << " input files opened, " << mHits << " of them read ahead, "
+        << mBytesAhead/1024/1024 << " MB read ahead" << std::endl;
+    out << mLegend << "stall time " << mStallSeconds << " s";
+    if (mGets > 0) out << ", " << mStallSeconds/mGets << " s per file, " << mMaxStallSeconds << " s at most";
+    out << std::endl;
+}
+
+
+
+LjmetPrefetchEventSource::LjmetPrefetchEventSource(std::vector<std::string> const & fileNames, int nFiles, long long memoryBudget):
+mvFileNames(fileNames),
+mPrefetcher(fileNames, nFiles, memoryBudget),
+mIndex(0),
+mFile(0),
+mEvent(0)
+{
+}
+
+LjmetPrefetchEventSource::~LjmetPrefetchEventSource()
+{
+    closeFile();
+}
+
+Long64_t LjmetPrefetchEventSource::Size()
+{
+    Long64_t _size = 0;
+    for (unsigned int i = 0; i < mvFileNames.size(); ++i) _size += mPrefetcher.GetEntries(i);
+    return _size;
+}
+
+void LjmetPrefetchEventSource::ToBegin()
+{
+    toNonEmptyFile(0);
+}
+
+void LjmetPrefetchEventSource::Next()
+{
+    ++(*mEvent);
+    if (mEvent->atEnd()) toNonEmptyFile(mIndex + 1);
+}
+
+bool LjmetPrefetchEventSource::To(Long64_t entry)
+{
+    if (entry < 0) return false;
+    for (unsigned int i = 0; i < mvFileNames.size(); ++i) {
+        Long64_t const _entries = mPrefetcher.GetEntries(i);
+        if (entry < _entries) {
+            if (i != mIndex || !mEvent) toFile(i);
+            return mEvent->to(entry);
+        }
+        entry -= _entries;
+    }
+    return false;
+}
+
+bool LjmetPrefetchEventSource::toFile(unsigned int index)
+{
+    closeFile();
+    mIndex = index;
+    mFile = mPrefetcher.Get(index);
+    if (mPrefetcher.GetEntries(index) == 0) {
+        closeFile();
+        return false;
+    }
+
+    // keep the cache of a file read ahead, fwlite would replace it
+    TTree * _tree = 0;
+    mFile->GetObject("Events", _tree);
+    bool const _warm = mFile->GetCacheRead(_tree) != 0;
+    mEvent = new fwlite::Event(mFile, !_warm);
+    return true;
+}
+
+void LjmetPrefetchEventSource::toNonEmptyFile(unsigned int index)
+{
+    for (; index < mvFileNames.size(); ++index) {
+        if (toFile(index)) {
+            mEvent->toBegin();
+            return;
+        }
+    }
+    closeFile();
+}
+
+void LjmetPrefetchEventSource::closeFile()
+{
+    delete mEvent;
+    mEvent = 0;
+    delete mFile;
+    mFile = 0;
+}
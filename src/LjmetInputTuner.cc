@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <fnmatch.h>
+#include <iostream>
+
+#include "TBranch.h"
+#include "TFileCacheRead.h"
+#include "TObjArray.h"
+#include "LJMet/Com/interface/LjmetInputTuner.h"
+
+LjmetInputTuner::LjmetInputTuner(edm::ParameterSet const & inputs):
+mLegend("[LjmetInputTuner]: "),
+mLearnEvents(inputs.exists("learnBranches") ? inputs.getUntrackedParameter<int>("learnBranches") : 0),
+mCacheSize(inputs.exists("cacheSize") ? inputs.getUntrackedParameter<int>("cacheSize") : 0),
+mTuned(false),
+mFile(0),
+mBranches(0),
+mActiveBranches(0),
+mTunedCacheSize(0),
+mEvents(0),
+mStartBytes(0)
+{
+    if (inputs.exists("branches")) mvDeclared = inputs.getUntrackedParameter<std::vector<std::string> >("branches");
+    // a declared list needs no warm-up
+    if (!mvDeclared.empty()) mLearnEvents = 0;
+}
+
+void LjmetInputTuner::Process(TFile * file)
+{
+    if (!IsEnabled() || !file) return;
+
+    if (mEvents == 0) {
+        mStartBytes = TFile::GetFileBytesRead();
+        mStartTime = Clock::now();
+    }
+    ++mEvents;
+
+    if (!mTuned) {
+        // collected every event, the window may span several files
+        if (mLearnEvents > 0) {
+            TTree * _tree = getTree(file);
+            if (_tree) learn(_tree);
+        }
+        if (mEvents < mLearnEvents) return;
+
+        mBefore.events = mEvents;
+        mBefore.bytes = TFile::GetFileBytesRead() - mStartBytes;
+        mBefore.seconds = std::chrono::duration<double>(Clock::now() - mStartTime).count();
+        mTuned = true;
+    }
+
+    // a new input file
+    if (file != mFile || mFileName != file->GetName()) {
+        TTree * _tree = getTree(file);
+        if (_tree) tune(_tree);
+        mFile = file;
+        mFileName = file->GetName();
+    }
+}
+
+TTree * LjmetInputTuner::getTree(TFile * file) const
+{
+    // the tree FWLite reads, Get finds it in memory
+    TTree * _tree = 0;
+    file->GetObject("Events", _tree);
+    return _tree;
+}
+
+void LjmetInputTuner::learn(TTree * tree)
+{
+    TObjArray * _branches = tree->GetListOfBranches();
+    for (int i = 0; i < _branches->GetEntriesFast(); ++i) {
+        TBranch * _branch = (TBranch *)_branches->UncheckedAt(i);
+        if (_branch->GetReadEntry() >= 0) mLearned.insert(_branch->GetName());
+    }
+}
+
+bool LjmetInputTuner::isActive(std::string const & branchName) const
+{
+    if (mvDeclared.empty()) return mLearned.find(branchName) != mLearned.end();
+    for (unsigned int i = 0; i < mvDeclared.size(); ++i) {
+        if (fnmatch(mvDeclared[i].c_str(), branchName.c_str(), 0) == 0) return true;
+    }
+    return false;
+}
+
+void LjmetInputTuner::tune(TTree * tree)
+{
+    Long64_t const _entries = std::max(tree->GetEntries(), (Long64_t)1);
+    TObjArray * _branches = tree->GetListOfBranches();
+    std::vector<TBranch *> _active;
+    double _bytesPerEntry = 0.0;
+    for (int i = 0; i < _branches->GetEntriesFast(); ++i) {
+        TBranch * _branch = (TBranch *)_branches->UncheckedAt(i);
+        if (!isActive(_branch->GetName())) continue;
+        _active.push_back(_branch);
+        _bytesPerEntry += (double)_branch->GetZipBytes("*")/_entries;
+    }
+
+    // one cluster of the active branches; a negative AutoFlush is a size in
+    // bytes rather than entries, assume 100 entries then
+    long long _size = mCacheSize;
+    if (_size <= 0) {
+        Long64_t _cluster = tree->GetAutoFlush();
+        if (_cluster <= 0) _cluster = 100;
+        _size = (long long)(1.2*_bytesPerEntry*_cluster);
+        _size = std::min(std::max(_size, 1LL << 20), 256LL << 20);
+    }
+
+    // a cache that is large enough, e.g. filled by the read-ahead, keeps its
+    // buffer and only changes branches; resizing would throw the buffer away
+    TFileCacheRead * _cache = tree->GetCurrentFile()->GetCacheRead(tree);
+    if (_cache && _cache->GetBufferSize() >= _size) {
+        _size = _cache->GetBufferSize();
+        tree->DropBranchFromCache("*", kTRUE);
+    }
+    else tree->SetCacheSize(_size);
+    for (unsigned int i = 0; i < _active.size(); ++i) tree->AddBranchToCache(_active[i], kTRUE);
+    tree->StopCacheLearningPhase();
+
+    mBranches = _branches->GetEntriesFast();
+    mActiveBranches = _active.size();
+    mTunedCacheSize = _size;
+    std::cout << mLegend << "caching " << mActiveBranches << " of " << mBranches << " branches of "
+              << tree->GetCurrentFile()->GetName() << ", " << _size/1024 << " kB cache" << std::endl;
+}
+
+void LjmetInputTuner::printWindow(std::ostream & out, std::string const & name, Window const & window) const
+{
+    out << mLegend << name << ": " << window.events << " events";
+    if (window.events > 0) out << ", " << window.bytes/1024.0/window.events << " kB/event";
+    if (window.seconds > 0.0) out << ", " << window.events/window.seconds << " events/s";
+    out << std::endl;
+}
+
+void LjmetInputTuner::Report(std::ostream & out) const
+{
+    if (!IsEnabled() || mEvents == 0) return;
+
+    Window _before = mBefore;
+    Window _after;
+    if (!mTuned) {
+        _before.events = mEvents;
+        _before.bytes = TFile::GetFileBytesRead() - mStartBytes;
+        _before.seconds = std::chrono::duration<double>(Clock::now() - mStartTime).count();
+    }
+    else {
+        _after.events = mEvents - mBefore.events;
+        _after.bytes = TFile::GetFileBytesRead() - mStartBytes - mBefore.bytes;
+        _after.seconds = std::chrono::duration<double>(Clock::now() - mStartTime).count() - mBefore.seconds;
+    }
+    printWindow(out, "before tuning", _before);
+    printWindow(out, "after tuning", _after);
+    if (mTuned) out << mLegend << mActiveBranches << " of " << mBranches << " branches cached, " << mTunedCacheSize/1024 << " kB cache" << std::endl;
+}
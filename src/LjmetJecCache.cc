@@ -0,0 +1,307 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LJMet/Com/interface/LjmetJecCache.h"
+
+namespace {
+    // cache file layout: header, index of nEntries entries, parameters
+    //   entry       string name, string section, u64 text file size, u64 offset in the parameters
+    //   parameters  string definitions, u32 nRecords, nRecords x (u32 nVar, u32 nPar,
+    //               nVar floats xMin, nVar floats xMax, nPar floats)
+    //   string      u32 length, chars
+    const char cacheMagic[8] = { 'L','J','M','J','E','C','C','H' };
+    const unsigned int cacheVersion = 1;
+
+    struct CacheHeader {
+        char magic[8];
+        unsigned int version;
+        unsigned int nEntries;
+        unsigned long long size;
+        /// of everything after the header
+        unsigned long long checksum;
+    };
+
+    // FNV-1a
+    unsigned long long checksum(const char * data, size_t n) {
+        unsigned long long _hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < n; ++i) {
+            _hash ^= (unsigned char)data[i];
+            _hash *= 1099511628211ULL;
+        }
+        return _hash;
+    }
+
+    template <class T> void put(std::string & out, T const & value) {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+    void putString(std::string & out, std::string const & value) {
+        put(out, (unsigned int)value.size());
+        out.append(value);
+    }
+
+    /// Bounds-checked reads from the mapped file, unaligned
+    struct Cursor {
+        Cursor(const char * begin, const char * end): p(begin), end(end), ok(true) { }
+        template <class T> T get() {
+            T _value = T();
+            if (ok && (size_t)(end - p) >= sizeof(T)) {
+                std::memcpy(&_value, p, sizeof(T));
+                p += sizeof(T);
+            }
+            else ok = false;
+            return _value;
+        }
+        std::string getString() {
+            unsigned int _n = get<unsigned int>();
+            if (!ok || (size_t)(end - p) < _n) {
+                ok = false;
+                return "";
+            }
+            p += _n;
+            return std::string(p - _n, _n);
+        }
+        void getFloats(std::vector<float> & values, unsigned int n) {
+            if (!ok || (size_t)(end - p) < n*sizeof(float)) {
+                ok = false;
+                return;
+            }
+            values.resize(n);
+            if (n) std::memcpy(&values[0], p, n*sizeof(float));
+            p += n*sizeof(float);
+        }
+        const char * p;
+        const char * end;
+        bool ok;
+    };
+
+    std::string baseName(std::string const & path) {
+        size_t _slash = path.rfind('/');
+        return _slash == std::string::npos ? path : path.substr(_slash + 1);
+    }
+
+    /// Size of the text file, -1 if there is none
+    long long fileSize(std::string const & path) {
+        struct stat _st;
+        if (stat(path.c_str(), &_st) != 0) return -1;
+        return _st.st_size;
+    }
+
+    /// Definitions line as in the text file, without the braces
+    std::string definitionsLine(JetCorrectorParameters::Definitions const & definitions) {
+        std::ostringstream _line;
+        _line << definitions.nBinVar();
+        for (unsigned int i = 0; i < definitions.nBinVar(); ++i) _line << " " << definitions.binVar(i);
+        _line << " " << definitions.nParVar();
+        for (unsigned int i = 0; i < definitions.nParVar(); ++i) _line << " " << definitions.parVar(i);
+        _line << " " << definitions.formula()
+              << " " << (definitions.isResponse() ? "Response" : "Correction")
+              << " " << definitions.level();
+        return _line.str();
+    }
+}
+
+LjmetJecCache::LjmetJecCache(std::string const & fileName):
+mLegend("[LjmetJecCache]: "),
+mFileName(fileName),
+mpData(0),
+mSize(0),
+mFromCache(0),
+mFromText(0),
+mSeconds(0.0)
+{
+    if (fileName != "" && !map(fileName)) {
+        std::cout << mLegend << "cannot use " << fileName << ", parsing the text files" << std::endl;
+    }
+}
+
+LjmetJecCache::~LjmetJecCache()
+{
+    if (mpData) munmap(const_cast<char *>(mpData), mSize);
+}
+
+bool LjmetJecCache::map(std::string const & fileName)
+{
+    int _fd = open(fileName.c_str(), O_RDONLY);
+    if (_fd < 0) return false;
+    struct stat _st;
+    CacheHeader _header;
+    if (fstat(_fd, &_st) != 0 || (size_t)_st.st_size < sizeof(_header)
+        || pread(_fd, &_header, sizeof(_header), 0) != (ssize_t)sizeof(_header)
+        || std::memcmp(_header.magic, cacheMagic, sizeof(cacheMagic)) != 0) {
+        close(_fd);
+        return false;
+    }
+    if (_header.version != cacheVersion) {
+        std::cout << mLegend << fileName << " has version " << _header.version << ", expected " << cacheVersion << std::endl;
+        close(_fd);
+        return false;
+    }
+    if ((unsigned long long)_st.st_size != sizeof(_header) + _header.size) {
+        std::cout << mLegend << fileName << " is truncated" << std::endl;
+        close(_fd);
+        return false;
+    }
+    void * _map = mmap(0, _st.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+    close(_fd);
+    if (_map == MAP_FAILED) return false;
+    mpData = static_cast<const char *>(_map);
+    mSize = _st.st_size;
+
+    if (checksum(mpData + sizeof(_header), _header.size) != _header.checksum) {
+        std::cout << mLegend << fileName << " is corrupt, checksum mismatch" << std::endl;
+        munmap(_map, mSize);
+        mpData = 0;
+        return false;
+    }
+
+    Cursor _cursor(mpData + sizeof(_header), mpData + mSize);
+    for (unsigned int i = 0; i < _header.nEntries; ++i) {
+        Entry _entry;
+        _entry.name = _cursor.getString();
+        _entry.section = _cursor.getString();
+        _entry.txtSize = _cursor.get<unsigned long long>();
+        _entry.offset = _cursor.get<unsigned long long>();
+        mvEntries.push_back(_entry);
+    }
+    // parameter offsets are relative to the end of the index
+    size_t _start = _cursor.p - mpData;
+    for (unsigned int i = 0; i < mvEntries.size(); ++i) {
+        mvEntries[i].offset += _start;
+        if (mvEntries[i].offset > mSize) _cursor.ok = false;
+    }
+    if (!_cursor.ok) {
+        std::cout << mLegend << fileName << " has a broken index" << std::endl;
+        mvEntries.clear();
+        return false;
+    }
+    return true;
+}
+
+LjmetJecCache::Entry const * LjmetJecCache::find(std::string const & txtFile, std::string const & section) const
+{
+    std::string _name = baseName(txtFile);
+    for (unsigned int i = 0; i < mvEntries.size(); ++i) {
+        if (mvEntries[i].name == _name && mvEntries[i].section == section) return &mvEntries[i];
+    }
+    return 0;
+}
+
+JetCorrectorParameters LjmetJecCache::Load(std::string const & txtFile, std::string const & section)
+{
+    std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+    Entry const * _entry = find(txtFile, section);
+    if (_entry) {
+        long long _txtSize = fileSize(txtFile);
+        if (_txtSize >= 0 && (unsigned long long)_txtSize != _entry->txtSize) {
+            std::cout << mLegend << txtFile << " changed since " << mFileName << " was made, parsing it" << std::endl;
+            _entry = 0;
+        }
+    }
+
+    if (_entry) {
+        Cursor _cursor(mpData + _entry->offset, mpData + mSize);
+        JetCorrectorParameters::Definitions _definitions(_cursor.getString());
+        unsigned int _nRecords = _cursor.get<unsigned int>();
+        std::vector<JetCorrectorParameters::Record> _records;
+        std::vector<float> _xMin, _xMax, _parameters;
+        for (unsigned int i = 0; _cursor.ok && i < _nRecords; ++i) {
+            unsigned int _nVar = _cursor.get<unsigned int>();
+            unsigned int _nPar = _cursor.get<unsigned int>();
+            _cursor.getFloats(_xMin, _nVar);
+            _cursor.getFloats(_xMax, _nVar);
+            _cursor.getFloats(_parameters, _nPar);
+            _records.push_back(JetCorrectorParameters::Record(_nVar, _xMin, _xMax, _parameters));
+        }
+        if (_cursor.ok) {
+            ++mFromCache;
+            mSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+            return JetCorrectorParameters(_definitions, _records);
+        }
+        std::cout << mLegend << "broken entry for " << txtFile << " in " << mFileName << ", parsing it" << std::endl;
+    }
+
+    JetCorrectorParameters _parameters(txtFile, section);
+    ++mFromText;
+    mSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    return _parameters;
+}
+
+void LjmetJecCache::Report(std::ostream & out) const
+{
+    if (mFromCache + mFromText == 0) return;
+    out << mLegend << mFromCache << " JEC parameter sets from the cache, "
+        << mFromText << " parsed from text, " << mSeconds*1000.0 << " ms" << std::endl;
+}
+
+bool LjmetJecCache::Write(std::string const & fileName, std::vector<std::string> const & txtFiles)
+{
+    std::string _index;
+    std::string _data;
+    for (unsigned int i = 0; i < txtFiles.size(); ++i) {
+        // file:section, a colon in a directory name is not a section
+        std::string _file = txtFiles[i];
+        std::string _section;
+        size_t _colon = _file.rfind(':');
+        if (_colon != std::string::npos && _file.find('/', _colon) == std::string::npos) {
+            _section = _file.substr(_colon + 1);
+            _file = _file.substr(0, _colon);
+        }
+        long long _txtSize = fileSize(_file);
+        if (_txtSize < 0) {
+            std::cout << "[LjmetJecCache]: cannot read " << _file << std::endl;
+            return false;
+        }
+
+        JetCorrectorParameters _parameters(_file, _section);
+        putString(_index, baseName(_file));
+        putString(_index, _section);
+        put(_index, (unsigned long long)_txtSize);
+        put(_index, (unsigned long long)_data.size());
+
+        putString(_data, definitionsLine(_parameters.definitions()));
+        put(_data, (unsigned int)_parameters.size());
+        for (unsigned int k = 0; k < _parameters.size(); ++k) {
+            JetCorrectorParameters::Record const & _record = _parameters.record(k);
+            put(_data, (unsigned int)_record.nVar());
+            put(_data, (unsigned int)_record.nParameters());
+            for (unsigned int v = 0; v < _record.nVar(); ++v) put(_data, _record.xMin(v));
+            for (unsigned int v = 0; v < _record.nVar(); ++v) put(_data, _record.xMax(v));
+            for (unsigned int p = 0; p < _record.nParameters(); ++p) put(_data, _record.parameter(p));
+        }
+        std::cout << "[LjmetJecCache]: " << _file << (_section == "" ? "" : " [" + _section + "]")
+                  << ", " << _parameters.size() << " records" << std::endl;
+    }
+    _index += _data;
+
+    CacheHeader _header;
+    std::memset(&_header, 0, sizeof(_header));
+    std::memcpy(_header.magic, cacheMagic, sizeof(cacheMagic));
+    _header.version = cacheVersion;
+    _header.nEntries = txtFiles.size();
+    _header.size = _index.size();
+    _header.checksum = checksum(_index.data(), _index.size());
+
+    // write to a temporary file first, so parallel jobs never map a partial cache
+    std::ostringstream _tmpStream;
+    _tmpStream << fileName << ".tmp" << getpid();
+    std::string _tmpName = _tmpStream.str();
+    std::ofstream _file(_tmpName.c_str(), std::ios::binary);
+    _file.write(reinterpret_cast<const char *>(&_header), sizeof(_header));
+    _file.write(_index.data(), _index.size());
+    _file.close();
+    if (!_file || std::rename(_tmpName.c_str(), fileName.c_str()) != 0) {
+        std::cout << "[LjmetJecCache]: could not write " << fileName << std::endl;
+        std::remove(_tmpName.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <ostream>
+
+#include "EgammaAnalysis/ElectronTools/interface/ElectronEffectiveArea.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "LJMet/Com/interface/LjmetLeptonId.h"
+
+namespace {
+    /// pass[i] &= the cut, for all leptons; no branches, the region picks the value
+    template <class Compare>
+    void applyCut(double const * x, int const * region, double const * value,
+                  unsigned char const * skip, unsigned char const * test, unsigned int n, unsigned char * pass)
+    {
+        Compare const _compare = Compare();
+        for (unsigned int i = 0; i < n; ++i) {
+            int const _r = region[i];
+            pass[i] &= skip[_r] | (test[_r] & (unsigned char)_compare(x[i], value[_r]));
+        }
+    }
+}
+
+LjmetLeptonId::Cut::Cut(int column, int op, double value):
+column(column),
+op(op)
+{
+    for (int r = 0; r < nRegions; ++r) {
+        this->value[r] = value;
+        skip[r] = 0;
+        test[r] = 1;
+    }
+}
+
+LjmetLeptonId::LjmetLeptonId():
+mMuonTightPv(false),
+mMuonLoose(false),
+mRho(0.0)
+{
+}
+
+void LjmetLeptonId::addFlag(WorkingPoint & wp, bool considered, int column)
+{
+    if (considered) wp.push_back(Cut(column, opGreaterEqual, 1.0));
+}
+
+template <class T, class S>
+void LjmetLeptonId::addSelectorCut(WorkingPoint & wp, S const & selector, std::string const & name, int column, int op)
+{
+    if (selector.ignoreCut(name)) return;
+    wp.push_back(Cut(column, op, selector.cut(name, T())));
+}
+
+template <class T, class S>
+void LjmetLeptonId::addRegionCut(WorkingPoint & wp, S const & selector, std::string const & name, int column, int op)
+{
+    bool const _ignoreEB = selector.ignoreCut(name + "_EB");
+    bool const _ignoreEE = selector.ignoreCut(name + "_EE");
+    if (_ignoreEB && _ignoreEE) return;
+
+    Cut _cut(column, op, 0.0);
+    if (!_ignoreEB) _cut.value[regionEB] = selector.cut(name + "_EB", T());
+    if (!_ignoreEE) _cut.value[regionEE] = selector.cut(name + "_EE", T());
+    _cut.skip[regionEB] = _ignoreEB;
+    _cut.skip[regionEE] = _ignoreEE;
+    _cut.test[regionNone] = 0;
+    wp.push_back(_cut);
+}
+
+int LjmetLeptonId::AddMuonWorkingPoint(PFMuonSelector const & selector, double minPt, double maxEta)
+{
+    WorkingPoint _wp;
+    addFlag(_wp, !selector.ignoreCut("GlobalMuon"), muGlobal);
+    addFlag(_wp, !selector.ignoreCut("TrackerMuon"), muTracker);
+    addFlag(_wp, !selector.ignoreCut("GlobalOrTrackerMuon"), muGlobalOrTracker);
+    addSelectorCut<double>(_wp, selector, "Chi2", muChi2, opLess);
+    addSelectorCut<int>(_wp, selector, "minTrackerLayers", muTrackerLayers, opGreaterEqual);
+    addSelectorCut<int>(_wp, selector, "minValidMuHits", muValidMuHits, opGreaterEqual);
+    addSelectorCut<double>(_wp, selector, "maxIp", muIp, opLess);
+    addSelectorCut<int>(_wp, selector, "minPixelHits", muPixelHits, opGreaterEqual);
+    addSelectorCut<int>(_wp, selector, "minMatchedStations", muStations, opGreaterEqual);
+    addSelectorCut<double>(_wp, selector, "maxPfRelIso", muRelIso, opLess);
+    _wp.push_back(Cut(muPt, opGreater, minPt));
+    _wp.push_back(Cut(muAbsEta, opLess, maxEta));
+
+    mvMuonWps.push_back(_wp);
+    return mvMuonWps.size() - 1;
+}
+
+int LjmetLeptonId::AddMuonWorkingPoint(bool tight, double maxRelIso, double minPt, double maxEta)
+{
+    WorkingPoint _wp;
+    if (tight) mMuonTightPv = true;
+    else mMuonLoose = true;
+    addFlag(_wp, true, tight ? muTightPv : muLoose);
+    _wp.push_back(Cut(muRelIso, opLess, maxRelIso));
+    _wp.push_back(Cut(muPt, opGreater, minPt));
+    _wp.push_back(Cut(muAbsEta, opLess, maxEta));
+
+    mvMuonWps.push_back(_wp);
+    return mvMuonWps.size() - 1;
+}
+
+int LjmetLeptonId::AddElectronWorkingPoint(TopElectronSelector const & selector, double minPt, double maxEta)
+{
+    int const _wp = AddElectronWorkingPoint(selector);
+    if (_wp < 0) return _wp;
+    mvElectronWps[_wp].push_back(Cut(elPt, opGreater, minPt));
+    mvElectronWps[_wp].push_back(Cut(elAbsEta, opLess, maxEta));
+    return _wp;
+}
+
+int LjmetLeptonId::AddElectronWorkingPoint(TopElectronSelector const & selector)
+{
+    if (selector.version() == TopElectronSelector::HEEP) return -1;
+    if (mvElectronWps.empty()) {
+        mPvSrc = selector.pvSrc();
+        mRhoSrc = selector.rhoSrc();
+    }
+    else if (!(selector.pvSrc() == mPvSrc) || !(selector.rhoSrc() == mRhoSrc)) return -1;
+
+    WorkingPoint _wp;
+    addFlag(_wp, true, elValid);
+    addRegionCut<double>(_wp, selector, "deta", elDeta, opLess);
+    addRegionCut<double>(_wp, selector, "dphi", elDphi, opLess);
+    addRegionCut<double>(_wp, selector, "sihih", elSihih, opLess);
+    addRegionCut<double>(_wp, selector, "hoe", elHoE, opLess);
+    addRegionCut<double>(_wp, selector, "d0", elD0, opLess);
+    addRegionCut<double>(_wp, selector, "dZ", elDz, opLess);
+    addRegionCut<double>(_wp, selector, "ooemoop", elOoemoop, opLess);
+    addRegionCut<double>(_wp, selector, "reliso", elRelIso, opLess);
+    addRegionCut<int>(_wp, selector, "mHits", elMissingHits, opLessEqual);
+    // the versions all require the conversion veto when it is not ignored
+    addFlag(_wp, !selector.ignoreCut("vtxFitConv"), elConvVeto);
+
+    mvElectronWps.push_back(_wp);
+    return mvElectronWps.size() - 1;
+}
+
+void LjmetLeptonId::resize(std::vector<std::vector<double> > & columns, unsigned int n)
+{
+    for (unsigned int c = 0; c < columns.size(); ++c) columns[c].resize(n);
+    mvRegions.resize(n);
+}
+
+void LjmetLeptonId::EvaluateMuons(std::vector<pat::Muon> const & muons, reco::Vertex const * pv)
+{
+    unsigned int const _n = muons.size();
+    mvMuonColumns.resize(muNColumns);
+    resize(mvMuonColumns, _n);
+    for (unsigned int i = 0; i < _n; ++i) fillMuon(i, muons[i], pv);
+    evaluate(mvMuonWps, mvMuonColumns, _n, mvMuonMasks);
+}
+
+void LjmetLeptonId::EvaluateElectrons(std::vector<pat::Electron> const & electrons, edm::EventBase const & event)
+{
+    unsigned int const _n = electrons.size();
+    if (_n > 0) readElectronInputs(event);
+    mvElectronColumns.resize(elNColumns);
+    resize(mvElectronColumns, _n);
+    for (unsigned int i = 0; i < _n; ++i) fillElectron(i, electrons[i]);
+    evaluate(mvElectronWps, mvElectronColumns, _n, mvElectronMasks);
+}
+
+void LjmetLeptonId::EvaluateElectrons(std::vector<edm::Ptr<pat::Electron> > const & electrons, edm::EventBase const & event)
+{
+    unsigned int const _n = electrons.size();
+    if (_n > 0) readElectronInputs(event);
+    mvElectronColumns.resize(elNColumns);
+    resize(mvElectronColumns, _n);
+    for (unsigned int i = 0; i < _n; ++i) fillElectron(i, *electrons[i]);
+    evaluate(mvElectronWps, mvElectronColumns, _n, mvElectronMasks);
+}
+
+void LjmetLeptonId::fillMuon(unsigned int i, pat::Muon const & muon, reco::Vertex const * pv)
+{
+    std::vector<std::vector<double> > & _c = mvMuonColumns;
+
+    // values of PFMuonSelector for muons without global track
+    double _chi2 = 9999999.0;
+    int _trackerLayers = 0;
+    int _validMuHits = 0;
+    double _ip = 9999999.0;
+    int _pixelHits = 0;
+    if ( muon.globalTrack().isNonnull() && muon.globalTrack().isAvailable() ) {
+        _chi2 = muon.normChi2();
+        _trackerLayers = muon.track()->hitPattern().trackerLayersWithMeasurement();
+        _validMuHits = muon.globalTrack()->hitPattern().numberOfValidMuonHits();
+        _ip = fabs(muon.dB());
+        _pixelHits = muon.innerTrack()->hitPattern().numberOfValidPixelHits();
+    }
+
+    double const _chIso = muon.userIsolation(pat::PfChargedHadronIso);
+    double const _nhIso = muon.userIsolation(pat::PfNeutralHadronIso);
+    double const _gIso  = muon.userIsolation(pat::PfGammaIso);
+    double const _puIso = muon.userIsolation(pat::PfPUChargedHadronIso);
+
+    _c[muGlobal][i]          = muon.isGlobalMuon();
+    _c[muTracker][i]         = muon.isTrackerMuon();
+    _c[muGlobalOrTracker][i] = muon.isGlobalMuon() || muon.isTrackerMuon();
+    _c[muChi2][i]            = _chi2;
+    _c[muTrackerLayers][i]   = _trackerLayers;
+    _c[muValidMuHits][i]     = _validMuHits;
+    _c[muIp][i]              = _ip;
+    _c[muPixelHits][i]       = _pixelHits;
+    _c[muStations][i]        = muon.numberOfMatches();
+    _c[muRelIso][i]          = (_chIso + std::max(0., _nhIso + _gIso - 0.5*_puIso))/muon.pt();
+    _c[muTightPv][i]         = mMuonTightPv && pv && muon.isTightMuon(*pv);
+    _c[muLoose][i]           = mMuonLoose && muon.isLooseMuon();
+    _c[muPt][i]              = muon.pt();
+    _c[muAbsEta][i]          = fabs(muon.eta());
+    mvRegions[i] = regionEB;
+}
+
+void LjmetLeptonId::readElectronInputs(edm::EventBase const & event)
+{
+    if (mvElectronWps.empty()) return;
+
+    edm::Handle<std::vector<reco::Vertex> > _pvs;
+    event.getByLabel(mPvSrc, _pvs);
+    if (_pvs->empty()) {
+        throw cms::Exception("InvalidInput") << " There needs to be at least one primary vertex in the event." << std::endl;
+    }
+    mPv = _pvs->at(0).position();
+
+    edm::Handle<double> _rho;
+    event.getByLabel(mRhoSrc, _rho);
+    mRho = std::max(*_rho, 0.0);
+}
+
+void LjmetLeptonId::fillElectron(unsigned int i, pat::Electron const & electron)
+{
+    std::vector<std::vector<double> > & _c = mvElectronColumns;
+
+    mvRegions[i] = electron.isEB() ? regionEB : (electron.isEE() ? regionEE : regionNone);
+    _c[elPt][i]     = electron.pt();
+    _c[elAbsEta][i] = fabs(electron.eta());
+
+    // fails every working point, the selector needs the track
+    _c[elValid][i] = electron.gsfTrack().isNonnull() && electron.gsfTrack().isAvailable();
+    if (!_c[elValid][i]) {
+        for (int c = elDeta; c <= elConvVeto; ++c) _c[c][i] = 0.0;
+        return;
+    }
+
+    // as in TopElectronSelector
+    double const _aEff = ElectronEffectiveArea::GetElectronEffectiveArea(ElectronEffectiveArea::kEleGammaAndNeutralHadronIso03,
+                                                                         electron.superCluster()->eta(),
+                                                                         ElectronEffectiveArea::kEleEAData2012);
+    double const _chIso = electron.chargedHadronIso();
+    double const _nhIso = electron.neutralHadronIso();
+    double const _phIso = electron.photonIso();
+
+    _c[elDeta][i]        = fabs(electron.deltaEtaSuperClusterTrackAtVtx());
+    _c[elDphi][i]        = fabs(electron.deltaPhiSuperClusterTrackAtVtx());
+    _c[elSihih][i]       = electron.sigmaIetaIeta();
+    _c[elHoE][i]         = electron.hadronicOverEm();
+    _c[elD0][i]          = fabs(electron.dB());
+    _c[elDz][i]          = fabs(electron.gsfTrack()->dz(mPv));
+    _c[elOoemoop][i]     = fabs(1.0/electron.ecalEnergy() - electron.eSuperClusterOverP()/electron.ecalEnergy());
+    _c[elRelIso][i]      = (_chIso + std::max(0.0, _nhIso + _phIso - mRho*_aEff))/electron.ecalDrivenMomentum().pt();
+    _c[elMissingHits][i] = electron.gsfTrack()->hitPattern().numberOfHits(reco::HitPattern::MISSING_INNER_HITS);
+    _c[elConvVeto][i]    = electron.passConversionVeto();
+}
+
+void LjmetLeptonId::evaluate(std::vector<WorkingPoint> const & wps, std::vector<std::vector<double> > const & columns,
+                             unsigned int n, std::vector<Mask> & masks)
+{
+    masks.resize(wps.size());
+    for (unsigned int w = 0; w < wps.size(); ++w) {
+        mvPass.assign(n, 1);
+        if (n == 0) {
+            masks[w].clear();
+            continue;
+        }
+
+        // cut by cut over all leptons
+        unsigned char * _pass = &mvPass[0];
+        int const * _region = &mvRegions[0];
+        for (unsigned int c = 0; c < wps[w].size(); ++c) {
+            Cut const & _cut = wps[w][c];
+            double const * _x = &columns[_cut.column][0];
+            switch (_cut.op) {
+                case opLess:
+                    applyCut<std::less<double> >(_x, _region, _cut.value, _cut.skip, _cut.test, n, _pass);
+                    break;
+                case opLessEqual:
+                    applyCut<std::less_equal<double> >(_x, _region, _cut.value, _cut.skip, _cut.test, n, _pass);
+                    break;
+                case opGreater:
+                    applyCut<std::greater<double> >(_x, _region, _cut.value, _cut.skip, _cut.test, n, _pass);
+                    break;
+                case opGreaterEqual:
+                    applyCut<std::greater_equal<double> >(_x, _region, _cut.value, _cut.skip, _cut.test, n, _pass);
+                    break;
+            }
+        }
+
+        masks[w].assign((n + 63)/64, 0);
+        for (unsigned int i = 0; i < n; ++i) masks[w][i >> 6] |= (unsigned long long)_pass[i] << (i & 63);
+    }
+}
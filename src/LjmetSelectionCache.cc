@@ -0,0 +1,153 @@
+#include <iostream>
+
+#include "TDirectory.h"
+#include "LJMet/Com/interface/LjmetSelectionCache.h"
+
+LjmetSelectionCache::LjmetSelectionCache():
+mLegend("[LjmetSelectionCache]: "),
+mpFile(0),
+mpTree(0),
+mSkipEvents(0),
+mNEvents(-1),
+mProcessed(0)
+{
+}
+
+LjmetSelectionCache::~LjmetSelectionCache()
+{
+    // a cache that was not closed stays incomplete
+    delete mpFile;
+}
+
+bool LjmetSelectionCache::Create(std::string const & fileName)
+{
+    TDirectory * _dir = gDirectory;
+    mpFile = TFile::Open(fileName.c_str(), "RECREATE");
+    if (!mpFile || mpFile->IsZombie()) {
+        std::cout << mLegend << "cannot create " << fileName << std::endl;
+        _dir->cd();
+        return false;
+    }
+    mpTree = new TTree("selection", "selection");
+    setBranches(true);
+    _dir->cd();
+    return true;
+}
+
+bool LjmetSelectionCache::Open(std::string const & fileName)
+{
+    TDirectory * _dir = gDirectory;
+    mpFile = TFile::Open(fileName.c_str());
+    _dir->cd();
+    if (!mpFile || mpFile->IsZombie()) {
+        std::cout << mLegend << "cannot open " << fileName << std::endl;
+        return false;
+    }
+    
+    TTree * _job = 0;
+    mpFile->GetObject("job", _job);
+    mpFile->GetObject("selection", mpTree);
+    if (!_job || !mpTree || _job->GetEntries() != 1) {
+        std::cout << mLegend << fileName << " is incomplete" << std::endl;
+        return false;
+    }
+    if (!mpTree->GetBranch("type1CorrMet")) {
+        std::cout << mLegend << fileName << " was written by an older ljmet, make it again" << std::endl;
+        return false;
+    }
+    std::vector<std::string> * _fileNames = &mvFileNames;
+    std::vector<Long64_t> * _cutFlow = &mvCutFlow;
+    _job->SetBranchAddress("fileNames", &_fileNames);
+    _job->SetBranchAddress("skipEvents", &mSkipEvents);
+    _job->SetBranchAddress("nEvents", &mNEvents);
+    _job->SetBranchAddress("processed", &mProcessed);
+    _job->SetBranchAddress("cutFlow", &_cutFlow);
+    _job->GetEntry(0);
+    _job->ResetBranchAddresses();
+    
+    setBranches(false);
+    return true;
+}
+
+void LjmetSelectionCache::Fill(Record const & record)
+{
+    mRecord = record;
+    mpTree->Fill();
+}
+
+void LjmetSelectionCache::Close(std::vector<std::string> const & fileNames, int skipEvents, int nEvents, Long64_t processed, std::vector<size_t> const & cutFlow)
+{
+    if (!mpFile) return;
+    TDirectory * _dir = gDirectory;
+    mpFile->cd();
+    
+    mvFileNames = fileNames;
+    mSkipEvents = skipEvents;
+    mNEvents = nEvents;
+    mProcessed = processed;
+    mvCutFlow.assign(cutFlow.begin(), cutFlow.end());
+    std::vector<std::string> * _fileNames = &mvFileNames;
+    std::vector<Long64_t> * _cutFlow = &mvCutFlow;
+    TTree * _job = new TTree("job", "job");
+    _job->Branch("fileNames", &_fileNames);
+    _job->Branch("skipEvents", &mSkipEvents, "skipEvents/I");
+    _job->Branch("nEvents", &mNEvents, "nEvents/I");
+    _job->Branch("processed", &mProcessed, "processed/L");
+    _job->Branch("cutFlow", &_cutFlow);
+    _job->Fill();
+    
+    mpFile->Write();
+    mpFile->Close();
+    delete mpFile;
+    mpFile = 0;
+    mpTree = 0;
+    _dir->cd();
+}
+
+LjmetSelectionCache::Record const & LjmetSelectionCache::GetRecord(Long64_t i)
+{
+    mpTree->GetEntry(i);
+    return mRecord;
+}
+
+void LjmetSelectionCache::setBranches(bool create)
+{
+    if (create) {
+        mpTree->Branch("entry", &mRecord.entry, "entry/L");
+        mpTree->Branch("met", &mRecord.met, "met/O");
+        mpTree->Branch("type1CorrMet", &mRecord.type1CorrMet, "type1CorrMet/O");
+        mpTree->Branch("corrMet", mRecord.corrMet, "corrMet[4]/D");
+    }
+    else {
+        mpTree->SetBranchAddress("entry", &mRecord.entry);
+        mpTree->SetBranchAddress("met", &mRecord.met);
+        mpTree->SetBranchAddress("type1CorrMet", &mRecord.type1CorrMet);
+        mpTree->SetBranchAddress("corrMet", mRecord.corrMet);
+    }
+    vectorBranch(create, "passBits", mRecord.passBits, mlBoolAddresses);
+    vectorBranch(create, "muons", mRecord.muons, mlIntAddresses);
+    vectorBranch(create, "looseMuons", mRecord.looseMuons, mlIntAddresses);
+    vectorBranch(create, "allMuons", mRecord.allMuons, mlIntAddresses);
+    vectorBranch(create, "electrons", mRecord.electrons, mlIntAddresses);
+    vectorBranch(create, "looseElectrons", mRecord.looseElectrons, mlIntAddresses);
+    vectorBranch(create, "allElectrons", mRecord.allElectrons, mlIntAddresses);
+    vectorBranch(create, "jets", mRecord.jets, mlIntAddresses);
+    vectorBranch(create, "looseJets", mRecord.looseJets, mlIntAddresses);
+    vectorBranch(create, "allJets", mRecord.allJets, mlIntAddresses);
+    vectorBranch(create, "bJets", mRecord.bJets, mlIntAddresses);
+    vectorBranch(create, "pvs", mRecord.pvs, mlIntAddresses);
+    vectorBranch(create, "triggers", mRecord.triggers, mlIntAddresses);
+    vectorBranch(create, "corrJetPx", mRecord.corrJetPx, mlDoubleAddresses);
+    vectorBranch(create, "corrJetPy", mRecord.corrJetPy, mlDoubleAddresses);
+    vectorBranch(create, "corrJetPz", mRecord.corrJetPz, mlDoubleAddresses);
+    vectorBranch(create, "corrJetE", mRecord.corrJetE, mlDoubleAddresses);
+    vectorBranch(create, "corrJetBTag", mRecord.corrJetBTag, mlBoolAddresses);
+}
+
+template <class T>
+void LjmetSelectionCache::vectorBranch(bool create, char const * name, std::vector<T> & value, std::list<std::vector<T>*> & addresses)
+{
+    addresses.push_back(&value);
+    if (create) mpTree->Branch(name, &addresses.back());
+    else mpTree->SetBranchAddress(name, &addresses.back());
+}
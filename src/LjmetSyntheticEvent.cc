@@ -0,0 +1,463 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <typeinfo>
+
+#include "DataFormats/Common/interface/FunctorHandleExceptionFactory.h"
+#include "DataFormats/Common/interface/HLTGlobalStatus.h"
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
+#include "DataFormats/JetReco/interface/PFJet.h"
+#include "DataFormats/Math/interface/LorentzVector.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include "DataFormats/METReco/interface/MET.h"
+#include "DataFormats/MuonReco/interface/Muon.h"
+#include "DataFormats/PatCandidates/interface/Electron.h"
+#include "DataFormats/PatCandidates/interface/Jet.h"
+#include "DataFormats/PatCandidates/interface/JetCorrFactors.h"
+#include "DataFormats/PatCandidates/interface/MET.h"
+#include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/PatCandidates/interface/PackedCandidate.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/TypeID.h"
+#include "LJMet/Com/interface/LjmetSyntheticEvent.h"
+
+namespace {
+    reco::Candidate::LorentzVector ptEtaPhiM(double pt, double eta, double phi, double m) {
+        return reco::Candidate::LorentzVector(math::PtEtaPhiMLorentzVector(pt, eta, phi, m));
+    }
+
+    std::string productKey(edm::InputTag const & tag) { return tag.label() + ":" + tag.instance(); }
+
+    int threeCharge(int pdgId) {
+        int const _id = std::abs(pdgId);
+        int _charge = 0;
+        if (_id == 2 || _id == 4 || _id == 6) _charge = 2;
+        else if (_id == 1 || _id == 3 || _id == 5) _charge = -1;
+        else if (_id == 11 || _id == 13 || _id == 15) _charge = -3;
+        else if (_id == 24 || _id == 211) _charge = 3;
+        return pdgId < 0 ? -_charge : _charge;
+    }
+
+    /// gen particle with links to and from its mother, -1 for none
+    void addGenParticle(reco::GenParticleCollection & particles, int pdgId, int status, reco::Candidate::LorentzVector const & p4, int mother) {
+        particles.push_back(reco::GenParticle(threeCharge(pdgId), p4, reco::Candidate::Point(0.0, 0.0, 0.0), pdgId, status, false));
+        if (mother < 0) return;
+        particles.back().addMother(reco::GenParticleRef(&particles, mother));
+        particles[mother].addDaughter(reco::GenParticleRef(&particles, particles.size() - 1));
+    }
+
+    /// exception of a failed getByLabel, made only when the handle is used
+    class ProductNotFound {
+    public:
+        ProductNotFound(std::type_info const & type, edm::InputTag const & tag): mType(type), mTag(tag) { }
+        std::shared_ptr<cms::Exception> operator()() const {
+            std::shared_ptr<cms::Exception> _whyFailed(new edm::Exception(edm::errors::ProductNotFound));
+            *_whyFailed << "getByLabel: the synthetic event has no such product\n"
+                        << "Looking for type: " << mType << "\n"
+                        << "Looking for module label: " << mTag.label() << "\n"
+                        << "Looking for productInstanceName: " << mTag.instance() << "\n";
+            return _whyFailed;
+        }
+    private:
+        edm::TypeID mType;
+        edm::InputTag mTag;
+    };
+}
+
+
+
+LjmetSyntheticEvent::LjmetSyntheticEvent(edm::ParameterSet const & par):
+mLegend("[LjmetSyntheticEvent]: "),
+mSeed(par.exists("seed") ? par.getUntrackedParameter<unsigned int>("seed") : 1),
+mIsMc(par.exists("isMc") ? par.getUntrackedParameter<bool>("isMc") : true),
+mMeanVertices(par.exists("vertices") ? par.getUntrackedParameter<double>("vertices") : 20.0),
+mMeanMuons(par.exists("muons") ? par.getUntrackedParameter<double>("muons") : 0.7),
+mMeanElectrons(par.exists("electrons") ? par.getUntrackedParameter<double>("electrons") : 0.7),
+mMeanJets(par.exists("jets") ? par.getUntrackedParameter<double>("jets") : 6.0),
+mMeanConstituents(par.exists("constituents") ? par.getUntrackedParameter<double>("constituents") : 25.0),
+mBJetFraction(par.exists("bJetFraction") ? par.getUntrackedParameter<double>("bJetFraction") : 0.25),
+mFatJetMinPt(par.exists("fatJetMinPt") ? par.getUntrackedParameter<double>("fatJetMinPt") : 150.0),
+mMeanMet(par.exists("met") ? par.getUntrackedParameter<double>("met") : 40.0),
+mMeanGenParticles(par.exists("genParticles") ? par.getUntrackedParameter<double>("genParticles") : 100.0),
+mTriggerEfficiency(par.exists("triggerEfficiency") ? par.getUntrackedParameter<double>("triggerEfficiency") : 0.9),
+mVertexTag(par.exists("vertexCollection") ? par.getUntrackedParameter<edm::InputTag>("vertexCollection") : edm::InputTag("offlineSlimmedPrimaryVertices")),
+mPackedTag(par.exists("packedCollection") ? par.getUntrackedParameter<edm::InputTag>("packedCollection") : edm::InputTag("packedPFCandidates")),
+mMuonTag(par.exists("muonCollection") ? par.getUntrackedParameter<edm::InputTag>("muonCollection") : edm::InputTag("slimmedMuons")),
+mElectronTag(par.exists("electronCollection") ? par.getUntrackedParameter<edm::InputTag>("electronCollection") : edm::InputTag("slimmedElectrons")),
+mJetTag(par.exists("jetCollection") ? par.getUntrackedParameter<edm::InputTag>("jetCollection") : edm::InputTag("slimmedJets")),
+mFatJetTag(par.exists("fatJetCollection") ? par.getUntrackedParameter<edm::InputTag>("fatJetCollection") : edm::InputTag("slimmedJetsAK8")),
+mMetTag(par.exists("metCollection") ? par.getUntrackedParameter<edm::InputTag>("metCollection") : edm::InputTag("slimmedMETs")),
+mTriggerTag(par.exists("triggerCollection") ? par.getUntrackedParameter<edm::InputTag>("triggerCollection") : edm::InputTag("TriggerResults::HLT")),
+mTriggerObjectTag(par.exists("triggerObjectCollection") ? par.getUntrackedParameter<edm::InputTag>("triggerObjectCollection") : edm::InputTag("selectedPatTrigger")),
+mGenParticleTag(par.exists("genParticleCollection") ? par.getUntrackedParameter<edm::InputTag>("genParticleCollection") : edm::InputTag("prunedGenParticles")),
+mGenJetTag(par.exists("genJetCollection") ? par.getUntrackedParameter<edm::InputTag>("genJetCollection") : edm::InputTag("slimmedGenJets")),
+mRhoTag(par.exists("rhoCollection") ? par.getUntrackedParameter<edm::InputTag>("rhoCollection") : edm::InputTag("fixedGridRhoAll"))
+{
+    if (par.exists("bTaggers")) mvBTaggers = par.getUntrackedParameter<std::vector<std::string> >("bTaggers");
+    else {
+        mvBTaggers.push_back("combinedInclusiveSecondaryVertexV2BJetTags");
+        mvBTaggers.push_back("combinedSecondaryVertexBJetTags");
+    }
+
+    std::vector<std::string> _paths;
+    if (par.exists("triggerPaths")) _paths = par.getUntrackedParameter<std::vector<std::string> >("triggerPaths");
+    else {
+        _paths.push_back("HLT_IsoMu24_eta2p1_IterTrk02_v1");
+        _paths.push_back("HLT_Ele32_eta2p1_WP85_Gsf_v1");
+    }
+    mTriggerPSet.addParameter<std::vector<std::string> >("@trigger_paths", _paths);
+    mTriggerPSet.registerIt();
+    mTriggerNames = edm::TriggerNames(mTriggerPSet);
+
+    std::cout << mLegend << "generating events with on average " << mMeanMuons << " muons, "
+              << mMeanElectrons << " electrons, " << mMeanJets << " jets of " << mMeanConstituents << " constituents, "
+              << mMeanVertices << " vertices" << std::endl;
+}
+
+LjmetSyntheticEvent::~LjmetSyntheticEvent()
+{
+    clear();
+}
+
+template <class T>
+T & LjmetSyntheticEvent::put(edm::InputTag const & tag)
+{
+    edm::Wrapper<T> * _wrapper = new edm::Wrapper<T>(std::auto_ptr<T>(new T()));
+    edm::WrapperBase * & _product = mProducts[productKey(tag)];
+    delete _product;
+    _product = _wrapper;
+
+    // filled in place, so that references into the product stay valid
+    return const_cast<T &>(*_wrapper->product());
+}
+
+void LjmetSyntheticEvent::clear()
+{
+    for (std::map<std::string, edm::WrapperBase *>::iterator _product = mProducts.begin(); _product != mProducts.end(); ++_product) {
+        delete _product->second;
+    }
+    mProducts.clear();
+}
+
+void LjmetSyntheticEvent::Generate(Long64_t entry)
+{
+    clear();
+
+    // TRandom3 takes seed 0 for a random seed
+    mRandom.SetSeed(mSeed + (UInt_t)entry + 1);
+    mAux = edm::EventAuxiliary(edm::EventID(1, 1 + entry/1000, entry + 1), "", edm::Timestamp(), !mIsMc);
+
+    std::vector<reco::Vertex> & _vertices = put<std::vector<reco::Vertex> >(mVertexTag);
+    generateVertices(_vertices);
+
+    std::vector<pat::PackedCandidate> & _packed = put<std::vector<pat::PackedCandidate> >(mPackedTag);
+    std::vector<pat::Jet> & _jets = put<std::vector<pat::Jet> >(mJetTag);
+    generateJets(_vertices, _packed, _jets);
+    generateFatJets(_jets, put<std::vector<pat::Jet> >(mFatJetTag));
+
+    std::vector<pat::Muon> & _muons = put<std::vector<pat::Muon> >(mMuonTag);
+    std::vector<pat::Electron> & _electrons = put<std::vector<pat::Electron> >(mElectronTag);
+    generateLeptons(_vertices, _muons, _electrons);
+
+    generateMet(_vertices, _jets, _muons, _electrons, put<std::vector<pat::MET> >(mMetTag));
+    generateTrigger(put<edm::TriggerResults>(mTriggerTag));
+    put<pat::TriggerObjectStandAloneCollection>(mTriggerObjectTag);
+
+    // pileup energy density grows with the number of vertices
+    put<double>(mRhoTag) = std::max(0.0, 0.5*_vertices.size() + mRandom.Gaus(0.0, 1.0));
+
+    if (mIsMc) {
+        generateGenParticles(put<reco::GenParticleCollection>(mGenParticleTag));
+        generateGenJets(_jets, put<reco::GenJetCollection>(mGenJetTag));
+    }
+}
+
+edm::TriggerResultsByName LjmetSyntheticEvent::triggerResultsByName(std::string const & process) const
+{
+    edm::TriggerResults const * _results = 0;
+    std::map<std::string, edm::WrapperBase *>::const_iterator _product = mProducts.find(productKey(mTriggerTag));
+    if (_product != mProducts.end()) _results = static_cast<edm::Wrapper<edm::TriggerResults> const *>(_product->second)->product();
+    return edm::TriggerResultsByName(_results, _results ? &mTriggerNames : 0);
+}
+
+edm::BasicHandle LjmetSyntheticEvent::getByLabelImpl(std::type_info const & iWrapperType, std::type_info const & iProductType, edm::InputTag const & iTag) const
+{
+    // the process name is not checked, there is only one of every label
+    std::map<std::string, edm::WrapperBase *>::const_iterator _product = mProducts.find(productKey(iTag));
+    if (_product == mProducts.end() || typeid(*_product->second) != iWrapperType) {
+        return edm::BasicHandle(edm::makeHandleExceptionFactory(ProductNotFound(iProductType, iTag)));
+    }
+    return edm::BasicHandle(_product->second, &mProvenance);
+}
+
+edm::BasicHandle LjmetSyntheticEvent::getImpl(std::type_info const & iProductType, edm::ProductID const & iID) const
+{
+    // products have no ProductID, references between them are transient
+    return edm::BasicHandle(edm::makeHandleExceptionFactory(ProductNotFound(iProductType, edm::InputTag())));
+}
+
+void LjmetSyntheticEvent::generateVertices(std::vector<reco::Vertex> & vertices)
+{
+    int const _n = std::max(1, mRandom.Poisson(mMeanVertices));
+    vertices.reserve(_n);
+    for (int i = 0; i < _n; ++i) {
+        reco::Vertex::Point const _position(mRandom.Gaus(0.0, 0.002), mRandom.Gaus(0.0, 0.002), mRandom.Gaus(0.0, 4.5));
+        reco::Vertex::Error _error;
+        _error(0, 0) = 1.e-6;
+        _error(1, 1) = 1.e-6;
+        _error(2, 2) = 1.e-4;
+
+        // the hard interaction first, with the most tracks
+        int const _tracks = (i == 0) ? 40 + mRandom.Poisson(40.0) : 2 + mRandom.Poisson(15.0);
+        double const _ndof = 2.0*_tracks - 3.0;
+        vertices.push_back(reco::Vertex(_position, _error, _ndof*mRandom.Uniform(0.8, 1.2), _ndof, _tracks));
+    }
+}
+
+void LjmetSyntheticEvent::generateJets(std::vector<reco::Vertex> const & vertices, std::vector<pat::PackedCandidate> & packed, std::vector<pat::Jet> & jets)
+{
+    int const _n = mRandom.Poisson(mMeanJets);
+    std::vector<double> _pt(_n);
+    std::vector<int> _nConstituents(_n);
+    int _total = 0;
+    for (int i = 0; i < _n; ++i) {
+        _pt[i] = 20.0 + mRandom.Exp(50.0);
+        _nConstituents[i] = std::max(2, mRandom.Poisson(mMeanConstituents));
+        _total += _nConstituents[i];
+    }
+    std::sort(_pt.begin(), _pt.end(), std::greater<double>());
+
+    // jets point at their constituents, the collection must not be reallocated
+    packed.reserve(_total);
+    jets.reserve(_n);
+    reco::VertexRef const _pv(&vertices, 0);
+
+    for (int i = 0; i < _n; ++i) {
+        double const _eta = mRandom.Uniform(-4.7, 4.7);
+        double const _phi = mRandom.Uniform(-M_PI, M_PI);
+
+        std::vector<double> _share(_nConstituents[i]);
+        double _sum = 0.0;
+        for (int k = 0; k < _nConstituents[i]; ++k) {
+            _share[k] = mRandom.Exp(1.0);
+            _sum += _share[k];
+        }
+
+        // charged hadrons, photons and neutral hadrons around the jet axis
+        reco::PFJet::Specific _specific;
+        reco::Jet::Constituents _constituents;
+        reco::Candidate::LorentzVector _raw;
+        for (int k = 0; k < _nConstituents[i]; ++k) {
+            double const _type = mRandom.Uniform();
+            int _pdgId = 130;
+            double _mass = 0.0;
+            if (_type < 0.65) {
+                _pdgId = mRandom.Uniform() < 0.5 ? 211 : -211;
+                _mass = 0.1396;
+            }
+            else if (_type < 0.9) _pdgId = 22;
+
+            reco::Candidate::LorentzVector const _p4 = ptEtaPhiM(_pt[i]*_share[k]/_sum, _eta + mRandom.Gaus(0.0, 0.1), _phi + mRandom.Gaus(0.0, 0.1), _mass);
+            packed.push_back(pat::PackedCandidate(_p4, vertices[0].position(), _p4.phi(), _pdgId, _pv));
+            _constituents.push_back(reco::CandidatePtr(&packed.back(), packed.size() - 1));
+            _raw += _p4;
+
+            double const _energy = _p4.energy();
+            if (_pdgId == 22) {
+                _specific.mPhotonEnergy += _energy;
+                _specific.mNeutralEmEnergy += _energy;
+                ++_specific.mPhotonMultiplicity;
+                ++_specific.mNeutralMultiplicity;
+            }
+            else if (_pdgId == 130) {
+                _specific.mNeutralHadronEnergy += _energy;
+                ++_specific.mNeutralHadronMultiplicity;
+                ++_specific.mNeutralMultiplicity;
+            }
+            else {
+                _specific.mChargedHadronEnergy += _energy;
+                ++_specific.mChargedHadronMultiplicity;
+                ++_specific.mChargedMultiplicity;
+            }
+        }
+
+        reco::PFJet _pfJet(_raw, vertices[0].position(), _specific, _constituents);
+        _pfJet.setJetArea(0.5);
+        pat::Jet _jet(_pfJet);
+
+        // cumulative correction factors of the raw jet, corrected to L3
+        double const _l1 = 0.92;
+        double const _l2 = mRandom.Gaus(1.08, 0.03);
+        std::vector<pat::JetCorrFactors::CorrectionFactor> _jec;
+        _jec.push_back(pat::JetCorrFactors::CorrectionFactor("Uncorrected", std::vector<float>(1, 1.0)));
+        _jec.push_back(pat::JetCorrFactors::CorrectionFactor("L1FastJet", std::vector<float>(1, _l1)));
+        _jec.push_back(pat::JetCorrFactors::CorrectionFactor("L2Relative", std::vector<float>(1, _l1*_l2)));
+        _jec.push_back(pat::JetCorrFactors::CorrectionFactor("L3Absolute", std::vector<float>(1, _l1*_l2)));
+        _jet.addJECFactors(pat::JetCorrFactors("patJetCorrFactors", _jec));
+        _jet.initializeJEC(3);
+
+        bool const _bJet = mRandom.Uniform() < mBJetFraction;
+        _jet.setPartonFlavour(_bJet ? 5 : (mRandom.Uniform() < 0.7 ? 1 : 21));
+        double const _tail = std::min(1.0, mRandom.Exp(0.15));
+        float const _discriminator = _bJet ? 1.0 - _tail : _tail;
+        for (unsigned int t = 0; t < mvBTaggers.size(); ++t) {
+            _jet.addBDiscriminatorPair(std::make_pair(mvBTaggers[t], _discriminator));
+        }
+
+        jets.push_back(_jet);
+    }
+}
+
+void LjmetSyntheticEvent::generateFatJets(std::vector<pat::Jet> const & jets, std::vector<pat::Jet> & fatJets)
+{
+    for (unsigned int i = 0; i < jets.size(); ++i) {
+        if (jets[i].pt() < mFatJetMinPt) continue;
+
+        pat::Jet _fatJet(jets[i]);
+        for (unsigned int j = 0; j < jets.size(); ++j) {
+            if (j == i || reco::deltaR(jets[i], jets[j]) > 0.8) continue;
+            _fatJet.setP4(_fatJet.p4() + jets[j].p4());
+            for (unsigned int k = 0; k < jets[j].numberOfDaughters(); ++k) _fatJet.addDaughter(jets[j].daughterPtr(k));
+        }
+        fatJets.push_back(_fatJet);
+    }
+}
+
+void LjmetSyntheticEvent::generateLeptons(std::vector<reco::Vertex> const & vertices, std::vector<pat::Muon> & muons, std::vector<pat::Electron> & electrons)
+{
+    reco::Candidate::Point const _vertex = vertices[0].position();
+
+    std::vector<double> _pt(mRandom.Poisson(mMeanMuons));
+    for (unsigned int i = 0; i < _pt.size(); ++i) _pt[i] = 20.0 + mRandom.Exp(35.0);
+    std::sort(_pt.begin(), _pt.end(), std::greater<double>());
+    muons.reserve(_pt.size());
+    for (unsigned int i = 0; i < _pt.size(); ++i) {
+        reco::Muon _muon(mRandom.Uniform() < 0.5 ? 1 : -1, ptEtaPhiM(_pt[i], mRandom.Uniform(-2.4, 2.4), mRandom.Uniform(-M_PI, M_PI), 0.10566), _vertex);
+        _muon.setType(reco::Muon::GlobalMuon | reco::Muon::TrackerMuon | reco::Muon::PFMuon);
+        pat::Muon _patMuon(_muon);
+
+        // mostly isolated
+        _patMuon.setIsolation(pat::PfChargedHadronIso, mRandom.Exp(0.03*_pt[i]));
+        _patMuon.setIsolation(pat::PfNeutralHadronIso, mRandom.Exp(0.01*_pt[i]));
+        _patMuon.setIsolation(pat::PfGammaIso, mRandom.Exp(0.01*_pt[i]));
+        _patMuon.setIsolation(pat::PfPUChargedHadronIso, mRandom.Exp(0.02*_pt[i]));
+        muons.push_back(_patMuon);
+    }
+
+    _pt.resize(mRandom.Poisson(mMeanElectrons));
+    for (unsigned int i = 0; i < _pt.size(); ++i) _pt[i] = 20.0 + mRandom.Exp(35.0);
+    std::sort(_pt.begin(), _pt.end(), std::greater<double>());
+    electrons.reserve(_pt.size());
+    for (unsigned int i = 0; i < _pt.size(); ++i) {
+        reco::Candidate::LorentzVector const _p4 = ptEtaPhiM(_pt[i], mRandom.Uniform(-2.5, 2.5), mRandom.Uniform(-M_PI, M_PI), 0.000511);
+        reco::GsfElectron _electron;
+        _electron.setCharge(mRandom.Uniform() < 0.5 ? 1 : -1);
+        _electron.setP4(reco::GsfElectron::P4_COMBINATION, _p4, 0.02*_p4.energy(), true);
+        _electron.setVertex(_vertex);
+        pat::Electron _patElectron(_electron);
+        _patElectron.setEcalDrivenMomentum(_p4);
+        _patElectron.setPassConversionVeto(true);
+        electrons.push_back(_patElectron);
+    }
+}
+
+void LjmetSyntheticEvent::generateMet(std::vector<reco::Vertex> const & vertices, std::vector<pat::Jet> const & jets, std::vector<pat::Muon> const & muons, std::vector<pat::Electron> const & electrons, std::vector<pat::MET> & mets)
+{
+    double _sumEt = 0.0;
+    for (unsigned int i = 0; i < jets.size(); ++i) _sumEt += jets[i].et();
+    for (unsigned int i = 0; i < muons.size(); ++i) _sumEt += muons[i].et();
+    for (unsigned int i = 0; i < electrons.size(); ++i) _sumEt += electrons[i].et();
+
+    // a neutrino, smeared with the resolution of the visible energy
+    double const _pt = mRandom.Exp(mMeanMet);
+    double const _phi = mRandom.Uniform(-M_PI, M_PI);
+    double const _sigma = 2.0 + 0.5*std::sqrt(_sumEt);
+    double const _px = _pt*std::cos(_phi) + mRandom.Gaus(0.0, _sigma);
+    double const _py = _pt*std::sin(_phi) + mRandom.Gaus(0.0, _sigma);
+    double const _et = std::sqrt(_px*_px + _py*_py);
+
+    reco::MET const _met(_sumEt, reco::Candidate::LorentzVector(_px, _py, 0.0, _et), vertices[0].position());
+    mets.push_back(pat::MET(_met));
+}
+
+void LjmetSyntheticEvent::generateTrigger(edm::TriggerResults & results)
+{
+    edm::HLTGlobalStatus _status(mTriggerNames.size());
+    for (unsigned int i = 0; i < _status.size(); ++i) {
+        _status[i] = edm::HLTPathStatus(mRandom.Uniform() < mTriggerEfficiency ? edm::hlt::Pass : edm::hlt::Fail);
+    }
+    results = edm::TriggerResults(_status, mTriggerPSet.id());
+}
+
+void LjmetSyntheticEvent::generateGenParticles(reco::GenParticleCollection & particles)
+{
+    // t tbar -> W+ b W- bbar, W+ -> l+ nu, W- -> d ubar
+    double const _phi = mRandom.Uniform(-M_PI, M_PI);
+    reco::Candidate::LorentzVector const _top = ptEtaPhiM(mRandom.Exp(100.0), mRandom.Gaus(0.0, 1.5), _phi, 172.5);
+    reco::Candidate::LorentzVector const _antiTop = ptEtaPhiM(_top.pt()*mRandom.Uniform(0.5, 1.5), mRandom.Gaus(0.0, 1.5), _phi + M_PI, 172.5);
+    reco::Candidate::LorentzVector const _wPlus = ptEtaPhiM(0.6*_top.pt(), _top.eta() + mRandom.Gaus(0.0, 0.3), _top.phi() + mRandom.Gaus(0.0, 0.3), 80.4);
+    reco::Candidate::LorentzVector const _wMinus = ptEtaPhiM(0.6*_antiTop.pt(), _antiTop.eta() + mRandom.Gaus(0.0, 0.3), _antiTop.phi() + mRandom.Gaus(0.0, 0.3), 80.4);
+    reco::Candidate::LorentzVector const _lepton = mRandom.Uniform(0.2, 0.8)*_wPlus;
+    reco::Candidate::LorentzVector const _quark = mRandom.Uniform(0.2, 0.8)*_wMinus;
+    int const _leptonId = mRandom.Uniform() < 0.5 ? -13 : -11;
+
+    int const _n = mRandom.Poisson(mMeanGenParticles);
+    particles.reserve(10 + _n);
+    addGenParticle(particles, 6, 62, _top, -1);
+    addGenParticle(particles, -6, 62, _antiTop, -1);
+    addGenParticle(particles, 24, 22, _wPlus, 0);
+    addGenParticle(particles, 5, 23, _top - _wPlus, 0);
+    addGenParticle(particles, -24, 22, _wMinus, 1);
+    addGenParticle(particles, -5, 23, _antiTop - _wMinus, 1);
+    addGenParticle(particles, _leptonId, 1, _lepton, 2);
+    addGenParticle(particles, _leptonId == -13 ? 14 : 12, 1, _wPlus - _lepton, 2);
+    addGenParticle(particles, 1, 23, _quark, 4);
+    addGenParticle(particles, -2, 23, _wMinus - _quark, 4);
+
+    // stable particles of the underlying event
+    for (int i = 0; i < _n; ++i) {
+        double const _type = mRandom.Uniform();
+        int const _pdgId = _type < 0.35 ? 211 : (_type < 0.7 ? -211 : 22);
+        addGenParticle(particles, _pdgId, 1, ptEtaPhiM(mRandom.Exp(3.0), mRandom.Uniform(-5.0, 5.0), mRandom.Uniform(-M_PI, M_PI), _pdgId == 22 ? 0.0 : 0.1396), -1);
+    }
+}
+
+
+void LjmetSyntheticEvent::generateGenJets(std::vector<pat::Jet> const & jets, reco::GenJetCollection & genJets)
+{
+    genJets.reserve(jets.size());
+    for (unsigned int i = 0; i < jets.size(); ++i) {
+        reco::GenJet _genJet;
+        _genJet.setP4(std::max(0.0, mRandom.Gaus(1.0, 0.1))*jets[i].p4());
+        genJets.push_back(_genJet);
+    }
+}
+
+
+LjmetSyntheticEventSource::LjmetSyntheticEventSource(edm::ParameterSet const & par):
+mEvent(par),
+mEntries(par.exists("entries") ? par.getUntrackedParameter<int>("entries") : 100000),
+mEntry(0),
+mGenerated(false)
+{
+}
+
+bool LjmetSyntheticEventSource::To(Long64_t entry)
+{
+    mEntry = entry;
+    mGenerated = false;
+    return entry >= 0 && entry < mEntries;
+}
+
+edm::EventBase const & LjmetSyntheticEventSource::GetEvent()
+{
+    if (!mGenerated) {
+        mEvent.Generate(mEntry);
+        mGenerated = true;
+    }
+    return mEvent;
+}
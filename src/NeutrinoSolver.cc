@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cmath>
+
+#include "LJMet/Com/interface/NeutrinoSolver.h"
+
+
+
+namespace {
+
+  bool sameInput(const NeutrinoSolver::Input & a, const NeutrinoSolver::Input & b) {
+    return a.lepPx == b.lepPx && a.lepPy == b.lepPy && a.lepPz == b.lepPz && a.lepE == b.lepE
+      && a.metPx == b.metPx && a.metPy == b.metPy && a.metE == b.metE
+      && a.leptonMass == b.leptonMass && a.mW == b.mW;
+  }
+
+  // squared component of (x,y,z) perpendicular to (px,py,pz), as TVector3::Perp2(p)
+  double perp2(double x, double y, double z, double px, double py, double pz) {
+    double tot = px*px + py*py + pz*pz;
+    double ss = x*px + y*py + z*pz;
+    double per = x*x + y*y + z*z;
+    if (tot > 0.0) per -= ss*ss/tot;
+    if (per < 0) per = 0;
+    return per;
+  }
+
+}
+
+
+
+NeutrinoSolver::NeutrinoSolver():
+  memoUsed(0),
+  memoNext(0)
+{
+}
+
+
+
+NeutrinoSolver * NeutrinoSolver::GetInstance()
+{
+  static thread_local NeutrinoSolver instance;
+  return &instance;
+}
+
+
+
+NeutrinoSolver::Solution NeutrinoSolver::Solve(const Input & in)
+{
+  for (unsigned int i = 0; i < memoUsed; ++i) {
+    if (sameInput(in, memoInput[i])) return memoSolution[i];
+  }
+
+  unsigned int _slot = memoNext;
+  memoNext = (memoNext + 1) % memoSize;
+  if (memoUsed < memoSize) ++memoUsed;
+
+  memoInput[_slot] = in;
+  Compute(in, memoSolution[_slot]);
+  return memoSolution[_slot];
+}
+
+
+
+void NeutrinoSolver::Solve(unsigned int n, const Input * in, Solution * out)
+{
+  for (unsigned int i = 0; i < n; ++i) Compute(in[i], out[i]);
+}
+
+
+
+void NeutrinoSolver::Compute(const Input & in, Solution & out)
+{
+  double M_W  = in.mW;
+  double M_mu = in.leptonMass;
+  double emu  = in.lepE;
+  double pxmu = in.lepPx;
+  double pymu = in.lepPy;
+  double pzmu = in.lepPz;
+  double pxnu = in.metPx;
+  double pynu = in.metPy;
+
+  //
+  //_____ W mass constraint, as in METzCalculator ______________________
+  //
+  double a = M_W*M_W - M_mu*M_mu + 2.0*pxmu*pxnu + 2.0*pymu*pynu;
+  double A = 4.0*(emu*emu - pzmu*pzmu);
+  double B = -4.0*a*pzmu;
+  double C = 4.0*emu*emu*(pxnu*pxnu + pynu*pynu) - a*a;
+
+  double tmproot = B*B - 4.0*A*C;
+
+  out.ptNu[0] = -1;
+  out.ptNu[1] = -1;
+
+  if (tmproot < 0) {
+    out.isComplex = true;
+    double pznu = - B/(2*A); // take real part of complex roots
+    out.pz[0] = pznu;
+    out.pz[1] = pznu;
+    for (int p = 0; p < nPolicies; ++p) {
+      out.best[p] = pznu;
+      out.other[p] = pznu;
+    }
+
+    // recalculate the neutrino pT
+    // solve quadratic eq. discriminator = 0 for pT of nu
+    double pnu = in.metE;
+    double Delta = (M_W*M_W - M_mu*M_mu);
+    double alpha = (pxmu*pxnu/pnu + pymu*pynu/pnu);
+    double ptnu = std::sqrt( pxnu*pxnu + pynu*pynu);
+    double AA = 4.*pzmu*pzmu - 4*emu*emu + 4*alpha*alpha;
+    double BB = 4.*alpha*Delta;
+    double CC = Delta*Delta;
+
+    double tmpdisc = BB*BB - 4.0*AA*CC;
+    double tmpsolpt1 = (-BB + std::sqrt(tmpdisc))/(2.0*AA);
+    double tmpsolpt2 = (-BB - std::sqrt(tmpdisc))/(2.0*AA);
+
+    if ( std::fabs( tmpsolpt1 - ptnu ) < std::fabs( tmpsolpt2 - ptnu) ) { out.ptNu[0] = tmpsolpt1; out.ptNu[1] = tmpsolpt2; }
+    else { out.ptNu[0] = tmpsolpt2; out.ptNu[1] = tmpsolpt1; }
+  }
+  else {
+    out.isComplex = false;
+    double tmpsol1 = (-B + std::sqrt(tmproot))/(2.0*A);
+    double tmpsol2 = (-B - std::sqrt(tmproot))/(2.0*A);
+    out.pz[0] = tmpsol1;
+    out.pz[1] = tmpsol2;
+
+    // nearest to the lepton pz
+    bool _nearest2 = std::fabs(tmpsol2-pzmu) < std::fabs(tmpsol1-pzmu);
+    out.best[nearestLepton]  = _nearest2 ? tmpsol2 : tmpsol1;
+    out.other[nearestLepton] = _nearest2 ? tmpsol1 : tmpsol2;
+
+    // most central
+    bool _central1 = std::fabs(tmpsol1) < std::fabs(tmpsol2);
+    out.best[mostCentral]  = _central1 ? tmpsol1 : tmpsol2;
+    out.other[mostCentral] = _central1 ? tmpsol2 : tmpsol1;
+
+    // nearest to the lepton pz, unless that is above 300 GeV
+    if (out.best[nearestLepton] > 300.) {
+      out.best[nearestLeptonOrCentral]  = out.best[mostCentral];
+      out.other[nearestLeptonOrCentral] = out.other[mostCentral];
+    }
+    else {
+      out.best[nearestLeptonOrCentral]  = out.best[nearestLepton];
+      out.other[nearestLeptonOrCentral] = out.other[nearestLepton];
+    }
+
+    // largest cosine of the lepton in the W rest frame
+    double sinthcm1 = 2.*std::sqrt(perp2(pxmu, pymu, pzmu, pxmu+pxnu, pymu+pynu, pzmu+tmpsol1))/M_W;
+    double sinthcm2 = 2.*std::sqrt(perp2(pxmu, pymu, pzmu, pxmu+pxnu, pymu+pynu, pzmu+tmpsol2))/M_W;
+    double costhcm1 = std::sqrt(1. - sinthcm1*sinthcm1);
+    double costhcm2 = std::sqrt(1. - sinthcm2*sinthcm2);
+    bool _cos1 = costhcm1 > costhcm2;
+    out.best[maxCosine]  = _cos1 ? tmpsol1 : tmpsol2;
+    out.other[maxCosine] = _cos1 ? tmpsol2 : tmpsol1;
+  }
+
+  //
+  //_____ D0 style: rescale MET to mT = mW, massless lepton ____________
+  //
+  double Mw    = in.mW;
+  double nu_px = in.metPx;
+  double nu_py = in.metPy;
+  double nu_e  = std::sqrt(nu_px*nu_px + nu_py*nu_py);
+  double l_px  = in.lepPx;
+  double l_py  = in.lepPy;
+  double l_pz  = in.lepPz;
+  double l_pt  = std::sqrt(l_px*l_px + l_py*l_py);
+  double l_e   = in.lepE;
+  double Mt    = std::sqrt((l_pt+nu_e)*(l_pt+nu_e) -
+                           (l_px+nu_px)*(l_px+nu_px) -
+                           (l_py+nu_py)*(l_py+nu_py));
+  double _A;
+  out.mtScale = 1.0;
+  if (Mt<Mw) _A = Mw*Mw/2.;
+  else {
+    _A = Mt*Mt/2.;
+    double k = nu_e*l_pt - nu_px*l_px - nu_py*l_py;
+    k = (k == 0. ? 0.00001 : k);
+    out.mtScale = 0.5*Mw*Mw/k;
+    nu_px *= out.mtScale;
+    nu_py *= out.mtScale;
+    nu_e = std::sqrt(nu_px*nu_px + nu_py*nu_py);
+  }
+  double _B = nu_px*l_px + nu_py*l_py;
+  double _C = std::max(1. + nu_e*nu_e * (l_pz*l_pz - l_e*l_e) / ((_A+_B)*(_A+_B)), 0.);
+  _C = std::sqrt(_C);
+  double S1 = (-(_A+_B)*l_pz + (_A+_B)*l_e*_C) / (l_pz*l_pz - l_e*l_e);
+  double S2 = (-(_A+_B)*l_pz - (_A+_B)*l_e*_C) / (l_pz*l_pz - l_e*l_e);
+  out.mtPx = nu_px;
+  out.mtPy = nu_py;
+  out.mtPz[0] = std::fabs(S1) < std::fabs(S2) ? S1 : S2;
+  out.mtPz[1] = std::fabs(S1) < std::fabs(S2) ? S2 : S1;
+}
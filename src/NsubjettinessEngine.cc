@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cmath>
+
+#include "LJMet/Com/interface/NsubjettinessEngine.h"
+#include "fastjet/ClusterSequence.hh"
+
+namespace {
+
+    const double twopi = 2.0*M_PI;
+
+    // same as fastjet::PseudoJet for a zero four-vector
+    const double maxRap = 1e5;
+
+    // distance^2 in the rapidity-azimuth plane from one axis to all particles;
+    // branch-free so the compiler can vectorize it
+    void computeColumn(unsigned int n, const double * rap, const double * phi,
+                       double axRap, double axPhi, double * out)
+    {
+        for (unsigned int i = 0; i < n; ++i) {
+            double dRap = rap[i] - axRap;
+            double dPhi = std::fabs(phi[i] - axPhi);
+            dPhi = std::min(dPhi, twopi - dPhi);
+            out[i] = dRap*dRap + dPhi*dPhi;
+        }
+    }
+
+    double distanceSq(double rap1, double phi1, double rap2, double phi2)
+    {
+        double dRap = rap1 - rap2;
+        double dPhi = std::fabs(phi1 - phi2);
+        if (dPhi > M_PI) dPhi = twopi - dPhi;
+        return dRap*dRap + dPhi*dPhi;
+    }
+}
+
+NsubjettinessEngine::NsubjettinessEngine(AxesMode axes, double beta, double R0, double Rcutoff):
+mAxes(axes),
+mBeta(beta),
+mR0(R0),
+mRcutoff(Rcutoff),
+mPrecision(0.0001),
+mHalt(1000),
+mN(0),
+mTauDen(0.0),
+mNColumns(0)
+{
+}
+
+void NsubjettinessEngine::setParticles(const double * px, const double * py, const double * pz, const double * e, unsigned int n)
+{
+    mN = n;
+    mPt.resize(n);
+    mRap.resize(n);
+    mPhi.resize(n);
+    mPx.assign(px, px+n);
+    mPy.assign(py, py+n);
+    mPz.assign(pz, pz+n);
+    mMinDist2.resize(n);
+    mAssign.resize(n);
+    mWeight.resize(n);
+    mPseudoJets.clear();
+
+    // rapidity and phi exactly as fastjet defines them
+    double _ptSum = 0.0;
+    for (unsigned int i = 0; i < n; ++i) {
+        mPseudoJets.push_back(fastjet::PseudoJet(px[i], py[i], pz[i], e[i]));
+        mPt[i] = mPseudoJets[i].perp();
+        mRap[i] = mPseudoJets[i].rap();
+        mPhi[i] = mPseudoJets[i].phi();
+        _ptSum += mPt[i];
+    }
+    mTauDen = _ptSum*std::pow(mR0, mBeta);
+
+    mNColumns = 0;
+}
+
+const double * NsubjettinessEngine::distanceColumn(double rap, double phi)
+{
+    for (unsigned int k = 0; k < mNColumns; ++k) {
+        if (mColumnRap[k] == rap && mColumnPhi[k] == phi) return &mColumns[k*mN];
+    }
+    if (mColumns.size() < (mNColumns+1)*mN) mColumns.resize((mNColumns+1)*mN);
+    if (mColumnRap.size() < mNColumns+1) {
+        mColumnRap.resize(mNColumns+1);
+        mColumnPhi.resize(mNColumns+1);
+    }
+    mColumnRap[mNColumns] = rap;
+    mColumnPhi[mNColumns] = phi;
+    computeColumn(mN, &mRap[0], &mPhi[0], rap, phi, &mColumns[mNColumns*mN]);
+    ++mNColumns;
+    return &mColumns[(mNColumns-1)*mN];
+}
+
+void NsubjettinessEngine::assign(unsigned int nAxes, const double * axRap, const double * axPhi)
+{
+    // make sure all columns exist before taking pointers: the cache may grow
+    for (unsigned int k = 0; k < nAxes; ++k) distanceColumn(axRap[k], axPhi[k]);
+
+    const double * _col = distanceColumn(axRap[0], axPhi[0]);
+    std::copy(_col, _col+mN, mMinDist2.begin());
+    std::fill(mAssign.begin(), mAssign.end(), 0);
+    for (unsigned int k = 1; k < nAxes; ++k) {
+        _col = distanceColumn(axRap[k], axPhi[k]);
+        double * _min = &mMinDist2[0];
+        int * _idx = &mAssign[0];
+        int _k = (int)k;
+        for (unsigned int i = 0; i < mN; ++i) {
+            bool _closer = _col[i] < _min[i];
+            _min[i] = _closer ? _col[i] : _min[i];
+            _idx[i] = _closer ? _k : _idx[i];
+        }
+    }
+}
+
+double NsubjettinessEngine::tauValue() const
+{
+    double _num = 0.0;
+    if (mBeta == 1.0) {
+        for (unsigned int i = 0; i < mN; ++i) _num += mPt[i]*std::min(std::sqrt(mMinDist2[i]), mRcutoff);
+    }
+    else {
+        for (unsigned int i = 0; i < mN; ++i) _num += mPt[i]*std::pow(std::min(std::sqrt(mMinDist2[i]), mRcutoff), mBeta);
+    }
+    return _num/mTauDen;
+}
+
+void NsubjettinessEngine::minimizeAxes(unsigned int nAxes, double * axRap, double * axPhi, double * axMom)
+{
+    //
+    // k-means update steps as in UpdateAxesFast() of Njettiness.hh,
+    // iterated until the mean axis shift is below the precision
+    //
+    double _prec2 = mPrecision*mPrecision;
+    double _rcut2 = mRcutoff*mRcutoff;
+    unsigned int _nSeedColumns = 0;
+    double _cmp = 100.0;
+    int _h = 0;
+    while (_cmp > mPrecision && _h < mHalt) {
+        _cmp = 0.0;
+        ++_h;
+
+        // assignment step; only the seed columns (first step) stay
+        // in the cache, the moved axes are recomputed every step
+        if (_h > 1) mNColumns = _nSeedColumns;
+        assign(nAxes, axRap, axPhi);
+        if (_h == 1) _nSeedColumns = mNColumns;
+
+        // per-particle weight pt * dist^(beta-2)
+        const double * _d2 = &mMinDist2[0];
+        double * _w = &mWeight[0];
+        if (mBeta == 1.0) {
+            for (unsigned int i = 0; i < mN; ++i) _w[i] = mPt[i]/std::sqrt(_prec2 + _d2[i]);
+        }
+        else if (mBeta == 2.0) {
+            for (unsigned int i = 0; i < mN; ++i) _w[i] = mPt[i];
+        }
+        else if (mBeta == 0.0) {
+            for (unsigned int i = 0; i < mN; ++i) _w[i] = mPt[i]/(_prec2 + _d2[i]);
+        }
+        else {
+            for (unsigned int i = 0; i < mN; ++i) _w[i] = mPt[i]*std::pow(_prec2 + _d2[i], 0.5*mBeta - 1.0);
+        }
+        // particles outside the cutoff do not belong to any axis
+        for (unsigned int i = 0; i < mN; ++i) _w[i] = (_d2[i] > _rcut2) ? 0.0 : _w[i];
+
+        // update step, masked sums per axis
+        for (unsigned int k = 0; k < nAxes; ++k) {
+            int _k = (int)k;
+            double _oldPhi = axPhi[k];
+            double _sumRap = 0.0, _sumPhi = 0.0, _sumW = 0.0;
+            double _sumPx = 0.0, _sumPy = 0.0, _sumPz = 0.0;
+            for (unsigned int i = 0; i < mN; ++i) {
+                bool _mine = (mAssign[i] == _k) && (_d2[i] <= _rcut2);
+                double _wi = _mine ? _w[i] : 0.0;
+                double _dPhi = mPhi[i] - _oldPhi;
+                double _phi = mPhi[i];
+                _phi = (_dPhi > M_PI) ? _phi - twopi : _phi;
+                _phi = (_dPhi < -M_PI) ? _phi + twopi : _phi;
+                _sumRap += _wi*mRap[i];
+                _sumPhi += _wi*_phi;
+                _sumW += _wi;
+                _sumPx += _mine ? mPx[i] : 0.0;
+                _sumPy += _mine ? mPy[i] : 0.0;
+                _sumPz += _mine ? mPz[i] : 0.0;
+            }
+            if (_sumW == 0) continue; // no particles for this axis, keep the old one
+
+            double _newRap = _sumRap/_sumW;
+            double _newPhi = std::fmod(_sumPhi/_sumW + twopi, twopi);
+            _cmp += std::sqrt(distanceSq(_newRap, _newPhi, axRap[k], axPhi[k]));
+            axRap[k] = _newRap;
+            axPhi[k] = _newPhi;
+            axMom[k] = std::sqrt(_sumPx*_sumPx + _sumPy*_sumPy + _sumPz*_sumPz);
+        }
+        _cmp = _cmp/((double)nAxes);
+    }
+    mNColumns = _nSeedColumns;
+}
+
+void NsubjettinessEngine::GetTaus(unsigned int nMax,
+                                  const double * px, const double * py, const double * pz, const double * e,
+                                  unsigned int n,
+                                  double * tau)
+{
+    std::fill(tau, tau+nMax, 0.0);
+    if (n <= 1 || nMax == 0) return;
+
+    setParticles(px, py, pz, e, n);
+
+    // one clustering sequence provides the seeds for every N
+    fastjet::JetDefinition _jetDef(fastjet::kt_algorithm, M_PI/2.0, fastjet::E_scheme, fastjet::Best);
+    fastjet::ClusterSequence _clustSeq(mPseudoJets, _jetDef);
+
+    mAxRap.resize(nMax);
+    mAxPhi.resize(nMax);
+    mAxMom.resize(nMax);
+    double * _axRap = &mAxRap[0];
+    double * _axPhi = &mAxPhi[0];
+    double * _axMom = &mAxMom[0];
+    for (unsigned int nAxes = 1; nAxes <= nMax && nAxes < n; ++nAxes) {
+        std::vector<fastjet::PseudoJet> _seeds = _clustSeq.exclusive_jets((int)nAxes);
+        for (unsigned int k = 0; k < nAxes; ++k) {
+            _axRap[k] = _seeds[k].rap();
+            _axPhi[k] = _seeds[k].phi();
+            _axMom[k] = 0.0;
+        }
+
+        unsigned int _nSeedColumns = 0;
+        if (mAxes == onepass_kt_axes) {
+            minimizeAxes(nAxes, _axRap, _axPhi, _axMom);
+            _nSeedColumns = mNColumns;
+            // an axis that never collected any momentum becomes a null
+            // four-vector in Njettiness.hh, i.e. sits at the rapidity limit
+            for (unsigned int k = 0; k < nAxes; ++k) {
+                if (_axMom[k] == 0.0) {
+                    _axRap[k] = maxRap;
+                    _axPhi[k] = 0.0;
+                }
+            }
+        }
+
+        assign(nAxes, _axRap, _axPhi);
+        tau[nAxes-1] = tauValue();
+
+        // exclusive kt seeds of N+1 share N-1 axes with those of N,
+        // so keep the seed columns and drop those of minimized axes
+        if (mAxes == onepass_kt_axes) mNColumns = _nSeedColumns;
+    }
+}
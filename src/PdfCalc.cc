@@ -6,11 +6,13 @@
 
 
 
+#include <algorithm>
 #include <iostream>
 #include "LJMet/Com/interface/BaseCalc.h"
 #include "LJMet/Com/interface/LjmetFactory.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
 #include "LJMet/Com/interface/LjmetPdfWeightProducer.h"
+#include "LJMet/Com/interface/PdfWeightEngine.h"
 #include "SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h"
 
 class LjmetFactory;
@@ -43,20 +45,32 @@ class PdfCalc : public BaseCalc{
  private:
   
   LjmetPdfWeightProducer * pPdfWeights;
+  PdfWeightEngine * pPdfEngine;
   edm::InputTag pdfInfoTag_;
   bool reducedInfo_;
+  bool useGridInterpolation_;
   string defaultPdfSet_;
 
+  // preallocated weights for all members of all sets
+  std::vector<float> vPdfWeights_;
+  // weights of one set, reused from event to event
+  std::vector<double> vSetWeights_;
+
+  void saveWeights(std::string const & pdfName, std::vector<double> const & vWeights);
+
 
 };
 
 
 
-//static int reg = LjmetFactory::GetInstance()->Register(new PdfCalc(), "PdfCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<PdfCalc>, "PdfCalc", true);
 
 
 
-PdfCalc::PdfCalc(){
+PdfCalc::PdfCalc():
+  pPdfWeights(0),
+  pPdfEngine(0),
+  useGridInterpolation_(false){
 }
 
 
@@ -72,8 +86,22 @@ int PdfCalc::BeginJob()
  pdfInfoTag_ = mPset.getUntrackedParameter<edm::InputTag> ("PdfInfoTag", edm::InputTag("generator"));
  reducedInfo_= mPset.getUntrackedParameter<bool> ("reducedInfo",false);
 
+  // tabulated PDF members instead of member-by-member LHAPDF calls
+ useGridInterpolation_ = mPset.getUntrackedParameter<bool> ("useGridInterpolation",false);
+ if (useGridInterpolation_ && mPset.getUntrackedParameter<std::string> ("FixPOWHEG", "") != "") {
+   std::cout << mLegend << "FixPOWHEG is not supported with grid interpolation, using LHAPDF directly" << std::endl;
+   useGridInterpolation_ = false;
+ }
+
   // initialize
-  if (!reducedInfo_) {
+  if (!reducedInfo_ && useGridInterpolation_) {
+    pPdfEngine = new PdfWeightEngine(mPset);
+    pPdfEngine->beginJob();
+    vPdfWeights_.resize(pPdfEngine->GetNWeights());
+    unsigned int _nMax = 0;
+    for (unsigned int k=0; k!=pPdfEngine->GetNSets(); ++k) _nMax = std::max(_nMax, pPdfEngine->GetNMembers(k));
+    vSetWeights_.reserve(_nMax);
+  } else if (!reducedInfo_) {
     pPdfWeights = new LjmetPdfWeightProducer(mPset);
     pPdfWeights->beginJob();
   } else {
@@ -88,7 +116,10 @@ int PdfCalc::BeginJob()
 
 int PdfCalc::EndJob(){
 
-  if (!reducedInfo_) delete pPdfWeights;
+  if (!reducedInfo_) {
+    delete pPdfWeights;
+    delete pPdfEngine;
+  }
 
   return 0;
 }
@@ -130,6 +161,17 @@ int PdfCalc::AnalyzeEvent(edm::EventBase const & event,
     SetValue("pdf1", pdf1);
     SetValue("pdf2", pdf2);
 
+  } else if (useGridInterpolation_) {
+
+    // all members of all sets in one sweep
+    pPdfEngine->GetWeights(x1, id1, x2, id2, Q, &vPdfWeights_[0]);
+
+    for (unsigned int k=0; k!=pPdfEngine->GetNSets(); ++k){
+      std::vector<float>::const_iterator first = vPdfWeights_.begin() + pPdfEngine->GetOffset(k);
+      vSetWeights_.assign(first, first + pPdfEngine->GetNMembers(k));
+      saveWeights(pPdfEngine->GetShortName(k), vSetWeights_);
+    }
+
   } else {
 
     // use PDF weight producer to calculate vectors of weights
@@ -139,8 +181,31 @@ int PdfCalc::AnalyzeEvent(edm::EventBase const & event,
     // for each PDF set, save weights, averages etc.
     std::map<std::string,std::vector<double> >::const_iterator iPdf;
     for (iPdf=mPdfs.begin(); iPdf!=mPdfs.end(); ++iPdf){
-      std::string pdfName = iPdf->first;
-      std::vector<double> const & vWeights = iPdf->second;
+      saveWeights(iPdf->first, iPdf->second);
+    }
+    /*
+    // from example in wiki
+    edm::InputTag pdfWeightTag("pdfWeights:cteq66"); // or any other PDF set
+    edm::Handle<std::vector<double> > weightHandle;
+    event.getByLabel(pdfWeightTag, weightHandle);
+
+    std::vector<double> weights = (*weightHandle);
+    std::cout << "Event weight for central PDF:" << weights[0] << std::endl;
+    unsigned int nmembers = weights.size();
+    for (unsigned int j=1; j<nmembers; j+=2) {
+      std::cout << "Event weight for PDF variation +" << (j+1)/2 << ": " << weights[j] << std::endl;
+      std::cout << "Event weight for PDF variation -" << (j+1)/2 << ": " << weights[j+1] << std::endl;
+    }
+    */
+
+  }
+    
+  return 0;
+}
+
+
+
+void PdfCalc::saveWeights(std::string const & pdfName, std::vector<double> const & vWeights){
 
       // save the vector of weights
       SetValue("PdfWeightsVec_"+pdfName, vWeights);
@@ -164,25 +229,4 @@ int PdfCalc::AnalyzeEvent(edm::EventBase const & event,
       SetValue("PdfWeightPlus_"+pdfName, weight_plus);
       SetValue("PdfWeightMinus_"+pdfName, weight_minus);
       SetValue("PdfWeightAverage_"+pdfName, weight_average);
-
-
-    }
-    /*
-    // from example in wiki
-    edm::InputTag pdfWeightTag("pdfWeights:cteq66"); // or any other PDF set
-    edm::Handle<std::vector<double> > weightHandle;
-    event.getByLabel(pdfWeightTag, weightHandle);
-
-    std::vector<double> weights = (*weightHandle);
-    std::cout << "Event weight for central PDF:" << weights[0] << std::endl;
-    unsigned int nmembers = weights.size();
-    for (unsigned int j=1; j<nmembers; j+=2) {
-      std::cout << "Event weight for PDF variation +" << (j+1)/2 << ": " << weights[j] << std::endl;
-      std::cout << "Event weight for PDF variation -" << (j+1)/2 << ": " << weights[j+1] << std::endl;
-    }
-    */
-
-  }
-    
-  return 0;
 }
@@ -0,0 +1,233 @@
+/*
+  PDF weights for all members of all configured PDF sets in one sweep
+*/
+
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "LJMet/Com/interface/PdfWeightEngine.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+
+
+namespace LHAPDF {
+      void initPDFSet(int nset, const std::string& filename, int member=0);
+      int numberPDF(int nset);
+      void usePDFMember(int nset, int member);
+      double xfx(int nset, double x, double Q, int fl);
+      void xfx(int nset, double x, double Q, double* results);
+      double getXmin(int nset, int member);
+      double getXmax(int nset, int member);
+      double getQ2min(int nset, int member);
+      double getQ2max(int nset, int member);
+      void extrapolate(bool extrapolate=true);
+}
+
+
+
+namespace {
+
+  // flavours kept in the table: bbar..b, gluon in the middle
+  const int maxFlavour = 5;
+  const int nFlavours = 2*maxFlavour + 1;
+
+  // LHAPDF flavour code, gluon may come as 21
+  inline int lhapdfFlavour(int id) { return id == 21 ? 0 : id; }
+
+  // 4-point Lagrange weights on a uniform grid, t measured from the second point
+  inline void cubicWeights(double t, double * w) {
+    w[0] = -t*(t-1.0)*(t-2.0)/6.0;
+    w[1] = (t+1.0)*(t-1.0)*(t-2.0)/2.0;
+    w[2] = -(t+1.0)*t*(t-2.0)/2.0;
+    w[3] = (t+1.0)*t*(t-1.0)/6.0;
+  }
+
+  // first stencil point and weights for coordinate v on grid v0 + i*dv, i < n
+  inline int stencil(double v, double v0, double dv, int n, double * w) {
+    double _pos = (v - v0)/dv;
+    int _i = (int)std::floor(_pos) - 1;
+    _i = std::max(0, std::min(_i, n-4));
+    cubicWeights(_pos - (_i+1), w);
+    return _i;
+  }
+
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+PdfWeightEngine::PdfWeightEngine(const edm::ParameterSet& pset) :
+ pdfSetNames_(pset.getUntrackedParameter<std::vector<std::string> > ("PdfSetNames")),
+ nWeights_(0),
+ nX_(pset.getUntrackedParameter<int> ("PdfGridNX", 100)),
+ nQ_(pset.getUntrackedParameter<int> ("PdfGridNQ", 30)),
+ xMin_(pset.getUntrackedParameter<double> ("PdfGridXMin", 1.e-5)),
+ xMax_(pset.getUntrackedParameter<double> ("PdfGridXMax", 0.99)),
+ // default Q range starts above the b threshold, so no flavour kink gets interpolated
+ qMin_(pset.getUntrackedParameter<double> ("PdfGridQMin", 5.0)),
+ qMax_(pset.getUntrackedParameter<double> ("PdfGridQMax", 1.e4))
+{
+      // LHAPDF5 keeps at most 3 sets in memory
+      if (pdfSetNames_.size()>3) {
+            edm::LogWarning("") << pdfSetNames_.size() << " PDF sets requested on input. Using only the first 3 sets and ignoring the rest!!";
+            pdfSetNames_.erase(pdfSetNames_.begin()+3,pdfSetNames_.end());
+      }
+
+      for (unsigned int k=0; k<pdfSetNames_.size(); k++) {
+            size_t dot = pdfSetNames_[k].find_first_of('.');
+            size_t underscore = pdfSetNames_[k].find_first_of('_');
+            if (underscore<dot) {
+                  pdfShortNames_.push_back(pdfSetNames_[k].substr(0,underscore));
+            } else {
+                  pdfShortNames_.push_back(pdfSetNames_[k].substr(0,dot));
+            }
+      }
+
+      nX_ = std::max(nX_, 4);
+      nQ_ = std::max(nQ_, 4);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+PdfWeightEngine::~PdfWeightEngine(){}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void PdfWeightEngine::beginJob() {
+
+      for (unsigned int k=1; k<=pdfSetNames_.size(); k++) {
+            LHAPDF::initPDFSet(k,pdfSetNames_[k-1]);
+
+            unsigned int nweights = 1;
+            if (LHAPDF::numberPDF(k)>1) nweights += LHAPDF::numberPDF(k);
+            offsets_.push_back(nWeights_);
+            nMembers_.push_back(nweights);
+            nWeights_ += nweights;
+
+            // stay inside the validity range of every set
+            LHAPDF::usePDFMember(k,0);
+            xMin_ = std::max(xMin_, LHAPDF::getXmin(k,0));
+            xMax_ = std::min(xMax_, LHAPDF::getXmax(k,0));
+            qMin_ = std::max(qMin_, std::sqrt(LHAPDF::getQ2min(k,0)));
+            qMax_ = std::min(qMax_, std::sqrt(LHAPDF::getQ2max(k,0)));
+      }
+
+      uMin_ = std::log(xMin_/(1.0-xMin_));
+      du_ = (std::log(xMax_/(1.0-xMax_)) - uMin_)/(nX_-1);
+      lMin_ = std::log(qMin_);
+      dl_ = (std::log(qMax_) - lMin_)/(nQ_-1);
+
+      std::cout << "[PdfWeightEngine]: tabulating " << nWeights_ << " PDF members on "
+                << nX_ << "x" << nQ_ << " grid, x in [" << xMin_ << "," << xMax_ << "], Q in ["
+                << qMin_ << "," << qMax_ << "]" << std::endl;
+
+      table_.assign((size_t)nFlavours*nQ_*nX_*nWeights_, 0.0);
+      double _all[13];
+      for (unsigned int k=1; k<=pdfSetNames_.size(); k++) {
+            for (unsigned int i=0; i<nMembers_[k-1]; ++i) {
+                  LHAPDF::usePDFMember(k,i);
+                  unsigned int _member = offsets_[k-1] + i;
+                  for (int iq=0; iq<nQ_; ++iq) {
+                        double _q = std::exp(lMin_ + iq*dl_);
+                        for (int ix=0; ix<nX_; ++ix) {
+                              double _u = uMin_ + ix*du_;
+                              double _x = 1.0/(1.0 + std::exp(-_u));
+                              LHAPDF::xfx(k, _x, _q, _all);
+                              for (int f=0; f<nFlavours; ++f) {
+                                    table_[((size_t)(f*nQ_ + iq)*nX_ + ix)*nWeights_ + _member] = _all[f - maxFlavour + 6];
+                              }
+                        }
+                  }
+            }
+      }
+
+      xf1_.resize(nWeights_);
+      xf2_.resize(nWeights_);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+bool PdfWeightEngine::onGrid(double x, int id, double Q) const {
+      int _fl = lhapdfFlavour(id);
+      return x >= xMin_ && x <= xMax_ && Q >= qMin_ && Q <= qMax_
+            && _fl >= -maxFlavour && _fl <= maxFlavour;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void PdfWeightEngine::interpolate(double x, int id, double Q, double * xf) const {
+
+      double _wx[4], _wq[4];
+      int _ix = stencil(std::log(x/(1.0-x)), uMin_, du_, nX_, _wx);
+      int _iq = stencil(std::log(Q), lMin_, dl_, nQ_, _wq);
+      int _f = lhapdfFlavour(id) + maxFlavour;
+
+      std::fill(xf, xf+nWeights_, 0.0);
+      for (int b=0; b<4; ++b) {
+            for (int a=0; a<4; ++a) {
+                  double _w = _wq[b]*_wx[a];
+                  const float * _row = &table_[((size_t)(_f*nQ_ + _iq + b)*nX_ + _ix + a)*nWeights_];
+                  // all members of all sets in one contiguous sweep
+                  for (unsigned int m=0; m<nWeights_; ++m) xf[m] += _w*_row[m];
+            }
+      }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void PdfWeightEngine::fillWeights(const double * xf1, const double * xf2, float * weights) const {
+      for (unsigned int k=0; k<pdfSetNames_.size(); ++k) {
+            unsigned int _o = offsets_[k];
+            double _inv = 1.0/(xf1[_o]*xf2[_o]);
+            for (unsigned int i=0; i<nMembers_[k]; ++i) {
+                  weights[_o+i] = xf1[_o+i]*xf2[_o+i]*_inv;
+            }
+      }
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+bool PdfWeightEngine::GetWeights(double x1, int id1, double x2, int id2, double Q, float * weights) {
+
+      if (!onGrid(x1, id1, Q) || !onGrid(x2, id2, Q)) {
+            GetWeightsDirect(x1, id1, x2, id2, Q, weights);
+            return false;
+      }
+
+      interpolate(x1, id1, Q, &xf1_[0]);
+      interpolate(x2, id2, Q, &xf2_[0]);
+      fillWeights(&xf1_[0], &xf2_[0], weights);
+
+      return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void PdfWeightEngine::GetWeightsDirect(double x1, int id1, double x2, int id2, double Q, float * weights) {
+
+      for (unsigned int k=1; k<=pdfSetNames_.size(); ++k) {
+            for (unsigned int i=0; i<nMembers_[k-1]; ++i) {
+                  LHAPDF::usePDFMember(k,i);
+                  xf1_[offsets_[k-1]+i] = LHAPDF::xfx(k, x1, Q, id1);
+                  xf2_[offsets_[k-1]+i] = LHAPDF::xfx(k, x2, Q, id2);
+            }
+      }
+      fillWeights(&xf1_[0], &xf2_[0], weights);
+}
@@ -0,0 +1,77 @@
+/*
+  Pileup weights for any number of data scenarios in one table
+*/
+
+
+#include <cstdlib>
+#include <iostream>
+
+#include "LJMet/Com/interface/PileUpWeightTable.h"
+
+
+
+namespace {
+
+  double sum(std::vector<double> const & v) {
+    double _s = 0.0;
+    for (unsigned int i=0; i<v.size(); ++i) _s += v[i];
+    return _s;
+  }
+
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+PileUpWeightTable::PileUpWeightTable() :
+  nBins_(0)
+{
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void PileUpWeightTable::SetMCDistribution(std::vector<double> const & mc) {
+  mc_ = mc;
+  nBins_ = mc.size();
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void PileUpWeightTable::AddScenario(std::string const & name, std::vector<double> const & data) {
+  if (data.size() != nBins_) {
+    std::cout << "[PileUpWeightTable]: data distribution " << name << " has " << data.size()
+              << " bins, MC distribution has " << nBins_ << ", exiting" << std::endl;
+    std::exit(-1);
+  }
+  names_.push_back(name);
+  data_.push_back(data);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void PileUpWeightTable::Initialize() {
+
+  // data/MC with both normalized to unit area, 0 where there is no MC
+  unsigned int _nCol = names_.size();
+  table_.assign((nBins_+1)*_nCol, 0.0);
+  double _mcNorm = sum(mc_);
+  for (unsigned int k=0; k<_nCol; ++k) {
+    double _dataNorm = sum(data_[k]);
+    for (unsigned int i=0; i<nBins_; ++i) {
+      if (mc_[i] == 0.0) continue;
+      table_[i*_nCol + k] = (data_[k][i]/_dataNorm)/(mc_[i]/_mcNorm);
+    }
+  }
+
+  std::cout << "[PileUpWeightTable]: " << _nCol << " pileup weight columns, "
+            << nBins_ << " nTrue bins" << std::endl;
+}
+
+
@@ -14,6 +14,7 @@
 #include "LJMet/Com/interface/BaseCalc.h"
 #include "LJMet/Com/interface/LjmetFactory.h"
 #include "LJMet/Com/interface/LjmetEventContent.h"
+#include "LJMet/Com/interface/NeutrinoSolver.h"
 #include "DataFormats/FWLite/interface/Record.h"
 #include "DataFormats/FWLite/interface/EventSetup.h"
 #include "DataFormats/FWLite/interface/ESHandle.h"
@@ -66,7 +67,7 @@ private:
 
 
 
-//static int reg = LjmetFactory::GetInstance()->Register(new StopCalc(), "StopCalc");
+//static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<StopCalc>, "StopCalc");
 
 
 
@@ -106,24 +107,26 @@ std::vector<double> StopCalc::GetNeutrinoPz(math::XYZTLorentzVector lv_mu,
     
     std::vector<double> pz(2, 0.0);
     
-    // lepton
-    double plx = lv_mu.px();
-    double ply = lv_mu.py();
-    double plz = lv_mu.pz();
-    double el  = lv_mu.E();
-    
-    // neutrino
-    double pnx = lv_met.px();
-    double pny = lv_met.py();
-    
-    double a = mMw*mMw/2.0+plx*pnx+ply*pny;
-    double b = el*el*(pnx*pnx+pny*pny);
-    double c = el*el-plz*plz;
-    double d = 1.0+c*(a*a-b)/a/a/plz/plz;
-    
-    if (d>=0){
-        pz[0]  = a*plz/c*(1+sqrt(d));
-        pz[1] = a*plz/c*(1-sqrt(d));
+    // massless lepton in the W mass constraint
+    NeutrinoSolver::Input _in;
+    _in.lepPx = lv_mu.px();
+    _in.lepPy = lv_mu.py();
+    _in.lepPz = lv_mu.pz();
+    _in.lepE  = lv_mu.E();
+    _in.metPx = lv_met.px();
+    _in.metPy = lv_met.py();
+    _in.metE  = lv_met.E();
+    _in.leptonMass = 0.0;
+    _in.mW = mMw;
+    
+    NeutrinoSolver::Solution _sol = NeutrinoSolver::GetInstance()->Solve(_in);
+    
+    if (!_sol.isComplex){
+        // first solution is a*plz/c*(1+sqrt(d)), a = mW^2/2 + pT(l).pT(nu)
+        double _a = mMw*mMw/2.0 + _in.lepPx*_in.metPx + _in.lepPy*_in.metPy;
+        bool _plusFirst = _a*_in.lepPz >= 0.0;
+        pz[0] = _plusFirst ? _sol.pz[0] : _sol.pz[1];
+        pz[1] = _plusFirst ? _sol.pz[1] : _sol.pz[0];
         
         success = 1;
     }
@@ -173,7 +173,7 @@ protected:
 
 
 // register plugin
-//static int reg = LjmetFactory::GetInstance()->Register(new TopDiLeptonEventSelector(), "DiLeptonSelector");
+//static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeSelector<TopDiLeptonEventSelector>, "DiLeptonSelector");
 
 
 
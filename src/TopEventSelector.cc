@@ -170,7 +170,7 @@ protected:
 
 
 // register plugin
-//static int reg = LjmetFactory::GetInstance()->Register(new TopEventSelector(), "TopSelector");
+//static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeSelector<TopEventSelector>, "TopSelector");
 
 
 
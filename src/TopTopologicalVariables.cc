@@ -13,22 +13,23 @@
  * Comments      : 
  */
 
-#include "TMatrixD.h"
 #include "TVectorD.h"
 #include "TRandom.h"
 
 #include "LJMet/Com/interface/TopTopologicalVariables.h"
 #include "LJMet/Com/interface/AnglesUtil.h"
+#include "LJMet/Com/interface/EventShapeUtils.h"
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
 
   /// Copy constructor
   TopTopologicalVariables::TopTopologicalVariables(const TopTopologicalVariables& that)
-    : _myobjects(that._myobjects)
+    : _myobjects(that._myobjects),
+      _pvOK(that._pvOK)
   {
-    _pv = 0;
-    if (that._pv) _pv = new TVectorD (*(that._pv));
+    std::copy(that._pv, that._pv+3, _pv);
   }
 
   /// Asignment operator
@@ -37,8 +38,8 @@ using namespace std;
     if (this != &that)
       {
 	_myobjects = that._myobjects;
-	if (_pv) delete _pv;
-	if (that._pv) _pv = new TVectorD (*(that._pv));
+	_pvOK = that._pvOK;
+	std::copy(that._pv, that._pv+3, _pv);
       }
     return *this;
   }
@@ -46,7 +47,6 @@ using namespace std;
   /// destructor
   TopTopologicalVariables::~TopTopologicalVariables()
   {
-    if (_pv) delete _pv;
   }
 
   /// this method returns the centrality of a group of objects
@@ -59,65 +59,56 @@ using namespace std;
     double TopTopologicalVariables::Aplanarity() const 
     {
       ensurePV();
-      return 1.5 * (*_pv)[2]; // alternative syntax: ... * _pv->operator[](2)
+      return 1.5 * _pv[2];
     } // Aplanarity()
   
   /// this method returns the sphericity of a group of objects
   double TopTopologicalVariables::Sphericity() const
   {
     ensurePV();
-    return 1.5 * ( (*_pv)[2] + (*_pv)[1] );
+    return 1.5 * ( _pv[2] + _pv[1] );
   } // Sphericity()
     
   /// this method returns the C of a group of objects (~momentum elipsiod surface area)
   double TopTopologicalVariables::C() const
   {
     ensurePV();
-    return 3 * ( (*_pv)[0] * (*_pv)[1] + (*_pv)[0] * (*_pv)[2] + (*_pv)[1] * (*_pv)[2]);
+    return 3 * ( _pv[0] * _pv[1] + _pv[0] * _pv[2] + _pv[1] * _pv[2]);
   } // C()
     
   /// this method returns the D of a group of objects (~momentum elipsiod volume)
   double TopTopologicalVariables::D() const
   {
     ensurePV();
-    return 27 * (*_pv)[0] * (*_pv)[1] * (*_pv)[2];
+    return 27 * _pv[0] * _pv[1] * _pv[2];
   } // D()
     
     /// this method returns the Momentum Tensor Eigenvalues of a group of objects
     TVectorD TopTopologicalVariables::GetMomentumTensorEigenvalues() const
     {
       ensurePV ();
-      return *_pv; // implicit copy and cast
+      return TVectorD(3, _pv);
     } // GetMomentumTensorEigenvalues()
 
   /// internal method to prepare and cache the eigenvectors
   void TopTopologicalVariables::ensurePV () const
   {
-    if (_pv) return;
+    if (_pvOK) return;
 
-    TMatrixD MomentumTensor(3,3);
+    // stack-only momentum tensor and closed-form eigenvalues,
+    // sorted in descending order like TMatrixD::EigenVectors()
+    double MomentumTensor[EventShapeUtils::kNTensor];
+    double p2_sum;
+    EventShapeUtils::ResetMomentumTensor(MomentumTensor, p2_sum);
     
-    Double_t p2_sum=0.0;
+    // all _myobjects at once through the SoA accumulator
+    EventShapeUtils::AccumulateMomentumTensor(_myobjects, MomentumTensor, p2_sum);
     
-    // for each _myobjects:
-    for ( unsigned int k=0; k<_myobjects.size(); k++ ) {
-      
-      for ( int i=0; i<3; i++ ) // px, py, pz
-	for ( int j=0; j<3; j++ ) // px, py, pz
-	  MomentumTensor(i,j) += _myobjects[k][i]*_myobjects[k][j];
-      
-      // add the 3-momentum squared to the sum
-      p2_sum += _myobjects[k].Mag32();
-    } // Loop over _myobjects
-    
-      // Divide the sums with the p2 sum
-    if ( p2_sum != 0 )
-      for ( int i=0; i<3; i++ ) // px, py, pz
-	for ( int j=0; j<3; j++ ) // px, py, pz
-	  MomentumTensor(i,j) /= p2_sum;
+    // Divide the sums with the p2 sum
+    EventShapeUtils::NormalizeMomentumTensor(MomentumTensor, p2_sum);
     
-    _pv = new TVectorD (3);
-    MomentumTensor.EigenVectors(*_pv);
+    EventShapeUtils::SymmetricEigenvalues3x3(MomentumTensor, _pv);
+    _pvOK = true;
   }
 
   /// this method returns the  Pt of a group of objects
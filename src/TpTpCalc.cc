@@ -45,7 +45,7 @@ private:
 
 
 
-static int reg = LjmetFactory::GetInstance()->Register(new TpTpCalc(), "TpTpCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<TpTpCalc>, "TpTpCalc");
 
 
 
@@ -73,7 +73,7 @@ private:
 
 
 
-//static int reg = LjmetFactory::GetInstance()->Register(new WprimeCalc(), "WprimeCalc");
+//static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<WprimeCalc>, "WprimeCalc");
 
 
 
@@ -43,7 +43,6 @@ private:
 //    edm::InputTag             rhoSrc_it;
     edm::InputTag             triggerSummary_;
     edm::InputTag             triggerCollection_;
-    edm::InputTag             pvCollection_it;
     edm::InputTag             genParticles_it;
     edm::InputTag             genJets_it;
     std::vector<unsigned int> keepPDGID;
@@ -52,15 +51,19 @@ private:
 
     double rhoIso;
 
-    std::vector<reco::Vertex> goodPVs;
+    /// pvCollection, read here if set or if CommonCalc does not run
+    edm::InputTag             pvCollection_it;
+    bool                      pvFromProduct;
+    /// all PVs, no quality selection
+    std::vector<reco::Vertex> const * goodPVs;
     int findMatch(const reco::GenParticleCollection & genParticles, int idToMatch, double eta, double phi);
     double mdeltaR(double eta1, double phi1, double eta2, double phi2);
-    void fillMotherInfo(const reco::Candidate *mother, int i, vector <int> & momid, vector <int> & momstatus, vector<double> & mompt, vector<double> & mometa, vector<double> & momphi, vector<double> & momenergy);
+    void fillMotherInfo(const reco::Candidate *mother, int i, LjmetArenaVector<int> & momid, LjmetArenaVector<int> & momstatus, LjmetArenaVector<double> & mompt, LjmetArenaVector<double> & mometa, LjmetArenaVector<double> & momphi, LjmetArenaVector<double> & momenergy);
 
 
 };
 
-static int reg = LjmetFactory::GetInstance()->Register(new singleLepCalc(), "singleLepCalc");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeCalc<singleLepCalc>, "singleLepCalc");
 
 singleLepCalc::singleLepCalc()
 {
@@ -78,6 +81,8 @@ int singleLepCalc::BeginJob()
     if (mPset.exists("rhoSrc")) rhoSrc_ = mPset.getParameter<edm::InputTag>("rhoSrc");
     else                        rhoSrc_ = edm::InputTag("fixedGridRhoAll");
 
+    // an explicit pvCollection is kept, otherwise the PVs come from CommonCalc
+    pvFromProduct = !mPset.exists("pvCollection");
     if (mPset.exists("pvCollection")) pvCollection_it = mPset.getParameter<edm::InputTag>("pvCollection");
     else                              pvCollection_it = edm::InputTag("offlineSlimmedPrimaryVertices");
 
@@ -126,11 +131,16 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
     int _nCorrBtagJets   = (int)vCorrBtagJets.size();
     int _nSelMuons       = (int)vSelMuons.size();
     int _nSelElectrons   = (int)vSelElectrons.size();
-    edm::Handle<std::vector<reco::Vertex> > pvHandle;
-    event.getByLabel(pvCollection_it, pvHandle);
-    goodPVs = *(pvHandle.product());
+    if (pvFromProduct && HasProduct("primaryVertices")) {
+        goodPVs = GetProduct<edm::Handle<std::vector<reco::Vertex> > >("primaryVertices").product();
+    }
+    else {
+        edm::Handle<std::vector<reco::Vertex> > pvHandle;
+        event.getByLabel(pvCollection_it, pvHandle);
+        goodPVs = pvHandle.product();
+    }
 
-    SetValue("nPV", (int)goodPVs.size());
+    SetValue("nPV", (int)goodPVs->size());
 
 
  
@@ -165,49 +175,49 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
    
     
     
-    std::vector <int> muCharge;
-    std::vector <int> muGlobal;
+    LjmetArenaVector<int> muCharge;
+    LjmetArenaVector<int> muGlobal;
     //Four vector
-    std::vector <double> muPt;
-    std::vector <double> muEta;
-    std::vector <double> muPhi;
-    std::vector <double> muEnergy;
+    LjmetArenaVector<double> muPt;
+    LjmetArenaVector<double> muEta;
+    LjmetArenaVector<double> muPhi;
+    LjmetArenaVector<double> muEnergy;
     //Quality criteria
-    std::vector <double> muChi2;
-    std::vector <double> muDxy;
-    std::vector <double> muDz;
-    std::vector <double> muRelIso;
-
-    std::vector <int> muNValMuHits;
-    std::vector <int> muNMatchedStations;
-    std::vector <int> muNValPixelHits;
-    std::vector <int> muNTrackerLayers;
+    LjmetArenaVector<double> muChi2;
+    LjmetArenaVector<double> muDxy;
+    LjmetArenaVector<double> muDz;
+    LjmetArenaVector<double> muRelIso;
+
+    LjmetArenaVector<int> muNValMuHits;
+    LjmetArenaVector<int> muNMatchedStations;
+    LjmetArenaVector<int> muNValPixelHits;
+    LjmetArenaVector<int> muNTrackerLayers;
     //Extra info about isolation
-    std::vector <double> muChIso;
-    std::vector <double> muNhIso;
-    std::vector <double> muGIso;
-    std::vector <double> muPuIso;
+    LjmetArenaVector<double> muChIso;
+    LjmetArenaVector<double> muNhIso;
+    LjmetArenaVector<double> muGIso;
+    LjmetArenaVector<double> muPuIso;
     //ID info
-    std::vector <int> muIsTight;
-    std::vector<int> muIsLoose;
+    LjmetArenaVector<int> muIsTight;
+    LjmetArenaVector<int> muIsLoose;
 
     //Generator level information -- MC matching
-    vector<double> muGen_Reco_dr;
-    vector<int> muPdgId;
-    vector<int> muStatus;
-    vector<int> muMatched;
-    vector<int> muNumberOfMothers;
-    vector<double> muMother_pt;
-    vector<double> muMother_eta;
-    vector<double> muMother_phi;
-    vector<double> muMother_energy;
-    vector<int> muMother_id;
-    vector<int> muMother_status;
+    LjmetArenaVector<double> muGen_Reco_dr;
+    LjmetArenaVector<int> muPdgId;
+    LjmetArenaVector<int> muStatus;
+    LjmetArenaVector<int> muMatched;
+    LjmetArenaVector<int> muNumberOfMothers;
+    LjmetArenaVector<double> muMother_pt;
+    LjmetArenaVector<double> muMother_eta;
+    LjmetArenaVector<double> muMother_phi;
+    LjmetArenaVector<double> muMother_energy;
+    LjmetArenaVector<int> muMother_id;
+    LjmetArenaVector<int> muMother_status;
     //Matched gen muon information:
-    vector<double> muMatchedPt;
-    vector<double> muMatchedEta;
-    vector<double> muMatchedPhi;
-    vector<double> muMatchedEnergy;
+    LjmetArenaVector<double> muMatchedPt;
+    LjmetArenaVector<double> muMatchedEta;
+    LjmetArenaVector<double> muMatchedPhi;
+    LjmetArenaVector<double> muMatchedEnergy;
 
     for (std::vector<edm::Ptr<pat::Muon> >::const_iterator imu = vSelMuons.begin(); imu != vSelMuons.end(); imu++) 
         //Protect against muons without tracks (should never happen, but just in case)
@@ -223,7 +233,7 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
             muPhi    . push_back((*imu)->phi());
             muEnergy . push_back((*imu)->energy());
 
-            muIsTight.push_back((*imu)->isTightMuon(goodPVs.at(0)));
+            muIsTight.push_back((*imu)->isTightMuon(goodPVs->at(0)));
             muIsLoose.push_back((*imu)->isLooseMuon());
 
             muGlobal.push_back(((*imu)->isGlobalMuon()<<2)+(*imu)->isTrackerMuon());
@@ -242,9 +252,9 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
             muGIso  . push_back(gIso);
             muPuIso . push_back(puIso);
             //IP: for some reason this is with respect to the first vertex in the collection
-            if (goodPVs.size() > 0){
-                muDxy . push_back((*imu)->muonBestTrack()->dxy(goodPVs.at(0).position()));
-                muDz  . push_back((*imu)->muonBestTrack()->dz(goodPVs.at(0).position()));
+            if (goodPVs->size() > 0){
+                muDxy . push_back((*imu)->muonBestTrack()->dxy(goodPVs->at(0).position()));
+                muDz  . push_back((*imu)->muonBestTrack()->dz(goodPVs->at(0).position()));
             } else {
                 muDxy . push_back(-999);
                 muDz  . push_back(-999);
@@ -335,55 +345,55 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
 
     // Electron
     //Four vector
-    std::vector <double> elPt;
-    std::vector <double> elEta;
-    std::vector <double> elPhi;
-    std::vector <double> elEnergy;
+    LjmetArenaVector<double> elPt;
+    LjmetArenaVector<double> elEta;
+    LjmetArenaVector<double> elPhi;
+    LjmetArenaVector<double> elEnergy;
 
     //Quality criteria
-    std::vector <double> elRelIso;
-    std::vector <double> elDxy;
-    std::vector <int>    elNotConversion;
-    std::vector <int>    elChargeConsistent;
-    std::vector <int>    elIsEBEE;
-    std::vector <int>    elCharge;
+    LjmetArenaVector<double> elRelIso;
+    LjmetArenaVector<double> elDxy;
+    LjmetArenaVector<int>    elNotConversion;
+    LjmetArenaVector<int>    elChargeConsistent;
+    LjmetArenaVector<int>    elIsEBEE;
+    LjmetArenaVector<int>    elCharge;
 
     //ID requirement
-    std::vector <double> elDeta;
-    std::vector <double> elDphi;
-    std::vector <double> elSihih;
-    std::vector <double> elHoE;
-    std::vector <double> elD0;
-    std::vector <double> elDZ;
-    std::vector <double> elOoemoop;
-    std::vector <int>    elMHits;
-    std::vector <int>    elVtxFitConv;    
+    LjmetArenaVector<double> elDeta;
+    LjmetArenaVector<double> elDphi;
+    LjmetArenaVector<double> elSihih;
+    LjmetArenaVector<double> elHoE;
+    LjmetArenaVector<double> elD0;
+    LjmetArenaVector<double> elDZ;
+    LjmetArenaVector<double> elOoemoop;
+    LjmetArenaVector<int>    elMHits;
+    LjmetArenaVector<int>    elVtxFitConv;    
 
     //Extra info about isolation
-    std::vector <double> elChIso;
-    std::vector <double> elNhIso;
-    std::vector <double> elPhIso;
-    std::vector <double> elAEff;
-    std::vector <double> elRhoIso;
+    LjmetArenaVector<double> elChIso;
+    LjmetArenaVector<double> elNhIso;
+    LjmetArenaVector<double> elPhIso;
+    LjmetArenaVector<double> elAEff;
+    LjmetArenaVector<double> elRhoIso;
 
     //mother-information
     //Generator level information -- MC matching
-    vector<double> elGen_Reco_dr;
-    vector<int> elPdgId;
-    vector<int> elStatus;
-    vector<int> elMatched;
-    vector<int> elNumberOfMothers;
-    vector<double> elMother_pt;
-    vector<double> elMother_eta;
-    vector<double> elMother_phi;
-    vector<double> elMother_energy;
-    vector<int> elMother_id;
-    vector<int> elMother_status;
+    LjmetArenaVector<double> elGen_Reco_dr;
+    LjmetArenaVector<int> elPdgId;
+    LjmetArenaVector<int> elStatus;
+    LjmetArenaVector<int> elMatched;
+    LjmetArenaVector<int> elNumberOfMothers;
+    LjmetArenaVector<double> elMother_pt;
+    LjmetArenaVector<double> elMother_eta;
+    LjmetArenaVector<double> elMother_phi;
+    LjmetArenaVector<double> elMother_energy;
+    LjmetArenaVector<int> elMother_id;
+    LjmetArenaVector<int> elMother_status;
     //Matched gen electron information:
-    vector<double> elMatchedPt;
-    vector<double> elMatchedEta;
-    vector<double> elMatchedPhi;
-    vector<double> elMatchedEnergy;
+    LjmetArenaVector<double> elMatchedPt;
+    LjmetArenaVector<double> elMatchedEta;
+    LjmetArenaVector<double> elMatchedPhi;
+    LjmetArenaVector<double> elMatchedEnergy;
 
  
     edm::Handle<double> rhoHandle;
@@ -427,9 +437,9 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
             elNotConversion.push_back(notConv);
 
             //IP: for some reason this is with respect to the first vertex in the collection
-            if(goodPVs.size() > 0){
-                elDxy.push_back((*iel)->gsfTrack()->dxy(goodPVs.at(0).position()));
-                elDZ.push_back((*iel)->gsfTrack()->dz(goodPVs.at(0).position()));
+            if(goodPVs->size() > 0){
+                elDxy.push_back((*iel)->gsfTrack()->dxy(goodPVs->at(0).position()));
+                elDZ.push_back((*iel)->gsfTrack()->dz(goodPVs->at(0).position()));
             } else {
                 elDxy.push_back(-999);
                 elDZ.push_back(-999);
@@ -580,12 +590,12 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
     event.getByLabel(AK8JetColl, AK8Jets);
 
     //Four vector
-    std::vector <double> AK8JetPt;
-    std::vector <double> AK8JetEta;
-    std::vector <double> AK8JetPhi;
-    std::vector <double> AK8JetEnergy;
+    LjmetArenaVector<double> AK8JetPt;
+    LjmetArenaVector<double> AK8JetEta;
+    LjmetArenaVector<double> AK8JetPhi;
+    LjmetArenaVector<double> AK8JetEnergy;
 
-    std::vector <double> AK8JetCSV;
+    LjmetArenaVector<double> AK8JetCSV;
     //   std::vector <double> AK8JetRCN;       
     for (std::vector<pat::Jet>::const_iterator ijet = AK8Jets->begin(); ijet != AK8Jets->end(); ijet++){
 
@@ -610,14 +620,14 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
     //   SetValue("AK8JetRCN"    , AK8JetRCN);
     //Get AK4 Jets
     //Four vector
-    std::vector <double> AK4JetPt;
-    std::vector <double> AK4JetEta;
-    std::vector <double> AK4JetPhi;
-    std::vector <double> AK4JetEnergy;
+    LjmetArenaVector<double> AK4JetPt;
+    LjmetArenaVector<double> AK4JetEta;
+    LjmetArenaVector<double> AK4JetPhi;
+    LjmetArenaVector<double> AK4JetEnergy;
 
-    std::vector <int>    AK4JetBTag;
-    std::vector <double> AK4JetBDisc;
-    std::vector <int>    AK4JetFlav;
+    LjmetArenaVector<int>    AK4JetBTag;
+    LjmetArenaVector<double> AK4JetBDisc;
+    LjmetArenaVector<int>    AK4JetFlav;
 
     //std::vector <double> AK4JetRCN;   
     double AK4HT =.0;
@@ -678,23 +688,23 @@ int singleLepCalc::AnalyzeEvent(edm::EventBase const & event, BaseEventSelector
     //
 
     //Four vector
-    std::vector <double> genPt;
-    std::vector <double> genEta;
-    std::vector <double> genPhi;
-    std::vector <double> genEnergy;
+    LjmetArenaVector<double> genPt;
+    LjmetArenaVector<double> genEta;
+    LjmetArenaVector<double> genPhi;
+    LjmetArenaVector<double> genEnergy;
 
     //Identity
-    std::vector <int> genID;
-    std::vector <int> genIndex;
-    std::vector <int> genStatus;
-    std::vector <int> genMotherID;
-    std::vector <int> genMotherIndex;
+    LjmetArenaVector<int> genID;
+    LjmetArenaVector<int> genIndex;
+    LjmetArenaVector<int> genStatus;
+    LjmetArenaVector<int> genMotherID;
+    LjmetArenaVector<int> genMotherIndex;
 
 
-    std::vector <double> genJetPt;
-    std::vector <double> genJetEta;
-    std::vector <double> genJetPhi;
-    std::vector <double> genJetEnergy;
+    LjmetArenaVector<double> genJetPt;
+    LjmetArenaVector<double> genJetEta;
+    LjmetArenaVector<double> genJetPhi;
+    LjmetArenaVector<double> genJetEnergy;
 
     if (isMc){
         edm::Handle<reco::GenParticleCollection> genParticles;
@@ -810,7 +820,7 @@ double singleLepCalc::mdeltaR(double eta1, double phi1, double eta2, double phi2
     return std::sqrt(deltaR2 (eta1, phi1, eta2, phi2));
 }
 
-void singleLepCalc::fillMotherInfo(const reco::Candidate *mother, int i, vector <int> & momid, vector <int> & momstatus, vector<double> & mompt, vector<double> & mometa, vector<double> & momphi, vector<double> & momenergy)
+void singleLepCalc::fillMotherInfo(const reco::Candidate *mother, int i, LjmetArenaVector<int> & momid, LjmetArenaVector<int> & momstatus, LjmetArenaVector<double> & mompt, LjmetArenaVector<double> & mometa, LjmetArenaVector<double> & momphi, LjmetArenaVector<double> & momenergy)
 {
     if(mother) {
         momid.push_back(mother->pdgId());
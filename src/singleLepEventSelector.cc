@@ -10,51 +10,14 @@
 
 #include <cmath>
 #include <iostream>
-#include <fstream>
-
-#include "TCanvas.h"
-#include "TFile.h"
-#include "TH1.h"
-#include "TH2.h"
-#include "TLegend.h"
-#include "TLorentzVector.h"
-#include "TROOT.h"
-#include "TSystem.h"
-#include "TTree.h"
-#include "TVector3.h"
-
-#include "DataFormats/Common/interface/TriggerResults.h"
-#include "DataFormats/Math/interface/deltaR.h"
-#include "DataFormats/PatCandidates/interface/Jet.h"
-#include "DataFormats/PatCandidates/interface/MET.h"
-#include "DataFormats/PatCandidates/interface/Tau.h"
-#include "DataFormats/PatCandidates/interface/TriggerObject.h"
-#include "FWCore/Common/interface/TriggerNames.h"
-//#include "PhysicsTools/SelectorUtils/interface/PFElectronSelector.h"
+
 #include "LJMet/Com/interface/TopElectronSelector.h"
-#include "PhysicsTools/SelectorUtils/interface/PFJetIDSelectionFunctor.h"
 #include "LJMet/Com/interface/PFMuonSelector.h"
-//#include "PhysicsTools/SelectorUtils/interface/PFMuonSelector.h"
-
-#include "PhysicsTools/SelectorUtils/interface/PVSelector.h"
-#include "PhysicsTools/SelectorUtils/interface/PVObjectSelector.h"
-#include "LJMet/Com/interface/BaseEventSelector.h"
+#include "LJMet/Com/interface/LjmetCutFlowSelector.h"
 #include "LJMet/Com/interface/LjmetFactory.h"
 
-#include "CondFormats/JetMETObjects/interface/JetCorrectionUncertainty.h"
-#include "JetMETCorrections/Objects/interface/JetCorrector.h"
-#include "JetMETCorrections/Objects/interface/JetCorrectionsRecord.h"
-#include "CondFormats/JetMETObjects/interface/JetCorrectorParameters.h"
-
-#include "PhysicsTools/CondLiteIO/interface/RecordWriter.h"
-#include "Cintex/Cintex.h"
-#include "PhysicsTools/JetMCUtils/interface/combination.h"
-
-
-using trigger::TriggerObject;
-
 
-class singleLepEventSelector : public BaseEventSelector {
+class singleLepEventSelector : public LjmetCutFlowSelector {
 
 public:
 
@@ -62,12 +25,6 @@ public:
     singleLepEventSelector();  
     ~singleLepEventSelector();
   
-  
-    // executes before loop over events
-    virtual void BeginJob(std::map<std::string, edm::ParameterSet const > par);
-
-    // main method where the cuts are applied
-    virtual bool operator()( edm::EventBase const & event, pat::strbitset & ret);
 
     virtual void AnalyzeEvent( edm::EventBase const & event, LjmetEventContent & ec );
     
@@ -82,47 +39,28 @@ public:
     boost::shared_ptr<TopElectronSelector>     const & looseElectronSel()   const { return looseElectronSel_;}
 
 protected:
-    std::string legend;
-    bool bFirstEntry;
-
-    // containers for config parameter values
-    std::map<std::string,bool>           mbPar;
-    std::map<std::string,int>            miPar;
-    std::map<std::string,double>         mdPar;
-    std::map<std::string,std::string>    msPar;
-    std::map<std::string, edm::InputTag> mtPar;
-    std::map<std::string,std::vector<std::string> > mvsPar;
-
-    boost::shared_ptr<PFJetIDSelectionFunctor> jetSel_;
-    boost::shared_ptr<PVSelector>              pvSel_;
+    virtual void Configure(std::map<std::string, edm::ParameterSet const > & par);
+
+    virtual bool isTightMuon(pat::Muon const & muon, edm::EventBase const & event);
+    virtual bool isLooseMuon(pat::Muon const & muon, edm::EventBase const & event);
+    virtual bool isTightElectron(pat::Electron const & electron, edm::EventBase const & event);
+    virtual bool isLooseElectron(pat::Electron const & electron, edm::EventBase const & event);
+    virtual bool isTau(pat::Tau const & tau);
+
     boost::shared_ptr<PFMuonSelector>          muonSel_;
     boost::shared_ptr<PFMuonSelector>          looseMuonSel_;
     boost::shared_ptr<TopElectronSelector>     electronSel_;
     boost::shared_ptr<TopElectronSelector>     looseElectronSel_;
 
-    edm::Handle<edm::TriggerResults >           mhEdmTriggerResults;
-    edm::Handle<std::vector<pat::Jet> >         mhJets;
-    edm::Handle<std::vector<pat::Muon> >        mhMuons;
-    edm::Handle<std::vector<pat::Electron> >    mhElectrons;
-    edm::Handle<std::vector<pat::Tau> >			mhTaus;
-    edm::Handle<std::vector<pat::MET> >         mhMet;
-    edm::Handle<std::vector<reco::PFMET> >      mhType1CorrMet;
-    edm::Handle<double>                         h_rho;
-    edm::Handle<std::vector<reco::Vertex> >     h_primVtx;
-
-    std::vector<edm::Ptr<reco::Vertex> >  good_pvs_;
-
-
-
-private:
-  
-    void initialize(std::map<std::string, edm::ParameterSet const> par);
-
+    pat::strbitset retMuon;
+    pat::strbitset retLooseMuon;
+    pat::strbitset retElectron;
+    pat::strbitset retLooseElectron;
 };
 
 
 
-static int reg = LjmetFactory::GetInstance()->Register(new singleLepEventSelector(), "singleLepSelector");
+static int reg = LjmetFactory::GetInstance()->Register(&LjmetFactory::MakeSelector<singleLepEventSelector>, "singleLepSelector");
 
 singleLepEventSelector::singleLepEventSelector()
 {
@@ -132,35 +70,10 @@ singleLepEventSelector::~singleLepEventSelector()
 {
 }
 
-void singleLepEventSelector::BeginJob( std::map<std::string, edm::ParameterSet const> par)
+void singleLepEventSelector::Configure( std::map<std::string, edm::ParameterSet const > & par)
 {
-    BaseEventSelector::BeginJob(par);
-
     std::string _key;
 
-        _key = "pfJetIDSelector";
-    if ( par.find(_key)!=par.end() ){
-        jetSel_ = boost::shared_ptr<PFJetIDSelectionFunctor>( new PFJetIDSelectionFunctor(par[_key]) );
-        std::cout << mLegend << "jet ID selector configured!"
-                  << std::endl;
-    }
-    else {
-        std::cout << mLegend << "jet ID selector not configured, exiting"
-                  << std::endl;
-        std::exit(-1);
-    }
-    
-    _key = "pvSelector";
-    if ( par.find(_key)!=par.end() ){
-        pvSel_ = boost::shared_ptr<PVSelector>( new PVSelector(par[_key]) );
-        std::cout << mLegend << "pv selector configured!"
-                  << std::endl;
-    }
-    else {
-        std::cout << mLegend << "PV selector not configured, exiting"
-                  << std::endl;
-        std::exit(-1);
-    }
     _key = "pfMuonSelector";
     if ( par.find(_key)!=par.end() ){
         muonSel_ = boost::shared_ptr<PFMuonSelector>( new PFMuonSelector(par[_key]) );
@@ -207,7 +120,12 @@ void singleLepEventSelector::BeginJob( std::map<std::string, edm::ParameterSet c
         std::exit(-1);
     }
 
-      _key = "event_selector";
+    retMuon          = muonSel_->getBitTemplate();
+    retLooseMuon     = looseMuonSel_->getBitTemplate();
+    retElectron      = electronSel_->getBitTemplate();
+    retLooseElectron = looseElectronSel_->getBitTemplate();
+
+    _key = "event_selector";
     if ( par.find(_key)!=par.end() ){
 
         mbPar["debug"]                    = par[_key].getParameter<bool>         ("debug");
@@ -291,34 +209,50 @@ void singleLepEventSelector::BeginJob( std::map<std::string, edm::ParameterSet c
         std::exit(-1);
     }
   
-    std::cout << mLegend << "initializing singleLep selection" << std::endl;
-
-    bFirstEntry = true;
-  
-    push_back("No selection");
-    set("No selection");
-  
-    push_back("Trigger");
-    push_back("Primary vertex");
-    push_back("HBHE noise and scraping filter");
-    push_back("One jet or more");
-    push_back("Two jets or more");
-    push_back("Three jets or more");
-    push_back("Min jet multiplicity");
-    push_back("Max jet multiplicity");
-    push_back("Leading jet pt");
-    push_back("Min MET");
-    push_back("Min muon");
-    push_back("Min electron");
-    push_back("Min lepton");
-    push_back("Max lepton");
-    //push_back("Trigger consistent");
-    push_back("Second lepton veto");
-    push_back("Tau veto");
-    push_back("1 btag or more");
-    push_back("2 btag or more");
-    push_back("3 btag or more");
-    push_back("All cuts");          // sanity check
+    mSelection = "singleLep";
+
+    // object pass
+    mSelectMuons      = mbPar["muon_cuts"];
+    mSelectElectrons  = mbPar["electron_cuts"];
+    mSelectTaus       = mbPar["tau_veto"];
+    mCleanJets        = mbPar["doLepJetCleaning"];
+    // the calculators take the loose leptons from their own selection
+    mKeepLooseLeptons = false;
+
+    // the lepton IDs below are evaluated over the whole collections by
+    // mLeptonId; the ID methods remain for the HEEP electron version
+    if (mbPar["muon_selector"]) mTightMuonId = mLeptonId.AddMuonWorkingPoint(*muonSel_, mdPar["muon_minpt"], mdPar["muon_maxeta"]);
+    else mTightMuonId = mLeptonId.AddMuonWorkingPoint(true, mdPar["muon_reliso"], mdPar["muon_minpt"], mdPar["muon_maxeta"]);
+    if (mbPar["loose_muon_selector"]) mLooseMuonId = mLeptonId.AddMuonWorkingPoint(*looseMuonSel_, mdPar["loose_muon_minpt"], mdPar["loose_muon_maxeta"]);
+    else mLooseMuonId = mLeptonId.AddMuonWorkingPoint(mbPar["loose_muon_selector_tight"], mdPar["loose_muon_reliso"],
+                                                      mdPar["loose_muon_minpt"], mdPar["loose_muon_maxeta"]);
+    mTightElectronId = mLeptonId.AddElectronWorkingPoint(*electronSel_, mdPar["electron_minpt"], mdPar["electron_maxeta"]);
+    mLooseElectronId = mLeptonId.AddElectronWorkingPoint(*looseElectronSel_, mdPar["loose_electron_minpt"], mdPar["loose_electron_maxeta"]);
+
+    bool const _jetCuts = mbPar["jet_cuts"];
+    bool const _btagCuts = mbPar["btag_cuts"];
+
+    AddCut("Trigger", [this](edm::EventBase const & event, CutIndex const &) { return passTrigger(event); }, cutIfConsidered);
+    AddCut("Primary vertex", [this](edm::EventBase const & event, CutIndex const &) { return passPv(event); }, cutIfConsidered | cutNoBreak);
+    AddCut("HBHE noise and scraping filter", [](edm::EventBase const &, CutIndex const &) { return true; }, cutIfConsidered);
+    AddCut("One jet or more", [this](edm::EventBase const &, CutIndex const &) { return mSummary.nJets >= 1; }, cutObjects, _jetCuts);
+    AddCut("Two jets or more", [this](edm::EventBase const &, CutIndex const &) { return mSummary.nJets >= 2; }, cutObjects, _jetCuts);
+    AddCut("Three jets or more", [this](edm::EventBase const &, CutIndex const &) { return mSummary.nJets >= 3; }, cutObjects, _jetCuts);
+    AddCut("Min jet multiplicity", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.nJets >= c.intCut; }, cutObjects, _jetCuts);
+    AddCut("Max jet multiplicity", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.nJets <= c.intCut; }, cutObjects, _jetCuts);
+    AddCut("Leading jet pt", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.leadingJetPt >= c.doubleCut; }, cutObjects, _jetCuts);
+    AddCut("Min MET", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.hasMet && mSummary.met > c.doubleCut; }, cutObjects | cutNoBreak, mbPar["met_cuts"]);
+    AddCut("Min muon", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.nTightMuons >= c.intCut; });
+    AddCut("Min electron", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.nTightElectrons >= c.intCut; });
+    AddCut("Min lepton", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.nTightMuons + mSummary.nTightElectrons >= c.intCut; });
+    AddCut("Max lepton", [this](edm::EventBase const &, CutIndex const & c) { return mSummary.nTightMuons + mSummary.nTightElectrons <= c.intCut; });
+    //AddCut("Trigger consistent", ...);
+    AddCut("Second lepton veto", [this](edm::EventBase const &, CutIndex const &) {
+        return !((mSummary.nTightMuons > 0 || mSummary.nTightElectrons > 0) && (mSummary.nLooseElectrons + mSummary.nLooseMuons) > 0); });
+    AddCut("Tau veto", [this](edm::EventBase const &, CutIndex const &) { return mSummary.nTaus == 0; });
+    AddCut("1 btag or more", [this](edm::EventBase const &, CutIndex const &) { return mSummary.nBtagJets >= 1; }, cutObjects, _btagCuts);
+    AddCut("2 btag or more", [this](edm::EventBase const &, CutIndex const &) { return mSummary.nBtagJets >= 2; }, cutObjects, _btagCuts);
+    AddCut("3 btag or more", [this](edm::EventBase const &, CutIndex const &) { return mSummary.nBtagJets >= 3; }, cutObjects, _btagCuts);
 
   
     // TOP PAG sync selection v3
@@ -364,607 +298,59 @@ void singleLepEventSelector::BeginJob( std::map<std::string, edm::ParameterSet c
         set("2 btag or more", false);
         set("3 btag or more", false);
     }
+} // end of Configure()
 
-    set("All cuts", true);
-    
-   
-} // end of BeginJob() 
-
-bool singleLepEventSelector::operator()( edm::EventBase const & event, pat::strbitset & ret)
+bool singleLepEventSelector::isTightMuon(pat::Muon const & muon, edm::EventBase const & event)
 {
-    pat::strbitset retJet            = jetSel_->getBitTemplate();
-    pat::strbitset retMuon           = muonSel_->getBitTemplate();
-    pat::strbitset retLooseMuon      = looseMuonSel_->getBitTemplate();
-    pat::strbitset retElectron       = electronSel_->getBitTemplate();
-    pat::strbitset retLooseElectron  = looseElectronSel_->getBitTemplate();
-    
-    while(1){ // standard infinite while loop trick to avoid nested ifs
-    
-        passCut(ret, "No selection");
-    
-        //
-        //_____ Trigger cuts __________________________________
-        //
-
-        bool passTrigElMC = false;
-        bool passTrigMuMC = false;
-        bool passTrigElData = false;
-        bool passTrigMuData = false;
-
-        if ( considerCut("Trigger") ) {
-
-            if (mbPar["debug"]) std::cout<<"trigger cuts..."<<std::endl;
-
-            event.getByLabel( mtPar["trigger_collection"], mhEdmTriggerResults );
-            //const edm::ParameterSetID ps = mhEdmTriggerResults->parameterSetID();
-            const edm::TriggerNames trigNames = event.triggerNames(*mhEdmTriggerResults);
-
-            bool passTrig = false;
-            unsigned int _tSize = mhEdmTriggerResults->size();
-
-
-            // dump trigger names
-            if (bFirstEntry && mbPar["dump_trigger"]){
-                for (unsigned int i=0; i<_tSize; i++){
-                    std::string trigName = trigNames.triggerName(i);
-                    std::cout << i << "   " << trigName;
-                    bool fired = mhEdmTriggerResults->accept(trigNames.triggerIndex(trigName));
-                    std::cout <<", FIRED = "<<fired<<std::endl;
-                } 
-            }
-
-            unsigned int _tElMCIndex = trigNames.triggerIndex(msPar["mctrigger_path_el"]);
-            if ( _tElMCIndex<_tSize){
-                passTrigElMC = mhEdmTriggerResults->accept(_tElMCIndex);
-            }
-
-            unsigned int _tMuMCIndex = trigNames.triggerIndex(msPar["mctrigger_path_mu"]);
-            if ( _tMuMCIndex<_tSize){
-                passTrigMuMC = mhEdmTriggerResults->accept(_tMuMCIndex);
-            }
-
-            //Loop over each data channel separately
-            int passTrigEl = 0;
-            for (unsigned int ipath = 0; ipath < mvsPar["trigger_path_el"].size(); ipath++){
-                unsigned int _tIndex = trigNames.triggerIndex(mvsPar["trigger_path_el"].at(ipath));
-                if ( _tIndex<_tSize){
-                    if (mhEdmTriggerResults->accept(_tIndex)){
-                        passTrigEl++;
-                        break;
-                    }
-                }
-            }
-            if (passTrigEl>0) passTrigElData = true;
-
-            int passTrigMu = 0;
-            for (unsigned int ipath = 0; ipath < mvsPar["trigger_path_mu"].size(); ipath++){
-                unsigned int _tIndex = trigNames.triggerIndex(mvsPar["trigger_path_mu"].at(ipath));
-                if ( _tIndex<_tSize){
-                    if (mhEdmTriggerResults->accept(_tIndex)){
-                        passTrigMu++;
-                        break;
-                    }
-                }
-            }
-            if (passTrigMu>0) passTrigMuData = true;
-
-            if (mbPar["isMc"] && (passTrigMuMC||passTrigElMC) ) passTrig = true;
-            if (!mbPar["isMc"] && (passTrigMuData||passTrigElData) ) passTrig = true;
-            mvSelTriggers.clear();
-            mvSelTriggers.push_back(passTrigEl);
-            mvSelTriggers.push_back(passTrigMu);
-
-
-            if ( ignoreCut("Trigger") || passTrig ) passCut(ret, "Trigger");
-            else break;
-
-        } // end of trigger cuts
-    
-    
-
-        //
-        //_____ Primary vertex cuts __________________________________
-        //
-        mvSelPVs.clear();
-        if ( considerCut("Primary vertex") ) {
-            if (mbPar["debug"]) std::cout<<"pv cuts..."<<std::endl;
-
-            if ( (*pvSel_)(event) ){
-                passCut(ret, "Primary vertex"); // PV cuts total
-            }
-
-            event.getByLabel( mtPar["pv_collection"], h_primVtx );
-            int _n_pvs = 0;
-            for (std::vector<reco::Vertex>::const_iterator _ipv = h_primVtx->begin();
-                 _ipv != h_primVtx->end(); ++_ipv){
-                mvSelPVs.push_back(edm::Ptr<reco::Vertex>(h_primVtx, _n_pvs));
-                ++_n_pvs;
-            }
-          
-        } // end of PV cuts
-
-
-   
-        //
-        //_____ HBHE noise and scraping filter________________________
-        //
-        if ( considerCut("HBHE noise and scraping filter") ) {
-            if (mbPar["debug"]) std::cout<<"HBHE cuts..."<<std::endl;
-
-            passCut(ret, "HBHE noise and scraping filter"); // PV cuts total
-
-        } // end of PV cuts
-
-
-        //======================================================
-        //
-        //_____ Muon cuts ________________________________
-        //      
-        // loop over muons
-
-        int _n_muons  = 0;
-        int nSelMuons = 0;
-        int nLooseMuons = 0;
-        if (mbPar["debug"]) std::cout<<"start muon cuts..."<<std::endl;
-
-        if ( mbPar["muon_cuts"] ) {
-
-            //get muons
-            event.getByLabel( mtPar["muon_collection"], mhMuons );      
-
-            mvSelMuons.clear();
-            for (std::vector<pat::Muon>::const_iterator _imu = mhMuons->begin(); _imu != mhMuons->end(); _imu++){
-                retMuon.set(false);	
-                bool pass = false;
-
-                //muon cuts
-                while(1){
-
-		    if (mbPar["muon_selector"]) {
-                        if ( (*muonSel_)( *_imu, retMuon ) ){ }
-                        else break; // fail
-		    }
-		    else {
-                        if ( (*_imu).isTightMuon(*mvSelPVs[0]) ){ }
-		        else break; // fail
-
-		        double chIso = (*_imu).userIsolation(pat::PfChargedHadronIso);
-		        double nhIso = (*_imu).userIsolation(pat::PfNeutralHadronIso);
-		        double gIso  = (*_imu).userIsolation(pat::PfGammaIso);
-		        double puIso = (*_imu).userIsolation(pat::PfPUChargedHadronIso);
-		        double pt    = (*_imu).pt() ;
-
-		        double pfIso = (chIso + std::max(0.,nhIso + gIso - 0.5*puIso))/pt;
-
-		        if ( pfIso<mdPar["muon_reliso"] ) {}
-		        else break;
-		    }
-                    
-                    if ( _imu->pt()>mdPar["muon_minpt"] ){ }
-                    else break;
-
-                    if ( fabs(_imu->eta())<mdPar["muon_maxeta"] ){ }
-                    else break;
-
-                    pass = true; // success
-                    break;
-                }
-
-                if ( pass ){
-                    ++nSelMuons; 
-
-                    // save every good muon
-                    mvSelMuons.push_back( edm::Ptr<pat::Muon>( mhMuons, _n_muons) );
-                }
-		else {
-                    retLooseMuon.set(false);	
-                    bool pass_loose = false;
-    
-                    //muon cuts
-                    while(1){
-    
-    		        if (mbPar["loose_muon_selector"]) {
-                            if ( (*looseMuonSel_)( *_imu, retLooseMuon ) ){ }
-                            else break; // fail
-    		        }
-    		        else {
-    		            if (mbPar["loose_muon_selector_tight"]) {
-                                if ( (*_imu).isTightMuon(*mvSelPVs[0]) ){ }
-    		                else break; // fail
-                            }
-    		            else {
-                                if ( (*_imu).isLooseMuon() ){ }
-    		                else break; // fail
-                            }
-    		            double chIso = (*_imu).userIsolation(pat::PfChargedHadronIso);
-    		            double nhIso = (*_imu).userIsolation(pat::PfNeutralHadronIso);
-    		            double gIso  = (*_imu).userIsolation(pat::PfGammaIso);
-    		            double puIso = (*_imu).userIsolation(pat::PfPUChargedHadronIso);
-    		            double pt    = (*_imu).pt() ;
-    
-    		            double pfIso = (chIso + std::max(0.,nhIso + gIso - 0.5*puIso))/pt;
-    
-    		            if ( pfIso<mdPar["loose_muon_reliso"] ) {}
-    		            else break;
-    		        }
-                        
-                        if ( _imu->pt()>mdPar["loose_muon_minpt"] ){ }
-                        else break;
-    
-                        if ( fabs(_imu->eta())<mdPar["loose_muon_maxeta"] ){ }
-                        else break;
-    
-                        pass_loose = true; // success
-                        break;
-                    }
-    
-                    if ( pass_loose ) ++nLooseMuons; 
-		}
-                	
-                _n_muons++;
-            } // end of the muon loop
-
-        } // end of muon cuts
-        if (mbPar["debug"]) std::cout<<"finish muon cuts..."<<std::endl;
-
-        //
-        //_____ Electron cuts __________________________________
-        //      
-        // loop over electrons
-
-        int _n_electrons  = 0;
-        int nSelElectrons = 0;
-        int nLooseElectrons = 0;
-        if (mbPar["debug"]) std::cout<<"start electron cuts..."<<std::endl;
-
-        if ( mbPar["electron_cuts"] ) {
-            //get electrons
-            event.getByLabel( mtPar["electron_collection"], mhElectrons );      
-
-            mvSelElectrons.clear();
-	
-            for (std::vector<pat::Electron>::const_iterator _iel = mhElectrons->begin(); _iel != mhElectrons->end(); _iel++){
-	        retElectron.set(false);
-                bool pass = false;
-
-                //electron cuts
-                while(1){
-
-                    if ( (*electronSel_)( *_iel, event, retElectron ) ){ }
-                    else break; // fail
-                    if (_iel->pt()>mdPar["electron_minpt"]){ }
-                    else break;
-	  
-                    if ( fabs(_iel->eta())<mdPar["electron_maxeta"] ){ }
-                    else break;
-
-                    pass = true; // success
-                    break;
-                }
-
-                if ( pass ){
-                     ++nSelElectrons;
-
-                   
-                    // save every good electron
-                    mvSelElectrons.push_back( edm::Ptr<pat::Electron>( mhElectrons, _n_electrons) );
-                }	
-		else {
-    	            retLooseElectron.set(false);
-                    bool pass_loose = false;
-    
-                    //electron cuts
-                    while(1){
-    
-                        if ( (*looseElectronSel_)( *_iel, event, retLooseElectron ) ){ }
-                        else break; // fail
-
-                        if (_iel->pt()>mdPar["loose_electron_minpt"]){ }
-                        else break;
-    	  
-                        if ( fabs(_iel->eta())<mdPar["loose_electron_maxeta"] ){ }
-                        else break;
-    
-                        pass_loose = true; // success
-                        break;
-                    }
-    
-                    if ( pass_loose ) ++nLooseElectrons;
-		}
-                 	
-                _n_electrons++;
-            } // end of the electron loop
-
-        } // end of electron cuts
-        if (mbPar["debug"]) std::cout<<"finish electron cuts..."<<std::endl;
-
-        //
-        //_____ Tau cuts __________________________________
-        //      
-        // loop over taus
-
-        int _n_taus  = 0;
-        if (mbPar["debug"]) std::cout<<"start tau cuts..."<<std::endl;
-
-        if ( mbPar["tau_veto"] ) {
-            //get electrons
-            event.getByLabel( mtPar["tau_collection"], mhTaus );      
-
-            for (std::vector<pat::Tau>::const_iterator _itau = mhTaus->begin(); _itau != mhTaus->end(); _itau++){
-
-                while(1){
-
-					//Tau cuts hardcoded here	
-					if(_itau->tauID("byMediumCombinedIsolationDeltaBetaCorr3Hits")){}
-					else break;
-					
-					if(_itau->tauID("againstElectronTight")){}
-					else break;
-					
-					if(_itau->tauID("againstMuonTight2")){}
-					else break;
-					
-					if(_itau->pt() > 20 && fabs(_itau->eta()) < 2.4 ){}
-					else break;
-					
-					++_n_taus;
-					break;
- 
-				}
-			}
-
-		}
-        if (mbPar["debug"]) std::cout<<"finish tau cuts..."<<std::endl;
-        
-	//
-        // jet loop
-        //
-        //
-        if (mbPar["debug"]) std::cout<<"start jet cuts..."<<std::endl;
-
-        event.getByLabel( mtPar["jet_collection"], mhJets );
-
-        int _n_good_jets = 0;
-        int _n_jets = 0;
-        int nBtagJets = 0;
-        double _leading_jet_pt = 0.0;
-
-        mvSelJets.clear();
-        mvAllJets.clear();
-        mvCorrJetsWithBTags.clear();
-        mvSelBtagJets.clear();
-
-        // try to get earlier produced data (in a calc)
-        //std::cout << "Must be 2.34: " << GetTestValue() << std::endl;
-
-        for (std::vector<pat::Jet>::const_iterator _ijet = mhJets->begin();
-             _ijet != mhJets->end(); ++_ijet){
-      
-            retJet.set(false);
-
-            bool _pass = false;
-            bool _passpf = false;
-            bool _isTagged = false;
-	    bool _cleaned = false;
-
-	    TLorentzVector jetP4;
-
-	    if ( mbPar["doLepJetCleaning"] ){
-	        pat::Jet tmpJet = *_ijet;
-		if (mbPar["debug"]) std::cout << "Checking Overlap" << std::endl;
-                if (mvSelMuons.size()>0){
-	            if ( deltaR(mvSelMuons[0]->p4(),_ijet->p4()) < 0.4 ){
-            	        if (mbPar["debug"]) {
-			    std::cout << "Jet Overlaps with the Muon... Cleaning jet..." << std::endl;
-            	            std::cout << "Lepton : pT = " << mvSelMuons[0]->pt() << " eta = " << mvSelMuons[0]->eta() << " phi = " << mvSelMuons[0]->phi() << std::endl;
-            	            std::cout << "      Raw Jet : pT = " << _ijet->pt() << " eta = " << _ijet->eta() << " phi = " << _ijet->phi() << std::endl;
-			}
-			const std::vector<edm::Ptr<reco::Candidate> > _ijet_consts = _ijet->daughterPtrVector();
-        		for ( std::vector<edm::Ptr<reco::Candidate> >::const_iterator _i_const = _ijet_consts.begin(); _i_const != _ijet_consts.end(); ++_i_const){
-			    if ( (*_i_const).key() == mvSelMuons[0]->originalObjectRef().key() ) {
-				tmpJet.setP4( _ijet->p4() - mvSelMuons[0]->p4() );
-				jetP4 = correctJet(tmpJet, event);
-				if (mbPar["debug"]) std::cout << "Corrected Jet : pT = " << jetP4.Pt() << " eta = " << jetP4.Eta() << " phi = " << jetP4.Phi() << std::endl;
-			        _cleaned = true;
-			    }
-			}
-			// zprime method (gives same results as far as i can tell)
-			/*double muEchk = _ijet->energy()*_ijet->muonEnergyFraction()/mvSelMuons[0]->energy();
-			if ( !(muEchk < 0.9 || (muEchk > 1.1 && _ijet->muonMultiplicity()==1)) ) {
- 			    tmpJet.setP4( _ijet->p4()-mvSelMuons[0]->p4() );
-			    if (tmpJet.pt() > 5 && deltaR(_ijet->p4(),tmpJet.p4()) > 1.57) std::cout << "Lepton-Jet cleaning flipped direction, not cleaning!" << std::endl;
-			    else {
- 			        jetP4 = correctJet(tmpJet, event);
-			        if (mbPar["debug"]) std::cout << "Corrected Jet : pT = " << jetP4.Pt() << " eta = " << jetP4.Eta() << " phi = " << jetP4.Phi() << std::endl;
-			        _cleaned = true;
-			    }
-                        }*/
-			//old deltaR matching method
-			/*for (unsigned int id = 0, nd = (*_ijet).numberOfDaughters(); id < nd; ++id) {
-            		    const pat::PackedCandidate &_ijet_const = dynamic_cast<const pat::PackedCandidate &>(*(*_ijet).daughter(id));
-			    if ( deltaR(mvSelMuons[0]->p4(),_ijet_const.p4()) < 0.001 ) {
- 				tmpJet.setP4( _ijet->p4()-mvSelMuons[0]->p4() );
- 				jetP4 = correctJet(tmpJet, event);
-				if (mbPar["debug"]) std::cout << "Corrected Jet : pT = " << jetP4.Pt() << " eta = " << jetP4.Eta() << " phi = " << jetP4.Phi() << std::endl;
-			        _cleaned = true;
- 			    }
-                        }*/
-		    }
-            	}
-            
-                if (mvSelElectrons.size()>0){
-	            if ( deltaR(mvSelElectrons[0]->p4(),_ijet->p4()) < 0.4 ){
-            	        if (mbPar["debug"]) {
-			    std::cout << "Jet Overlaps with the Electron... Cleaning jet..." << std::endl;
-            	            std::cout << "Lepton : pT = " << mvSelElectrons[0]->pt() << " eta = " << mvSelElectrons[0]->eta() << " phi = " << mvSelElectrons[0]->phi() << std::endl;
-            	            std::cout << "      Raw Jet : pT = " << _ijet->pt() << " eta = " << _ijet->eta() << " phi = " << _ijet->phi() << std::endl;
-			}
-			const std::vector<edm::Ptr<reco::Candidate> > _ijet_consts = _ijet->daughterPtrVector();
-        		for ( std::vector<edm::Ptr<reco::Candidate> >::const_iterator _i_const = _ijet_consts.begin(); _i_const != _ijet_consts.end(); ++_i_const){
-			    if ( (*_i_const).key() == mvSelElectrons[0]->originalObjectRef().key() ) {
-				tmpJet.setP4( _ijet->p4() - mvSelElectrons[0]->p4() );
-				jetP4 = correctJet(tmpJet, event);
-				if (mbPar["debug"]) std::cout << "Corrected Jet : pT = " << jetP4.Pt() << " eta = " << jetP4.Eta() << " phi = " << jetP4.Phi() << std::endl;
-			        _cleaned = true;
-			    }
-			}
-		    }
-            	}
-	    }
-	    if (!_cleaned) jetP4 = correctJet(*_ijet, event);
-
-            _isTagged = isJetTagged(*_ijet, event);
-
-            // jet cuts
-            while(1){ 
-
-                // quality cuts
-                if ( (*jetSel_)( *_ijet, retJet ) ){ } 
-                else break; // fail 
-	
-                _passpf = true;
-
-                if ( jetP4.Pt() > mdPar["jet_minpt"] ){ }
-                else break; // fail 
-	
-                if ( fabs(jetP4.Eta()) < mdPar["jet_maxeta"] ){ }
-                else break; // fail
-	
-                _pass = true;
-                break;
-            }
-
-            pair<TLorentzVector,bool> jetwithtag;
-            jetwithtag.first = jetP4;
-            jetwithtag.second = _isTagged;
-
-            if ( _pass ){
-
-
-                // save all the good jets
-                ++_n_good_jets;
-                mvSelJets.push_back(edm::Ptr<pat::Jet>( mhJets, _n_jets)); 
-                mvCorrJetsWithBTags.push_back(jetwithtag);
-
-                if (jetP4.Pt() > _leading_jet_pt) _leading_jet_pt = jetP4.Pt();                         
-            
-                if (_isTagged) {
-                    ++nBtagJets;
-                    // save all the good b-tagged jets
-                    mvSelBtagJets.push_back(edm::Ptr<pat::Jet>( mhJets, _n_jets)); 
-                }
-            }
-      
-            // save all the pf jets regardless of pt or eta
-            // needed for MET corrections with JER/JES uncertainty
-            if (_passpf) mvAllJets.push_back(edm::Ptr<pat::Jet>( mhJets, _n_jets)); 
-
-            ++_n_jets; 
-      
-        } // end of loop over jets
-
-		
-        //
-        if ( mbPar["jet_cuts"] ) {
-
-            if ( ignoreCut("One jet or more") || _n_good_jets >= 1 ) passCut(ret, "One jet or more");
-            else break; 
-	
-            if ( ignoreCut("Two jets or more") || _n_good_jets >= 2 ) passCut(ret, "Two jets or more");
-            else break; 
-	
-            if ( ignoreCut("Three jets or more") || _n_good_jets >= 3 ) passCut(ret, "Three jets or more");
-            else break; 
-	
-            if ( ignoreCut("Min jet multiplicity") || _n_good_jets >= cut("Min jet multiplicity",int()) ) passCut(ret, "Min jet multiplicity");
-            else break; 
-	
-            if ( ignoreCut("Max jet multiplicity") || _n_good_jets <= cut("Max jet multiplicity",int()) ) passCut(ret, "Max jet multiplicity");
-            else break; 
-            if ( ignoreCut("Leading jet pt") ||  _leading_jet_pt >= cut("Leading jet pt",double()) ) passCut(ret, "Leading jet pt");
-            else break;
-
-        } // end of jet cuts
-        if (mbPar["debug"]) std::cout<<"finish jet cuts..."<<std::endl;
-
-        //
-        //_____ MET cuts __________________________________
-        //   
-        if (mbPar["debug"]) std::cout<<"start met cuts..."<<std::endl;
-
-        event.getByLabel( mtPar["met_collection"], mhMet );
-        mpMet = edm::Ptr<pat::MET>( mhMet, 0);
-
-        if ( mbPar["met_cuts"] ) {
-
-            // pfMet
-            //if ( mpType1CorrMet.isNonnull() && mpType1CorrMet.isAvailable() ) {
-            if ( mpMet.isNonnull() && mpMet.isAvailable() ) {
-                pat::MET const & met = mhMet->at(0);
-                if ( ignoreCut("Min MET") ||met.et()>cut("Min MET", double()) ) passCut(ret, "Min MET");
-            }
-        } // end of MET cuts
-        if (mbPar["debug"]) std::cout<<"finish met cuts..."<<std::endl;
-
-	//
-	//_____ Lepton cuts ________________________________
-
-        if (mbPar["debug"]) std::cout<<"start lepton cuts..."<<std::endl;
-
-        int nLeptons = nSelElectrons + nSelMuons;
-
-        if( nSelMuons >= cut("Min muon", int()) || ignoreCut("Min muon") ) passCut(ret, "Min muon");
-        else break;
-        if( nSelElectrons >= cut("Min electron", int()) || ignoreCut("Min electron") ) passCut(ret, "Min electron");
-        else break;
-        if( nLeptons >= cut("Min lepton", int()) || ignoreCut("Min lepton") ) passCut(ret, "Min lepton");
-        else break;
-        if( nLeptons <= cut("Max lepton", int()) || ignoreCut("Max lepton") ) passCut(ret, "Max lepton");
-        else break;
-
-        
-        bool NoSecondLepton = true;
-        if ( (nSelMuons > 0 || nSelElectrons > 0) && ((nLooseElectrons + nLooseMuons) > 0) ) NoSecondLepton = false;
-       
-        if( NoSecondLepton || ignoreCut("Second lepton veto") ) passCut(ret, "Second lepton veto");
-        else break;
-        
-        if( _n_taus == 0 ) passCut(ret, "Tau veto");
-        else break;
-        
-        if (mbPar["debug"]) std::cout<<"finish lepton cuts..."<<std::endl;
-    
-        //
-        //_____ Btagging cuts _____________________
-        //
-        if (mbPar["debug"]) std::cout<<"start btag cuts..."<<std::endl;
-
-        if ( mbPar["btag_cuts"] ) {
-              
-            if ( nBtagJets >= 1 || ignoreCut("1 btag or more") )  passCut(ret, "1 btag or more");
-            else break;
-            if ( nBtagJets >= 2 || ignoreCut("2 btag or more") )  passCut(ret, "2 btag or more");
-            else break;
-            if ( nBtagJets >= 3 || ignoreCut("3 btag or more") )  passCut(ret, "3 btag or more");
-            else break;
+    retMuon.set(false);
+    if (mbPar["muon_selector"]) {
+        if ( !(*muonSel_)( muon, retMuon ) ) return false;
+    }
+    else {
+        if ( !muon.isTightMuon(*mvSelPVs[0]) ) return false;
+        if ( pfRelIso(muon) >= mdPar["muon_reliso"] ) return false;
+    }
+    return muon.pt() > mdPar["muon_minpt"] && fabs(muon.eta()) < mdPar["muon_maxeta"];
+}
 
+bool singleLepEventSelector::isLooseMuon(pat::Muon const & muon, edm::EventBase const & event)
+{
+    retLooseMuon.set(false);
+    if (mbPar["loose_muon_selector"]) {
+        if ( !(*looseMuonSel_)( muon, retLooseMuon ) ) return false;
+    }
+    else {
+        if (mbPar["loose_muon_selector_tight"]) {
+            if ( !muon.isTightMuon(*mvSelPVs[0]) ) return false;
         }
-        if (mbPar["debug"]) std::cout<<"finish btag cuts..."<<std::endl;
-    
-        passCut(ret, "All cuts");
-        break;
-
-    } // end of while loop
+        else if ( !muon.isLooseMuon() ) return false;
+        if ( pfRelIso(muon) >= mdPar["loose_muon_reliso"] ) return false;
+    }
+    return muon.pt() > mdPar["loose_muon_minpt"] && fabs(muon.eta()) < mdPar["loose_muon_maxeta"];
+}
 
+bool singleLepEventSelector::isTightElectron(pat::Electron const & electron, edm::EventBase const & event)
+{
+    retElectron.set(false);
+    if ( !(*electronSel_)( electron, event, retElectron ) ) return false;
+    return electron.pt() > mdPar["electron_minpt"] && fabs(electron.eta()) < mdPar["electron_maxeta"];
+}
 
-    bFirstEntry = false;
-    
-    return (bool)ret;
-  
-    setIgnored(ret);
+bool singleLepEventSelector::isLooseElectron(pat::Electron const & electron, edm::EventBase const & event)
+{
+    retLooseElectron.set(false);
+    if ( !(*looseElectronSel_)( electron, event, retLooseElectron ) ) return false;
+    return electron.pt() > mdPar["loose_electron_minpt"] && fabs(electron.eta()) < mdPar["loose_electron_maxeta"];
+}
 
-    return false;
-}// end of operator()
+bool singleLepEventSelector::isTau(pat::Tau const & tau)
+{
+    //Tau cuts hardcoded here
+    return tau.tauID("byMediumCombinedIsolationDeltaBetaCorr3Hits")
+        && tau.tauID("againstElectronTight")
+        && tau.tauID("againstMuonTight2")
+        && tau.pt() > 20 && fabs(tau.eta()) < 2.4;
+}
 
 
 void singleLepEventSelector::AnalyzeEvent( edm::EventBase const & event, LjmetEventContent & ec )